@@ -0,0 +1,550 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+// Benchmark of the detail string dispatch of the GtkStyle draw functions.
+//
+// A trace of draw calls is replayed through the detail string comparisons
+// the draw functions used to do and through classifyDetail(). Each call is
+// reduced to the detail tests of the function it was made to, the results of
+// the two are compared and the time per call is reported.
+//
+// A trace is recorded by running an application with `QTCURVE_DEBUG=2`, every
+// draw call prints its name and detail on stdout,
+//     QTCURVE_DEBUG=2 gtk-demo > trace.txt
+// Without a trace file the calls painting a dialog (buttons, check and radio
+// buttons, an entry, a scrolled list, a scale, a menu bar and a toolbar) are
+// replayed. The check and option calls do not print their detail and only
+// come from this list.
+//
+// Usage: qtcurve-gtk2-detail-bench [-n iterations] [trace]
+
+#include "detail.h"
+
+#include <qtcurve-utils/number.h>
+#include <qtcurve-utils/strs.h>
+#include <qtcurve-utils/timer.h>
+
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace QtCurve;
+
+enum class Func {
+    FlatBox,
+    Handle,
+    Arrow,
+    Box,
+    Shadow,
+    Layout,
+    Extension,
+    BoxGap,
+    Slider,
+    HLine,
+    VLine,
+    Check,
+    Option,
+};
+
+struct Call {
+    Func func;
+    const char *detail;
+};
+
+static const struct {
+    const char *name;
+    Func func;
+} funcNames[] = {
+    {"gtkDrawFlatBox", Func::FlatBox},
+    {"gtkDrawHandle", Func::Handle},
+    {"gtkDrawArrow", Func::Arrow},
+    {"drawBox", Func::Box},
+    {"gtkDrawShadow", Func::Shadow},
+    {"gtkDrawLayout", Func::Layout},
+    {"gtkDrawExtension", Func::Extension},
+    {"gtkDrawBoxGap", Func::BoxGap},
+    {"gtkDrawSlider", Func::Slider},
+    {"gtkDrawHLine", Func::HLine},
+    {"gtkDrawVLine", Func::VLine},
+};
+
+static const Call dialogTrace[] = {
+    {Func::FlatBox, "base"},
+    {Func::Box, "menubar"},
+    {Func::Box, "menuitem"},
+    {Func::Layout, "label"},
+    {Func::Check, "check"},
+    {Func::Layout, "label"},
+    {Func::Option, "option"},
+    {Func::Layout, "label"},
+    {Func::Box, "toolbar"},
+    {Func::Handle, "handlebox"},
+    {Func::Box, "handlebox_bin"},
+    {Func::Box, "button"},
+    {Func::Layout, "label"},
+    {Func::Box, "button"},
+    {Func::Layout, "label"},
+    {Func::VLine, "toolbar"},
+    {Func::Box, "togglebutton"},
+    {Func::Arrow, "arrow"},
+    {Func::Shadow, "entry"},
+    {Func::FlatBox, "entry_bg"},
+    {Func::Layout, nullptr},
+    {Func::Shadow, "scrolled_window"},
+    {Func::Box, "button"},
+    {Func::Layout, "label"},
+    {Func::Box, "button"},
+    {Func::Layout, "label"},
+    {Func::FlatBox, "cell_even_ruled"},
+    {Func::Layout, "cellrenderertext"},
+    {Func::FlatBox, "cell_odd_ruled"},
+    {Func::Layout, "cellrenderertext"},
+    {Func::FlatBox, "cell_even_ruled"},
+    {Func::Layout, "cellrenderertext"},
+    {Func::FlatBox, "cell_odd_ruled"},
+    {Func::Layout, "cellrenderertext"},
+    {Func::Box, "trough"},
+    {Func::Box, "vscrollbar"},
+    {Func::Arrow, "vscrollbar"},
+    {Func::Box, "vscrollbar"},
+    {Func::Arrow, "vscrollbar"},
+    {Func::Slider, "slider"},
+    {Func::BoxGap, "notebook"},
+    {Func::Extension, "tab"},
+    {Func::Layout, "label"},
+    {Func::Extension, "tab"},
+    {Func::Layout, "label"},
+    {Func::FlatBox, "checkbutton"},
+    {Func::Check, "checkbutton"},
+    {Func::Layout, "label"},
+    {Func::Option, "radiobutton"},
+    {Func::Layout, "label"},
+    {Func::Box, "trough"},
+    {Func::Box, "trough-lower"},
+    {Func::Box, "trough-upper"},
+    {Func::Slider, "hscale"},
+    {Func::Shadow, "frame"},
+    {Func::HLine, "hseparator"},
+    {Func::Box, "spinbutton"},
+    {Func::Box, "spinbutton_up"},
+    {Func::Arrow, "spinbutton"},
+    {Func::Box, "spinbutton_down"},
+    {Func::Arrow, "spinbutton"},
+    {Func::Box, "bar"},
+    {Func::Layout, "progressbar"},
+    {Func::Box, "buttondefault"},
+    {Func::Box, "button"},
+    {Func::Layout, "label"},
+    {Func::Box, "button"},
+    {Func::Layout, "label"},
+};
+
+// The detail tests the draw functions made on the string.
+static uint64_t
+stringTests(Func func, const char *_detail)
+{
+    const char *detail = _detail ? _detail : "";
+    uint64_t res = 0;
+    int bit = 0;
+    auto add = [&] (bool val) {
+        res |= uint64_t(val) << bit++;
+    };
+    switch (func) {
+    case Func::FlatBox:
+        add(oneOf(detail, "base"));
+        add(oneOf(detail, "base", "eventbox", "viewportbin"));
+        add(oneOf(detail, "base", "eventbox"));
+        add(oneOf(detail, "viewportbin"));
+        add(oneOf(detail, "checkbutton"));
+        add(oneOf(detail, "expander"));
+        add(oneOf(detail, "tooltip"));
+        add(oneOf(detail, "icon_view_item"));
+        add(oneOf(detail, "eventbox"));
+        add(noneOf(detail, "checkbutton"));
+        break;
+    case Func::Handle:
+        add(oneOf(detail, "paned") || oneOf(detail + 1, "paned"));
+        add(oneOf(detail, "handlebox"));
+        add(oneOf(detail, "dockitem"));
+        break;
+    case Func::Arrow:
+        add(oneOf(detail, "arrow"));
+        add(oneOf(detail, "spinbutton"));
+        add(oneOf(detail, "menuitem"));
+        add(detail[0] && (oneOf(detail, "stepper") ||
+                          Str::startsWith(detail + 1, "scrollbar")));
+        break;
+    case Func::Box: {
+        bool sbar = detail[0] && (oneOf(detail, "stepper") ||
+                                  Str::startsWith(detail + 1, "scrollbar"));
+        bool pbar = oneOf(detail, "bar");
+        bool qtcSlider = !pbar && oneOf(detail, "qtc-slider");
+        bool slider = qtcSlider || (!pbar && oneOf(detail, "slider"));
+        bool hscale = !slider && oneOf(detail, "hscale");
+        bool vscale = !hscale && oneOf(detail, "vscale");
+        bool menubar = !vscale && oneOf(detail, "menubar");
+        bool button = !menubar && oneOf(detail, "button");
+        bool togglebutton = !button && oneOf(detail, "togglebutton");
+        bool optionmenu = !togglebutton && oneOf(detail, "optionmenu");
+        bool stepper = !optionmenu && oneOf(detail, "stepper");
+        bool vscrollbar = (!optionmenu &&
+                           Str::startsWith(detail, "vscrollbar"));
+        bool hscrollbar = (!vscrollbar &&
+                           Str::startsWith(detail, "hscrollbar"));
+        bool spinUp = !hscrollbar && oneOf(detail, "spinbutton_up");
+        bool spinDown = !spinUp && oneOf(detail, "spinbutton_down");
+        bool menuScroll = strstr(detail, "menu_scroll_arrow_");
+        add(sbar);
+        add(pbar);
+        add(qtcSlider);
+        add(slider);
+        add(hscale);
+        add(vscale);
+        add(menubar);
+        add(button);
+        add(togglebutton);
+        add(optionmenu);
+        add(stepper);
+        add(vscrollbar);
+        add(spinUp);
+        add(spinDown);
+        add(menuScroll);
+        // useButtonColor()
+        add(oneOf(detail, "optionmenu", "button", "buttondefault",
+                  "togglebuttondefault", "togglebutton", "hscale", "vscale",
+                  "spinbutton", "spinbutton_up", "spinbutton_down", "slider",
+                  "qtc-slider", "stepper") ||
+            (detail[0] && Str::startsWith(detail + 1, "scrollbar")));
+        // getRound()
+        add(oneOf(detail, "splitter", "optionmenu", "togglebutton",
+                  "hscale", "vscale"));
+        add(sbar && Str::endsWith(detail, "_start"));
+        add(sbar && Str::endsWith(detail, "_end"));
+        add(oneOf(detail, "spinbutton"));
+        add(oneOf(detail, "buttondefault", "togglebuttondefault"));
+        add(oneOf(detail, "trough") || Str::startsWith(detail, "trough-"));
+        add(oneOf(detail, "entry-progress"));
+        add(oneOf(detail, "dockitem", "dockitem_bin"));
+        add(oneOf(detail, "toolbar", "handlebox", "handlebox_bin"));
+        add(oneOf(detail, "handlebox"));
+        add(oneOf(detail, "menuitem"));
+        add(oneOf(detail, "menu"));
+        add(detail[0] && (!strcmp(detail, "paned") ||
+                          !strcmp(detail + 1, "paned")));
+        add(detail[0] && !strcmp(detail + 1, "paned") && *detail == 'h');
+        add(detail[0] && strcmp(detail + 1, "ruler") == 0);
+        add(oneOf(detail, "hseparator"));
+        add(oneOf(detail, "vseparator"));
+        // drawSliderGroove()
+        add(oneOf(detail, "trough-lower"));
+        add(oneOf(detail, "trough"));
+        // drawToolbarBorders()
+        add(oneOf(detail, "menubar"));
+        add(oneOf(detail, "toolbar"));
+        add(oneOf(detail, "dockitem_bin", "handlebox_bin"));
+        break;
+    }
+    case Func::Shadow:
+        add(noneOf(detail, "viewport"));
+        add(oneOf(detail, "entry", "text"));
+        add(!_detail || strcmp(detail, "frame") == 0);
+        add(oneOf(detail, "scrolled_window"));
+        add(!oneOf(detail, "scrolled_window") && strstr(detail, "viewport"));
+        break;
+    case Func::Layout:
+        add(oneOf(detail, "progressbar"));
+        add(oneOf(detail, "cellrenderertext"));
+        break;
+    case Func::Extension:
+        add(oneOf(detail, "tab"));
+        break;
+    case Func::BoxGap:
+        add(oneOf(detail, "notebook"));
+        break;
+    case Func::Slider:
+        add(oneOf(detail, "slider"));
+        add(oneOf(detail, "hscale", "vscale"));
+        add(oneOf(detail, "hscale"));
+        break;
+    case Func::HLine:
+        add(strcmp(detail, "toolbar"));
+        add(oneOf(detail, "label"));
+        add(oneOf(detail, "menuitem"));
+        add(oneOf(detail, "hseparator"));
+        break;
+    case Func::VLine:
+        add(oneOf(detail, "vseparator"));
+        add(oneOf(detail, "toolbar"));
+        break;
+    case Func::Check:
+        add(oneOf(detail, "check"));
+        break;
+    case Func::Option:
+        add(oneOf(detail, "option"));
+        break;
+    }
+    return res;
+}
+
+// The same tests on the classified detail.
+static uint64_t
+detailTests(Func func, const char *_detail)
+{
+    Detail d = classifyDetail(_detail);
+    uint64_t res = 0;
+    int bit = 0;
+    auto add = [&] (bool val) {
+        res |= uint64_t(val) << bit++;
+    };
+    bool sbar = oneOf(d, Detail::Stepper, Detail::HScrollbar,
+                      Detail::VScrollbar);
+    switch (func) {
+    case Func::FlatBox:
+        add(d == Detail::Base);
+        add(oneOf(d, Detail::Base, Detail::EventBox, Detail::ViewportBin));
+        add(oneOf(d, Detail::Base, Detail::EventBox));
+        add(d == Detail::ViewportBin);
+        add(d == Detail::CheckButton);
+        add(d == Detail::Expander);
+        add(d == Detail::Tooltip);
+        add(d == Detail::IconViewItem);
+        add(d == Detail::EventBox);
+        add(d != Detail::CheckButton);
+        break;
+    case Func::Handle:
+        add(oneOf(d, Detail::Paned, Detail::HPaned, Detail::VPaned));
+        add(d == Detail::HandleBox);
+        add(d == Detail::DockItem);
+        break;
+    case Func::Arrow:
+        add(d == Detail::Arrow);
+        add(d == Detail::SpinButton);
+        add(d == Detail::MenuItem);
+        add(sbar);
+        break;
+    case Func::Box:
+        add(sbar);
+        add(d == Detail::Bar);
+        add(d == Detail::QtcSlider);
+        add(oneOf(d, Detail::QtcSlider, Detail::Slider));
+        add(d == Detail::HScale);
+        add(d == Detail::VScale);
+        add(d == Detail::MenuBar);
+        add(d == Detail::Button);
+        add(d == Detail::ToggleButton);
+        add(d == Detail::OptionMenu);
+        add(d == Detail::Stepper);
+        add(d == Detail::VScrollbar);
+        add(d == Detail::SpinButtonUp);
+        add(d == Detail::SpinButtonDown);
+        add(d == Detail::MenuScrollArrow);
+        switch (d) {
+        case Detail::OptionMenu:
+        case Detail::Button:
+        case Detail::ButtonDefault:
+        case Detail::ToggleButtonDefault:
+        case Detail::ToggleButton:
+        case Detail::HScale:
+        case Detail::VScale:
+        case Detail::SpinButton:
+        case Detail::SpinButtonUp:
+        case Detail::SpinButtonDown:
+        case Detail::Slider:
+        case Detail::QtcSlider:
+        case Detail::Stepper:
+        case Detail::HScrollbar:
+        case Detail::VScrollbar:
+            add(true);
+            break;
+        default:
+            add(false);
+        }
+        add(oneOf(d, Detail::Splitter, Detail::OptionMenu,
+                  Detail::ToggleButton, Detail::HScale, Detail::VScale));
+        add(oneOf(d, Detail::HScrollbar, Detail::VScrollbar) &&
+            Str::endsWith(_detail, "_start"));
+        add(oneOf(d, Detail::HScrollbar, Detail::VScrollbar) &&
+            Str::endsWith(_detail, "_end"));
+        add(d == Detail::SpinButton);
+        add(oneOf(d, Detail::ButtonDefault, Detail::ToggleButtonDefault));
+        add(oneOf(d, Detail::Trough, Detail::TroughPart));
+        add(d == Detail::EntryProgress);
+        add(oneOf(d, Detail::DockItem, Detail::DockItemBin));
+        add(oneOf(d, Detail::Toolbar, Detail::HandleBox,
+                  Detail::HandleBoxBin));
+        add(d == Detail::HandleBox);
+        add(d == Detail::MenuItem);
+        add(d == Detail::Menu);
+        add(oneOf(d, Detail::Paned, Detail::HPaned, Detail::VPaned));
+        add(d == Detail::HPaned);
+        add(oneOf(d, Detail::HRuler, Detail::VRuler));
+        add(d == Detail::HSeparator);
+        add(d == Detail::VSeparator);
+        add(d == Detail::TroughPart && Str::endsWith(_detail, "-lower"));
+        add(d == Detail::Trough);
+        add(d == Detail::MenuBar);
+        add(d == Detail::Toolbar);
+        add(oneOf(d, Detail::DockItemBin, Detail::HandleBoxBin));
+        break;
+    case Func::Shadow:
+        add(d != Detail::Viewport);
+        add(oneOf(d, Detail::Entry, Detail::Text));
+        add(!_detail || d == Detail::Frame);
+        add(d == Detail::ScrolledWindow);
+        add(oneOf(d, Detail::Viewport, Detail::ViewportBin));
+        break;
+    case Func::Layout:
+        add(d == Detail::ProgressBar);
+        add(d == Detail::CellRendererText);
+        break;
+    case Func::Extension:
+        add(d == Detail::Tab);
+        break;
+    case Func::BoxGap:
+        add(d == Detail::Notebook);
+        break;
+    case Func::Slider:
+        add(d == Detail::Slider);
+        add(oneOf(d, Detail::HScale, Detail::VScale));
+        add(d == Detail::HScale);
+        break;
+    case Func::HLine:
+        add(d != Detail::Toolbar);
+        add(d == Detail::Label);
+        add(d == Detail::MenuItem);
+        add(d == Detail::HSeparator);
+        break;
+    case Func::VLine:
+        add(d == Detail::VSeparator);
+        add(d == Detail::Toolbar);
+        break;
+    case Func::Check:
+        add(d == Detail::Check);
+        break;
+    case Func::Option:
+        add(d == Detail::Option);
+        break;
+    }
+    return res;
+}
+
+// Every draw call prints `QtCurve: <function> <arguments> <detail>  ` (two
+// spaces) followed by the widget hierarchy when the debug log is enabled.
+static bool
+readTrace(const char *fname, std::vector<Call> &calls,
+          std::set<std::string> &details)
+{
+    std::ifstream in(fname);
+    if (!in) {
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    const std::string prefix = "QtCurve: ";
+    for (size_t pos = text.find(prefix);pos != std::string::npos;
+         pos = text.find(prefix, pos)) {
+        pos += prefix.size();
+        size_t end = std::min(text.find("  ", pos), text.find('\n', pos));
+        std::string call = text.substr(pos, end - pos);
+        size_t nameEnd = call.find(' ');
+        size_t detailStart = call.rfind(' ');
+        if (nameEnd == std::string::npos) {
+            continue;
+        }
+        std::string name = call.substr(0, nameEnd);
+        std::string detail = call.substr(detailStart + 1);
+        for (const auto &func: funcNames) {
+            if (name == func.name) {
+                // The style gets the same literal for every call with a
+                // detail, keep one copy of each.
+                calls.push_back(Call{func.func, detail == "(null)" ? nullptr :
+                                     details.insert(detail).first->c_str()});
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+int
+main(int argc, char **argv)
+{
+    int iterations = 10000;
+    const char *fname = nullptr;
+    for (int i = 1;i < argc;i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = qtcMax(1, atoi(argv[++i]));
+        } else {
+            fname = argv[i];
+        }
+    }
+    std::vector<Call> calls;
+    std::set<std::string> details;
+    if (!fname) {
+        calls.assign(std::begin(dialogTrace), std::end(dialogTrace));
+    } else if (!readTrace(fname, calls, details)) {
+        fprintf(stderr, "Cannot read %s\n", fname);
+        return 1;
+    }
+    if (calls.empty()) {
+        fprintf(stderr, "No draw calls in the trace\n");
+        return 1;
+    }
+
+    int mismatches = 0;
+    int unknown = 0;
+    for (const Call &call: calls) {
+        if (stringTests(call.func, call.detail) !=
+            detailTests(call.func, call.detail)) {
+            fprintf(stderr, "Mismatch: %s\n",
+                    call.detail ? call.detail : "(null)");
+            mismatches++;
+        }
+        if (classifyDetail(call.detail) == Detail::Unknown) {
+            unknown++;
+        }
+    }
+
+    uint64_t sink = 0;
+    tic();
+    for (int i = 0;i < iterations;i++) {
+        for (const Call &call: calls) {
+            sink += stringTests(call.func, call.detail);
+        }
+    }
+    uint64_t stringNs = toc();
+    tic();
+    for (int i = 0;i < iterations;i++) {
+        for (const Call &call: calls) {
+            sink -= detailTests(call.func, call.detail);
+        }
+    }
+    uint64_t detailNs = toc();
+
+    double total = double(iterations) * calls.size();
+    printf("%zu calls, %d with an unknown detail, %d mismatches\n",
+           calls.size(), unknown, mismatches);
+    printf("%-10s %10.1f ns/call\n", "strings", stringNs / total);
+    printf("%-10s %10.1f ns/call\n", "classified", detailNs / total);
+    return mismatches || sink ? 1 : 0;
+}
@@ -198,7 +198,6 @@ enum {
 
 #define LIGHT_BORDER(APP) (APPEARANCE_DULL_GLASS==(APP) ? 1 : 0)
 
-#define PROGRESS_ANIMATION 100
 #define MIN_SLIDER_SIZE(A) (LINE_DOTS==(A) ? 24 : 20)
 
 #define CR_SMALL_SIZE 13
@@ -22,6 +22,7 @@
 
 #include <qtcurve-utils/log.h>
 #include <qtcurve-utils/map.h>
+#include <qtcurve-utils/ini.h>
 #include <qtcurve-utils/dirs.h>
 #include <qtcurve-utils/strs.h>
 #include <qtcurve-utils/color.h>
@@ -566,34 +567,38 @@ lookupCfgHash(GHashTable **cfg, const char *key, char *val)
     return rv;
 }
 
-static GHashTable * loadConfig(const char *filename)
+static GHashTable*
+loadConfig(const char *filename)
 {
-    FILE       *f=fopen(filename, "r");
-    GHashTable *cfg=nullptr;
-
-    if(f)
-    {
-        char line[MAX_CONFIG_INPUT_LINE_LEN];
-
-        while(nullptr!=fgets(line, MAX_CONFIG_INPUT_LINE_LEN-1, f))
-        {
-            char *eq=strchr(line, '=');
-            int  pos=eq ? eq-line : -1;
-
-            if(pos>0)
-            {
-                char *endl=strchr(line, '\n');
-
-                if(endl)
-                    *endl='\0';
-
-                line[pos]='\0';
-
-                lookupCfgHash(&cfg, line, &line[pos+1]);
+    QtCurve::Ini::File file(filename);
+    GHashTable *cfg = nullptr;
+
+    if (file.isValid()) {
+        QtCurve::Ini::Tokenizer tokenizer = file.tokenizer();
+        QtCurve::Ini::Token token;
+
+        cfg = g_hash_table_new(g_str_hash, g_str_equal);
+        while ((token = tokenizer.next()) != QtCurve::Ini::Token::End) {
+            const QtCurve::StrView &key = tokenizer.key();
+            if (token != QtCurve::Ini::Token::Entry || key.empty()) {
+                continue;
+            }
+            char *name = g_strndup(key.str, key.len);
+            // The first entry wins, as with lookupCfgHash()
+            if (g_hash_table_lookup(cfg, name)) {
+                g_free(name);
+            } else {
+                const QtCurve::StrView &value = tokenizer.value();
+                g_hash_table_insert(cfg, name,
+                                    g_strndup(value.str, value.len));
             }
         }
-
-        fclose(f);
+        // Like a missing file, a file without any entries is no config,
+        // it must not be read as a version 0 one.
+        if (!g_hash_table_size(cfg)) {
+            g_hash_table_destroy(cfg);
+            cfg = nullptr;
+        }
     }
 
     return cfg;
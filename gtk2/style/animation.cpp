@@ -33,54 +33,97 @@
 #define CHECK_ANIMATION_TIME 0.5
 
 #include "animation.h"
+#include <qtcurve-utils/gtkutils.h>
+#include <qtcurve-utils/gtkprops.h>
 #include <common/common.h>
 
+#include <algorithm>
+#include <vector>
+
+#include <math.h>
+
 namespace QtCurve {
 namespace Animation {
 
 class Info {
 public:
     GtkWidget *const widget;
+    // Step of the animation the widget was last redrawn for
+    int step;
 
-    Info(const GtkWidget *w, double stop_time);
-    ~Info();
+    Info(GtkWidget *w, double stop_time);
     double timer_elapsed() const;
-    void timer_reset() const;
+    void timer_reset();
     bool need_stop() const;
 private:
-    GTimer *const m_timer;
+    double m_start;
     const double m_stop_time;
 };
 
+// Result of a tick for one animated widget.
+enum class Update {
+    Running,
+    // The toplevel is not on screen, the animation resumes once it is.
+    Hidden,
+    Done
+};
+
 struct SignalInfo {
     GtkWidget *widget;
     unsigned long handler_id;
 };
 
+// Toplevel of the animated widgets visited by a tick, the redraws of all its
+// widgets are queued together.
+struct TopLevel {
+    GtkWidget *widget;
+    bool shown;
+    std::vector<GdkRectangle> rects;
+};
+
 static GSList *connected_widgets = nullptr;
-static GHashTable *animated_widgets = nullptr;
+// Few widgets are animated at the same time, a vector is faster to walk and
+// search than a hash table.
+static std::vector<Info*> animated_widgets;
 static int timer_id = 0;
 
 static gboolean timeoutHandler(void *data);
 
-inline
-Info::Info(const GtkWidget *w, double stop_time)
-    : widget(const_cast<GtkWidget*>(w)),
-      m_timer(g_timer_new()),
-      m_stop_time(stop_time)
+// All the animations share a clock and start on a step (one pixel of the
+// progress bar stripes), so that the ticks can be aligned with the steps
+// and every tick moves all of them at once.
+static double
+now()
 {
+    static GTimer *clock = g_timer_new();
+    return g_timer_elapsed(clock, nullptr);
+}
+
+static inline int
+stepAt(double time)
+{
+    return int(time * PROGRESS_CHUNK_WIDTH);
+}
+
+static inline double
+stepStart(int step)
+{
+    return double(step) / PROGRESS_CHUNK_WIDTH;
 }
 
 inline
-Info::~Info()
+Info::Info(GtkWidget *w, double stop_time)
+    : widget(w),
+      step(0),
+      m_start(stepStart(stepAt(now()))),
+      m_stop_time(stop_time)
 {
-    g_timer_destroy(m_timer);
 }
 
 inline double
 Info::timer_elapsed() const
 {
-    return g_timer_elapsed(m_timer, nullptr);
+    return now() - m_start;
 }
 
 inline bool
@@ -90,20 +133,9 @@ Info::need_stop() const
 }
 
 inline void
-Info::timer_reset() const
+Info::timer_reset()
 {
-    g_timer_start(m_timer);
-}
-
-/* This forces a redraw on a widget */
-static void
-force_widget_redraw(GtkWidget *widget)
-{
-    if (GTK_IS_PROGRESS_BAR(widget)) {
-        gtk_widget_queue_resize(widget);
-    } else {
-        gtk_widget_queue_draw(widget);
-    }
+    m_start = stepStart(stepAt(now()));
 }
 
 /* ensures that the timer is running */
@@ -111,8 +143,10 @@ static void
 startTimer()
 {
     if (timer_id == 0) {
-        timer_id = g_timeout_add(PROGRESS_ANIMATION,
-                                 timeoutHandler, nullptr);
+        // Fire right after the next step starts.
+        double time = now();
+        int delay = int((stepStart(stepAt(time) + 1) - time) * 1000) + 1;
+        timer_id = g_timeout_add(delay, timeoutHandler, nullptr);
     }
 }
 
@@ -129,27 +163,24 @@ stopTimer()
 /* This function does not unref the weak reference, because the object
  * is being destroyed currently. */
 static void
-onWidgetDestruction(void *data, GObject *object)
+onWidgetDestruction(void *data, GObject*)
 {
-    /* steal the animation info from the hash table(destroying it would
-     * result in the weak reference to be unrefed, which does not work
-     * as the widget is already destroyed. */
-    g_hash_table_steal(animated_widgets, object);
-    delete (Info*)data;
+    Info *info = (Info*)data;
+    animated_widgets.erase(std::find(animated_widgets.begin(),
+                                     animated_widgets.end(), info));
+    delete info;
 }
 
 /* This function also needs to unref the weak reference. */
 static void
-destroyInfoAndWeakUnref(void *data)
+destroyInfoAndWeakUnref(Info *info)
 {
-    Info *info = (Info*)data;
-
     /* force a last redraw. This is so that if the animation is removed,
      * the widget is left in a sane state. */
-    force_widget_redraw(info->widget);
-
-    g_object_weak_unref(G_OBJECT(info->widget),
-                        onWidgetDestruction, data);
+    if (gtk_widget_is_drawable(info->widget)) {
+        gtk_widget_queue_draw(info->widget);
+    }
+    g_object_weak_unref(G_OBJECT(info->widget), onWidgetDestruction, info);
     delete info;
 }
 
@@ -157,93 +188,210 @@ destroyInfoAndWeakUnref(void *data)
 static Info*
 lookupInfo(const GtkWidget *widget)
 {
-    if (animated_widgets) {
-        return (Info*)g_hash_table_lookup(animated_widgets, widget);
+    for (Info *info: animated_widgets) {
+        if (info->widget == widget) {
+            return info;
+        }
     }
     return nullptr;
 }
 
 /* Create all the relevant information for the animation,
- * and insert it into the hash table. */
+ * and insert it into the list. */
 static void
-addWidget(const GtkWidget *widget, double stop_time)
+addWidget(GtkWidget *widget, double stop_time)
 {
     /* object already in the list, do not add it twice */
-    if (lookupInfo(widget)) {
-        return;
+    if (!lookupInfo(widget)) {
+        auto *value = new Info(widget, stop_time);
+        g_object_weak_ref(G_OBJECT(widget), onWidgetDestruction, value);
+        animated_widgets.push_back(value);
     }
+    // The timer may have been stopped while the widget was hidden.
+    startTimer();
+}
+
+// Whether the toplevel is on screen, the widgets of minimized windows are
+// kept but not animated until the window is shown again.
+static bool
+isShown(GtkWidget *topLevel)
+{
+    GdkWindow *window = gtk_widget_get_window(topLevel);
+    return (window && gdk_window_is_viewable(window) &&
+            !(gdk_window_get_state(window) &
+              (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)));
+}
 
-    if (animated_widgets == nullptr) {
-        animated_widgets =
-            g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
-                                  destroyInfoAndWeakUnref);
+static TopLevel*
+lookupTopLevel(std::vector<TopLevel> &topLevels, GtkWidget *widget)
+{
+    GtkWidget *topLevel = gtk_widget_get_toplevel(widget);
+    for (TopLevel &item: topLevels) {
+        if (item.widget == topLevel) {
+            return &item;
+        }
     }
+    topLevels.push_back(TopLevel{topLevel, isShown(topLevel), {}});
+    return &topLevels.back();
+}
 
-    auto *value = new Info(widget, stop_time);
+static gboolean
+topLevelShown(GtkWidget*, GdkEvent*, void*)
+{
+    if (!animated_widgets.empty()) {
+        startTimer();
+    }
+    return false;
+}
 
-    g_object_weak_ref(G_OBJECT(widget), onWidgetDestruction, value);
-    g_hash_table_insert(animated_widgets, (GtkWidget*)widget, value);
+// A GtkProgressBar expose only copies its offscreen pixmap, so nothing else
+// restarts the animations of a window that is shown again.
+static void
+watchTopLevel(GtkWidget *topLevel)
+{
+    if (gtk_widget_is_toplevel(topLevel)) {
+        GtkWidgetProps props(topLevel);
+        props->animWindowState.conn("window-state-event", topLevelShown);
+        props->animMap.conn("map-event", topLevelShown);
+    }
+}
 
-    startTimer();
+// The part of the widget that changes with the animation, relative to its
+// allocation. That is the filled part of a progress bar, with a few pixels
+// to spare for the border.
+static GdkRectangle
+animatedRect(GtkWidget *widget, double fraction)
+{
+    auto alloc = Widget::getAllocation(widget);
+    GdkRectangle rect = {0, 0, alloc.width, alloc.height};
+#if !GTK_CHECK_VERSION(2, 90, 0) /* Gtk3:TODO !!! */
+    if (GTK_IS_PROGRESS_BAR(widget)) {
+        GtkProgressBarOrientation orientation =
+            gtk_progress_bar_get_orientation(GTK_PROGRESS_BAR(widget));
+        if (gtk_widget_get_direction(widget) == GTK_TEXT_DIR_RTL) {
+            if (orientation == GTK_PROGRESS_LEFT_TO_RIGHT) {
+                orientation = GTK_PROGRESS_RIGHT_TO_LEFT;
+            } else if (orientation == GTK_PROGRESS_RIGHT_TO_LEFT) {
+                orientation = GTK_PROGRESS_LEFT_TO_RIGHT;
+            }
+        }
+        GtkStyle *style = gtk_widget_get_style(widget);
+        bool horiz = oneOf(orientation, GTK_PROGRESS_LEFT_TO_RIGHT,
+                           GTK_PROGRESS_RIGHT_TO_LEFT);
+        int thickness = horiz ? style->xthickness : style->ythickness;
+        int &length = horiz ? rect.width : rect.height;
+        int &pos = horiz ? rect.x : rect.y;
+        int filled = qtcMin(length, thickness + 2 +
+                            int(ceil((length - 2 * thickness) * fraction)));
+        if (oneOf(orientation, GTK_PROGRESS_RIGHT_TO_LEFT,
+                  GTK_PROGRESS_BOTTOM_TO_TOP)) {
+            pos = length - filled;
+        }
+        length = filled;
+    }
+#endif
+    return rect;
 }
 
-/* update the animation information for each widget. This will also queue a redraw
- * and stop the animation if it is done. */
-static gboolean
-updateInfo(void *key, void *value, void*)
+/* update the animation information for a widget. This will also queue a
+ * redraw and returns whether the animation is running, paused or done. */
+static Update
+updateInfo(Info *info, std::vector<TopLevel> &topLevels)
 {
-    Info *info = (Info*)value;
-    GtkWidget *widget = (GtkWidget*)key;
+    GtkWidget *widget = info->widget;
 
-    if ((widget == nullptr) || (info == nullptr)) {
-        g_assert_not_reached();
+    TopLevel *topLevel = lookupTopLevel(topLevels, widget);
+    if (!topLevel->shown) {
+        return Update::Hidden;
     }
 
-    /* remove the widget from the hash table if it is not drawable */
+    /* remove the widget from the list if it is not drawable */
     if (!gtk_widget_is_drawable(widget)) {
-        return true;
+        return Update::Done;
     }
 
+    double fraction = 0.5;
     if (GTK_IS_PROGRESS_BAR(widget)) {
-        float fraction =
-            gtk_progress_bar_get_fraction(GTK_PROGRESS_BAR(widget));
-        /* stop animation for filled/not filled progress bars */
-        if (fraction <= 0.0 || fraction >= 1.0) {
-            return true;
-        }
+        fraction = gtk_progress_bar_get_fraction(GTK_PROGRESS_BAR(widget));
     } else if (GTK_IS_ENTRY(widget)) {
-        float fraction = gtk_entry_get_progress_fraction(GTK_ENTRY(widget));
+        fraction = gtk_entry_get_progress_fraction(GTK_ENTRY(widget));
+    }
+    /* stop animation for filled/not filled progress bars */
+    if (fraction <= 0.0 || fraction >= 1.0) {
+        return Update::Done;
+    }
 
-        /* stop animation for filled/not filled progress bars */
-        if (fraction <= 0.0 || fraction >= 1.0) {
-            return true;
+    // Only redraw when the widget would look different.
+    int step = stepAt(info->timer_elapsed());
+    if (step != info->step) {
+        info->step = step;
+#if !GTK_CHECK_VERSION(2, 90, 0) /* Gtk3:TODO !!! */
+        // The bar is drawn into an offscreen pixmap, exposes only copy it.
+        if (GTK_IS_PROGRESS_BAR(widget)) {
+            GtkProgress *progress = GTK_PROGRESS(widget);
+            if (progress->offscreen_pixmap) {
+                GTK_PROGRESS_GET_CLASS(progress)->paint(progress);
+            }
+        }
+#endif
+        GdkRectangle rect = animatedRect(widget, fraction);
+        if (gtk_widget_translate_coordinates(widget, topLevel->widget,
+                                             rect.x, rect.y,
+                                             &rect.x, &rect.y)) {
+            topLevel->rects.push_back(rect);
+        } else {
+            gtk_widget_queue_draw(widget);
         }
     }
 
-    force_widget_redraw(widget);
-
     /* stop at stop_time */
-    if (info->need_stop()) {
-        return true;
-    }
-    return false;
+    return info->need_stop() ? Update::Done : Update::Running;
 }
 
-/* This gets called by the glib main loop every once in a while. */
+/* This gets called by the glib main loop once per step. */
 static gboolean
 timeoutHandler(void*)
 {
+    timer_id = 0;
     /* enter threads as updateInfo will use gtk/gdk. */
     gdk_threads_enter();
-    g_hash_table_foreach_remove(animated_widgets, updateInfo, nullptr);
+    std::vector<TopLevel> topLevels;
+    // Painting a progress bar may add it to the list.
+    std::vector<Info*> infos(animated_widgets);
+    bool running = false;
+    for (Info *info: infos) {
+        switch (updateInfo(info, topLevels)) {
+        case Update::Running:
+            running = true;
+            break;
+        case Update::Hidden:
+            break;
+        case Update::Done:
+            animated_widgets.erase(std::find(animated_widgets.begin(),
+                                             animated_widgets.end(), info));
+            destroyInfoAndWeakUnref(info);
+            break;
+        }
+    }
+    for (const TopLevel &topLevel: topLevels) {
+        if (!topLevel.shown) {
+            watchTopLevel(topLevel.widget);
+            continue;
+        }
+        GdkWindow *window = gtk_widget_get_window(topLevel.widget);
+        for (const GdkRectangle &rect: topLevel.rects) {
+            gdk_window_invalidate_rect(window, &rect, true);
+        }
+    }
     /* leave threads again */
     gdk_threads_leave();
 
-    if (g_hash_table_size(animated_widgets) == 0) {
-        stopTimer();
-        return false;
+    // Only widgets on screen keep the timer running, the others restart it
+    // when their toplevel is shown.
+    if (running) {
+        startTimer();
     }
-    return true;
+    return false;
 }
 
 static void
@@ -325,7 +473,7 @@ addProgressBar(GtkWidget *progressbar, bool isEntry)
          gtk_progress_bar_get_fraction(GTK_PROGRESS_BAR(progressbar)));
 
     if (fraction < 1.0 && fraction > 0.0) {
-        addWidget((GtkWidget*)progressbar, 0.0);
+        addWidget(progressbar, 0.0);
     }
 }
 
@@ -335,9 +483,10 @@ cleanup()
 {
     disconnect();
 
-    if (animated_widgets != nullptr) {
-        g_hash_table_destroy(animated_widgets);
-        animated_widgets = nullptr;
+    std::vector<Info*> infos;
+    infos.swap(animated_widgets);
+    for (Info *info: infos) {
+        destroyInfoAndWeakUnref(info);
     }
     stopTimer();
 }
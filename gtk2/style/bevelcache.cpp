@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "bevelcache.h"
+
+#include <list>
+#include <unordered_map>
+
+#include <stddef.h>
+#include <string.h>
+
+namespace QtCurve {
+namespace BevelCache {
+
+struct KeyHash {
+    size_t
+    operator()(const BevelKey &key) const
+    {
+        const unsigned char *data = (const unsigned char*)&key;
+        size_t hash = 2166136261u;
+        for (size_t i = 0;i < sizeof(BevelKey);i++) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+        return hash;
+    }
+};
+
+struct KeyEqual {
+    bool
+    operator()(const BevelKey &lhs, const BevelKey &rhs) const
+    {
+        return memcmp(&lhs, &rhs, sizeof(BevelKey)) == 0;
+    }
+};
+
+struct Entry {
+    BevelKey key;
+    cairo_surface_t *surface;
+    size_t cost;
+};
+
+// Large bevels are cached as a short slice, so this holds the buttons,
+// scrollbars and menu items of a good number of windows.
+static const size_t constMaxCost = 2 * 1024 * 1024;
+
+// Most recently used first.
+static std::list<Entry> entries;
+static std::unordered_map<BevelKey, std::list<Entry>::iterator,
+                          KeyHash, KeyEqual> entryMap;
+static size_t totalCost = 0;
+
+static void
+dropLast()
+{
+    const Entry &last = entries.back();
+    entryMap.erase(last.key);
+    totalCost -= last.cost;
+    cairo_surface_destroy(last.surface);
+    entries.pop_back();
+}
+
+cairo_surface_t*
+find(const BevelKey &key)
+{
+    auto it = entryMap.find(key);
+    if (it == entryMap.end()) {
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->surface;
+}
+
+void
+insert(const BevelKey &key, cairo_surface_t *surface)
+{
+    size_t cost = (cairo_image_surface_get_stride(surface) *
+                   cairo_image_surface_get_height(surface));
+    entries.push_front(Entry{key, surface, cost});
+    totalCost += cost;
+    auto res = entryMap.insert({key, entries.begin()});
+    if (!res.second) {
+        totalCost -= res.first->second->cost;
+        cairo_surface_destroy(res.first->second->surface);
+        entries.erase(res.first->second);
+        res.first->second = entries.begin();
+    }
+    // Never drop the new entry, the caller is about to paint it.
+    while (totalCost > constMaxCost && entries.size() > 1) {
+        dropLast();
+    }
+}
+
+void
+clear()
+{
+    for (const Entry &entry: entries) {
+        cairo_surface_destroy(entry.surface);
+    }
+    entries.clear();
+    entryMap.clear();
+    totalCost = 0;
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTC_BEVELCACHE_H__
+#define __QTC_BEVELCACHE_H__
+
+#include <cairo.h>
+#include <stdint.h>
+#include <common/common.h>
+
+namespace QtCurve {
+
+/**
+ * Everything a light bevel rendering depends on besides the options and the
+ * palette. Only made of 8 and 16 bit fields so that it has no padding and
+ * can be hashed and compared as raw memory, always zero it before filling.
+ */
+struct BevelKey {
+    // Facts drawLightBevel finds out from the GtkWidget
+    enum {
+        OnToolbar = 1 << 0,
+        Focused = 1 << 1,
+        ComboEntryButton = 1 << 2,
+        ToggleButton = 1 << 3,
+        Scrollbar = 1 << 4,
+        FixedParent = 1 << 5,
+        ParentBg = 1 << 6,
+        // Which palette (if any) colors is, the border and glow compare
+        // palettes by address.
+        FocusColors = 1 << 7,
+        MouseOverColors = 1 << 8,
+        ComboColors = 1 << 9,
+        DefBtnColors = 1 << 10,
+    };
+    uint16_t colors[TOTAL_SHADES + 1][3];
+    uint16_t base[3];
+    // Style colors drawBorder may use
+    uint16_t styleBg[3];
+    uint16_t styleBase[3];
+    uint16_t styleText[3];
+    // Parent background the lower etch is shaded from
+    uint16_t parentBg[3];
+    uint16_t width;
+    uint16_t height;
+    uint8_t widget;
+    uint8_t state;
+    uint8_t round;
+    uint8_t borderProfile;
+    uint16_t flags;
+    uint16_t context;
+};
+
+namespace BevelCache {
+
+// Returns a surface owned by the cache (valid until the next insert() or
+// clear()) and marks it as recently used.
+cairo_surface_t *find(const BevelKey &key);
+// Takes ownership of the surface, the least recently used ones are dropped
+// once the cache is over its size limit.
+void insert(const BevelKey &key, cairo_surface_t *surface);
+// The renderings depend on the options and the palette, drop them when
+// those are (re)loaded.
+void clear();
+
+}
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "detail.h"
+
+#include <qtcurve-utils/strs.h>
+
+#include <algorithm>
+
+namespace QtCurve {
+
+namespace {
+
+struct DetailName {
+    const char *name;
+    Detail detail;
+};
+
+// Sorted by name (strcmp order).
+static const DetailName detailNames[] = {
+    {"arrow", Detail::Arrow},
+    {"bar", Detail::Bar},
+    {"base", Detail::Base},
+    {"button", Detail::Button},
+    {"buttondefault", Detail::ButtonDefault},
+    {"cellrenderertext", Detail::CellRendererText},
+    {"check", Detail::Check},
+    {"checkbutton", Detail::CheckButton},
+    {"dockitem", Detail::DockItem},
+    {"dockitem_bin", Detail::DockItemBin},
+    {"entry", Detail::Entry},
+    {"entry-progress", Detail::EntryProgress},
+    {"eventbox", Detail::EventBox},
+    {"expander", Detail::Expander},
+    {"frame", Detail::Frame},
+    {"handlebox", Detail::HandleBox},
+    {"handlebox_bin", Detail::HandleBoxBin},
+    {"hpaned", Detail::HPaned},
+    {"hruler", Detail::HRuler},
+    {"hscale", Detail::HScale},
+    {"hseparator", Detail::HSeparator},
+    {"icon_view_item", Detail::IconViewItem},
+    {"label", Detail::Label},
+    {"menu", Detail::Menu},
+    {"menubar", Detail::MenuBar},
+    {"menuitem", Detail::MenuItem},
+    {"notebook", Detail::Notebook},
+    {"option", Detail::Option},
+    {"optionmenu", Detail::OptionMenu},
+    {"paned", Detail::Paned},
+    {"progressbar", Detail::ProgressBar},
+    {"qtc-slider", Detail::QtcSlider},
+    {"scrolled_window", Detail::ScrolledWindow},
+    {"slider", Detail::Slider},
+    {"spinbutton", Detail::SpinButton},
+    {"spinbutton_down", Detail::SpinButtonDown},
+    {"spinbutton_up", Detail::SpinButtonUp},
+    {"splitter", Detail::Splitter},
+    {"stepper", Detail::Stepper},
+    {"tab", Detail::Tab},
+    {"text", Detail::Text},
+    {"togglebutton", Detail::ToggleButton},
+    {"togglebuttondefault", Detail::ToggleButtonDefault},
+    {"toolbar", Detail::Toolbar},
+    {"tooltip", Detail::Tooltip},
+    {"trough", Detail::Trough},
+    {"viewport", Detail::Viewport},
+    {"viewportbin", Detail::ViewportBin},
+    {"vpaned", Detail::VPaned},
+    {"vruler", Detail::VRuler},
+    {"vscale", Detail::VScale},
+    {"vseparator", Detail::VSeparator},
+};
+
+// Details that carry a suffix (e.g. the stepper position).
+static const DetailName detailPrefixes[] = {
+    {"hscrollbar", Detail::HScrollbar},
+    {"menu_scroll_arrow_", Detail::MenuScrollArrow},
+    {"trough-", Detail::TroughPart},
+    {"vscrollbar", Detail::VScrollbar},
+};
+
+static Detail
+lookupDetail(const char *detail)
+{
+    auto end = std::end(detailNames);
+    auto it = std::lower_bound(std::begin(detailNames), end, detail,
+                               [] (const DetailName &entry, const char *str) {
+                                   return strcmp(entry.name, str) < 0;
+                               });
+    if (it != end && strcmp(it->name, detail) == 0) {
+        return it->detail;
+    }
+    for (const auto &prefix: detailPrefixes) {
+        if (Str::startsWith(detail, prefix.name)) {
+            return prefix.detail;
+        }
+    }
+    return Detail::Unknown;
+}
+
+struct DetailMemo {
+    const char *ptr;
+    Detail detail;
+    // Copy of the string, the pointer may be reused for another detail if it
+    // was not a literal.
+    char name[23];
+};
+
+static const int constMemoSize = 64;
+static DetailMemo detailMemo[constMemoSize];
+
+}
+
+Detail
+classifyDetail(const char *detail)
+{
+    if (!detail || !detail[0]) {
+        return Detail::None;
+    }
+    uintptr_t addr = uintptr_t(detail);
+    DetailMemo &memo = detailMemo[(addr ^ (addr >> 6) ^ (addr >> 12)) %
+                                  constMemoSize];
+    if (memo.ptr == detail && strcmp(memo.name, detail) == 0) {
+        return memo.detail;
+    }
+    Detail res = lookupDetail(detail);
+    size_t len = strlen(detail);
+    if (len < sizeof(memo.name)) {
+        memo.ptr = detail;
+        memo.detail = res;
+        memcpy(memo.name, detail, len + 1);
+    }
+    return res;
+}
+
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTC_DETAIL_H__
+#define __QTC_DETAIL_H__
+
+#include <stdint.h>
+
+namespace QtCurve {
+
+/**
+ * The detail strings passed to the GtkStyle draw functions, the draw functions
+ * classify the string once and switch on the result instead of comparing it
+ * against every detail they handle.
+ */
+enum class Detail : uint8_t {
+    None, // nullptr or ""
+    Unknown,
+    Arrow,
+    Bar,
+    Base,
+    Button,
+    ButtonDefault,
+    CellRendererText,
+    Check,
+    CheckButton,
+    DockItem,
+    DockItemBin,
+    Entry,
+    EntryProgress,
+    EventBox,
+    Expander,
+    Frame,
+    HandleBox,
+    HandleBoxBin,
+    HPaned,
+    HRuler,
+    HScale,
+    HScrollbar, // hscrollbar*
+    HSeparator,
+    IconViewItem,
+    Label,
+    Menu,
+    MenuBar,
+    MenuItem,
+    MenuScrollArrow, // menu_scroll_arrow_*
+    Notebook,
+    Option,
+    OptionMenu,
+    Paned,
+    ProgressBar,
+    QtcSlider,
+    ScrolledWindow,
+    Slider,
+    SpinButton,
+    SpinButtonDown,
+    SpinButtonUp,
+    Splitter,
+    Stepper,
+    Tab,
+    Text,
+    ToggleButton,
+    ToggleButtonDefault,
+    Toolbar,
+    Tooltip,
+    Trough,
+    TroughPart, // trough-*
+    Viewport,
+    ViewportBin,
+    VPaned,
+    VRuler,
+    VScale,
+    VScrollbar, // vscrollbar*
+    VSeparator,
+};
+
+/**
+ * Classify a detail string. The details are almost always string literals so
+ * the result is remembered per pointer (and checked against the string), only
+ * the first call for a detail searches the name table.
+ * Not thread safe, like the rest of the style it must only be used from the
+ * GUI thread.
+ */
+Detail classifyDetail(const char *detail);
+
+}
+
+#endif
@@ -30,10 +30,15 @@
 #include "entry.h"
 #include "tab.h"
 #include "animation.h"
+#include "gradientcache.h"
+#include "bevelcache.h"
+#include "window.h"
 
 #include <qtcurve-utils/gtkprops.h>
 #include <qtcurve-utils/color.h>
 #include <qtcurve-utils/log.h>
+#include <qtcurve-utils/mask.h>
+#include <qtcurve-utils/strs.h>
 
 #include <common/config_file.h>
 
@@ -43,21 +48,16 @@ namespace QtCurve {
 static cairo_region_t*
 windowMask(int x, int y, int w, int h, bool full)
 {
-    QtcRect rects[4];
-    int numRects = 4;
-
-    if (full) {
-        rects[0] = qtcRect(x + 4, y + 0, w - 4 * 2, h);
-        rects[1] = qtcRect(x + 0, y + 4, w, h - 4 * 2);
-        rects[2] = qtcRect(x + 2, y + 1, w - 2 * 2, h - 2);
-        rects[3] = qtcRect(x + 1, y + 2, w - 2, h - 2 * 2);
-    } else {
-        rects[0] = qtcRect(x + 1, y + 1, w - 2, h - 2);
-        rects[1] = qtcRect(x, y + 2, w, h - 4);
-        rects[2] = qtcRect(x + 2, y, w - 4, h);
-        numRects = 3;
-    }
-    return cairo_region_create_rectangles(rects, numRects);
+    static const RoundedMask fullMask({4, 2, 1, 1});
+    static const RoundedMask slightMask({2, 1});
+    RoundedMask::Rect rects[RoundedMask::constMaxRects];
+    QtcRect cairoRects[RoundedMask::constMaxRects];
+    int numRects = (full ? fullMask : slightMask).rects(x, y, w, h, rects);
+    for (int i = 0;i < numRects;i++) {
+        cairoRects[i] = qtcRect(rects[i].x, rects[i].y,
+                                rects[i].width, rects[i].height);
+    }
+    return cairo_region_create_rectangles(cairoRects, numRects);
 }
 #endif
 
@@ -92,9 +92,6 @@ drawBevelGradient(cairo_t *cr, const QtcRect *area, int x, int y,
             Cairo::rect(cr, area, x, y, width, height, base, alpha);
         }
     } else {
-        cairo_pattern_t *pt =
-            cairo_pattern_create_linear(x, y, horiz ? x : x + width - 1,
-                                        horiz ? y + height - 1 : y);
         bool topTab = w == WIDGET_TAB_TOP;
         bool botTab = w == WIDGET_TAB_BOT;
         bool selected = (topTab || botTab) ? false : sel;
@@ -106,49 +103,68 @@ drawBevelGradient(cairo_t *cr, const QtcRect *area, int x, int y,
                            widgetIsButton(w) ||
                            WIDGET_LISTVIEW_HEADER == w ? bevApp :
                            APPEARANCE_GRADIENT);
-        const Gradient *grad = qtcGetGradient(app, &opts);
-        Cairo::Saver saver(cr);
-        Cairo::clipRect(cr, area);
-
-        for (int i = 0;i < grad->numStops;i++) {
-            GdkColor col;
-            double pos = botTab ? 1.0 - grad->stops[i].pos : grad->stops[i].pos;
-
-            if ((topTab || botTab) && i == grad->numStops - 1) {
-                if (sel && opts.tabBgnd == 0 && !isMozilla()) {
-                    alpha = 0.0;
+        int length = horiz ? height : width;
+        bool opaqueStops = oneOf(w, WIDGET_TOOLTIP, WIDGET_LISTVIEW_HEADER);
+        bool clearEnd = ((topTab || botTab) && sel && opts.tabBgnd == 0 &&
+                         !isMozilla());
+        const GradientKey key = {
+            base->red, base->green, base->blue, uint8_t(app),
+            uint8_t((horiz ? GradientKey::Horiz : 0) |
+                    (topTab ? GradientKey::TopTab : 0) |
+                    (botTab ? GradientKey::BotTab : 0) |
+                    (opaqueStops ? GradientKey::OpaqueStops : 0) |
+                    (clearEnd ? GradientKey::ClearEnd : 0)),
+            length, alpha
+        };
+        cairo_pattern_t *pt = GradientCache::find(key);
+        if (!pt) {
+            pt = cairo_pattern_create_linear(0, 0, horiz ? 0 : length - 1,
+                                             horiz ? length - 1 : 0);
+            const Gradient *grad = qtcGetGradient(app, &opts);
+            for (int i = 0;i < grad->numStops;i++) {
+                GdkColor col;
+                double pos = (botTab ? 1.0 - grad->stops[i].pos :
+                              grad->stops[i].pos);
+                double stopAlpha = (opaqueStops ? alpha :
+                                    alpha * grad->stops[i].alpha);
+
+                if ((topTab || botTab) && i == grad->numStops - 1) {
+                    if (clearEnd) {
+                        stopAlpha = 0.0;
+                    }
+                    col = *base;
+                } else {
+                    double val = (botTab && opts.invertBotTab ?
+                                  INVERT_SHADE(grad->stops[i].val) :
+                                  grad->stops[i].val);
+                    qtcShade(base, &col, botTab && opts.invertBotTab ?
+                             qtcMax(val, 0.9) : val, opts.shading);
                 }
-                col = *base;
-            } else {
-                double val = (botTab && opts.invertBotTab ?
-                              INVERT_SHADE(grad->stops[i].val) :
-                              grad->stops[i].val);
-                qtcShade(base, &col, botTab && opts.invertBotTab ?
-                         qtcMax(val, 0.9) : val, opts.shading);
+                Cairo::patternAddColorStop(pt, pos, &col, stopAlpha);
             }
 
-            Cairo::patternAddColorStop(pt, pos, &col,
-                                       oneOf(w, WIDGET_TOOLTIP,
-                                             WIDGET_LISTVIEW_HEADER) ?
-                                       alpha : alpha * grad->stops[i].alpha);
-        }
-
-        if (app == APPEARANCE_AGUA && !(topTab || botTab) &&
-            (horiz ? height : width) > AGUA_MAX) {
-            GdkColor col;
-            double pos = AGUA_MAX / ((horiz ? height : width) * 2.0);
+            if (app == APPEARANCE_AGUA && !(topTab || botTab) &&
+                length > AGUA_MAX) {
+                GdkColor col;
+                double pos = AGUA_MAX / (length * 2.0);
 
-            qtcShade(base, &col, AGUA_MID_SHADE, opts.shading);
-            Cairo::patternAddColorStop(pt, pos, &col, alpha);
-            /* *grad->stops[i].alpha); */
-            Cairo::patternAddColorStop(pt, 1.0 - pos, &col, alpha);
-            /* *grad->stops[i].alpha); */
+                qtcShade(base, &col, AGUA_MID_SHADE, opts.shading);
+                Cairo::patternAddColorStop(pt, pos, &col, alpha);
+                /* *grad->stops[i].alpha); */
+                Cairo::patternAddColorStop(pt, 1.0 - pos, &col, alpha);
+                /* *grad->stops[i].alpha); */
+            }
+            GradientCache::insert(key, pt);
         }
+        cairo_matrix_t matrix;
+        cairo_matrix_init_translate(&matrix, -x, -y);
+        cairo_pattern_set_matrix(pt, &matrix);
 
+        Cairo::Saver saver(cr);
+        Cairo::clipRect(cr, area);
         cairo_set_source(cr, pt);
         cairo_rectangle(cr, x, y, width, height);
         cairo_fill(cr);
-        cairo_pattern_destroy(pt);
     }
 }
 
@@ -374,11 +390,12 @@ addStripes(cairo_t *cr, int x, int y, int w, int h, bool horizontal)
     Cairo::stripes(cr, x, y, w, h, horizontal, STRIPE_WIDTH);
 }
 
-void
-drawLightBevel(cairo_t *cr, GtkStyle *style, GtkStateType state,
-               const QtcRect *area, int x, int y, int width, int height,
-               const GdkColor *base, const GdkColor *colors, ECornerBits round,
-               EWidget widget, EBorder borderProfile, int flags, GtkWidget *wid)
+static void
+renderLightBevel(cairo_t *cr, GtkStyle *style, GtkStateType state,
+                 const QtcRect *area, int x, int y, int width, int height,
+                 const GdkColor *base, const GdkColor *colors,
+                 ECornerBits round, EWidget widget, EBorder borderProfile,
+                 int flags, GtkWidget *wid)
 {
     EAppearance app = qtcWidgetApp(APPEARANCE_NONE != opts.tbarBtnAppearance &&
                                    (WIDGET_TOOLBAR_BUTTON == widget ||
@@ -789,6 +806,197 @@ drawLightBevel(cairo_t *cr, GtkStyle *style, GtkStateType state,
     }
 }
 
+// Bevels up to this size are cached as they are. Longer ones only vary at
+// their ends, they are cached as a slice with constBevelEnd pixels at each
+// end and their middle column is stretched to the actual length.
+static const int constBevelMaxSize = 64;
+static const int constBevelEnd = 32;
+static const int constBevelSlice = constBevelEnd * 2 + 1;
+// Etches and glows are drawn slightly outside of the bevel.
+static const int constBevelMargin = 4;
+
+static inline void
+setKeyColor(uint16_t *key, const GdkColor *col)
+{
+    key[0] = col->red;
+    key[1] = col->green;
+    key[2] = col->blue;
+}
+
+// Everything renderLightBevel (and drawEtch) looks up from the GtkWidget,
+// keep both in sync.
+static int
+bevelContext(EWidget widget, int flags, GtkWidget *wid, uint16_t *parentBg)
+{
+    int context = 0;
+    if (opts.tbarBtnAppearance != APPEARANCE_NONE &&
+        widget != WIDGET_TOOLBAR_BUTTON && widgetIsButton(widget) &&
+        isOnToolbar(wid, nullptr, 0)) {
+        context |= BevelKey::OnToolbar;
+    }
+    if (wid) {
+        if ((flags & DF_HAS_FOCUS) || gtk_widget_has_focus(wid)) {
+            context |= BevelKey::Focused;
+            if (isComboBoxEntryButton(wid)) {
+                context |= BevelKey::ComboEntryButton;
+            }
+        }
+        if (GTK_IS_TOGGLE_BUTTON(wid)) {
+            context |= BevelKey::ToggleButton;
+        }
+        if (GTK_IS_SCROLLBAR(wid)) {
+            context |= BevelKey::Scrollbar;
+        }
+        if (widget == WIDGET_COMBO_BUTTON &&
+            qtSettings.app == GTK_APP_OPEN_OFFICE &&
+            isFixedWidget(gtk_widget_get_parent(wid))) {
+            context |= BevelKey::FixedParent;
+        }
+    }
+    // See setLowerEtchCol()
+    if (flags & DF_DO_BORDER && opts.buttonEffect != EFFECT_NONE &&
+        !USE_CUSTOM_ALPHAS(opts) && qtcIsFlatBgnd(opts.bgndAppearance) &&
+        (!wid || !g_object_get_data(G_OBJECT(wid), "transparent-bg-hint"))) {
+        if (const GdkColor *bg = getParentBgCol(wid)) {
+            context |= BevelKey::ParentBg;
+            setKeyColor(parentBg, bg);
+        }
+    }
+    return context;
+}
+
+static void
+paintBevelSurface(cairo_t *cr, const QtcRect *area, cairo_surface_t *surface,
+                  int x, int y, int width, int height, bool horiz, bool sliced)
+{
+    Cairo::Saver saver(cr);
+    Cairo::clipRect(cr, area);
+    int sx = x - constBevelMargin;
+    int sy = y - constBevelMargin;
+    if (!sliced) {
+        cairo_set_source_surface(cr, surface, sx, sy);
+        cairo_paint(cr);
+        return;
+    }
+    int length = horiz ? width : height;
+    int endLength = constBevelMargin + constBevelEnd;
+    int across = (horiz ? height : width) + constBevelMargin * 2;
+    int middle = length - constBevelEnd * 2;
+    int offset = length - constBevelSlice;
+
+    // Start
+    cairo_set_source_surface(cr, surface, sx, sy);
+    if (horiz) {
+        cairo_rectangle(cr, sx, sy, endLength, across);
+    } else {
+        cairo_rectangle(cr, sx, sy, across, endLength);
+    }
+    cairo_fill(cr);
+    // End
+    if (horiz) {
+        cairo_set_source_surface(cr, surface, sx + offset, sy);
+        cairo_rectangle(cr, x + constBevelEnd + middle, sy, endLength, across);
+    } else {
+        cairo_set_source_surface(cr, surface, sx, sy + offset);
+        cairo_rectangle(cr, sx, y + constBevelEnd + middle, across, endLength);
+    }
+    cairo_fill(cr);
+    // Middle, every pixel samples the middle column (or row) of the slice.
+    cairo_pattern_t *pt = cairo_pattern_create_for_surface(surface);
+    cairo_matrix_t matrix;
+    double scale = 1.0 / middle;
+    if (horiz) {
+        cairo_matrix_init(&matrix, scale, 0, 0, 1,
+                          endLength - scale * (x + constBevelEnd), -sy);
+        cairo_rectangle(cr, x + constBevelEnd, sy, middle, across);
+    } else {
+        cairo_matrix_init(&matrix, 1, 0, 0, scale, -sx,
+                          endLength - scale * (y + constBevelEnd));
+        cairo_rectangle(cr, sx, y + constBevelEnd, across, middle);
+    }
+    cairo_pattern_set_matrix(pt, &matrix);
+    cairo_pattern_set_filter(pt, CAIRO_FILTER_NEAREST);
+    cairo_set_source(cr, pt);
+    cairo_fill(cr);
+    cairo_pattern_destroy(pt);
+}
+
+void
+drawLightBevel(cairo_t *cr, GtkStyle *style, GtkStateType state,
+               const QtcRect *area, int x, int y, int width, int height,
+               const GdkColor *base, const GdkColor *colors, ECornerBits round,
+               EWidget widget, EBorder borderProfile, int flags, GtkWidget *wid)
+{
+    bool horiz = !(flags & DF_VERT) || CIRCULAR_SLIDER(widget);
+    int length = horiz ? width : height;
+    int across = horiz ? height : width;
+    // The gradients run across the bevel, the rest only depends on the
+    // length through the corners, except for the stripes and the plastik
+    // mouse-over lines of sliders and for the round widgets.
+    bool sliced = (length > constBevelSlice &&
+                   widget != WIDGET_RADIO_BUTTON && !CIRCULAR_SLIDER(widget) &&
+                   !(widget == WIDGET_SB_SLIDER && opts.stripedSbar) &&
+                   !(state == GTK_STATE_PRELIGHT &&
+                     opts.coloredMouseOver == MO_PLASTIK));
+    if (width <= 0 || height <= 0 || across > constBevelMaxSize ||
+        (!sliced && length > constBevelMaxSize)) {
+        renderLightBevel(cr, style, state, area, x, y, width, height, base,
+                         colors, round, widget, borderProfile, flags, wid);
+        return;
+    }
+    if (sliced) {
+        if (horiz) {
+            width = constBevelSlice;
+        } else {
+            height = constBevelSlice;
+        }
+    }
+
+    BevelKey key;
+    memset(&key, 0, sizeof(key));
+    for (int i = 0;i < TOTAL_SHADES + 1;i++) {
+        setKeyColor(key.colors[i], &colors[i]);
+    }
+    setKeyColor(key.base, base);
+    setKeyColor(key.styleBg, &style->bg[state]);
+    setKeyColor(key.styleBase, &style->base[state]);
+    setKeyColor(key.styleText, &style->text[GTK_STATE_NORMAL]);
+    key.width = uint16_t(width);
+    key.height = uint16_t(height);
+    key.widget = uint8_t(widget);
+    key.state = uint8_t(state);
+    key.round = uint8_t(round);
+    key.borderProfile = uint8_t(borderProfile);
+    key.flags = uint16_t(flags);
+    key.context = uint16_t(
+        bevelContext(widget, flags, wid, key.parentBg) |
+        (colors == qtcPalette.focus ? BevelKey::FocusColors : 0) |
+        (colors == qtcPalette.mouseover ? BevelKey::MouseOverColors : 0) |
+        (colors == qtcPalette.combobtn ? BevelKey::ComboColors : 0) |
+        (colors == qtcPalette.defbtn ? BevelKey::DefBtnColors : 0));
+
+    cairo_surface_t *surface = BevelCache::find(key);
+    if (!surface) {
+        surface = cairo_image_surface_create(
+            CAIRO_FORMAT_ARGB32, width + constBevelMargin * 2,
+            height + constBevelMargin * 2);
+        cairo_t *scr = cairo_create(surface);
+        renderLightBevel(scr, style, state, nullptr, constBevelMargin,
+                         constBevelMargin, width, height, base, colors, round,
+                         widget, borderProfile, flags, wid);
+        cairo_destroy(scr);
+        BevelCache::insert(key, surface);
+    }
+    if (sliced) {
+        if (horiz) {
+            width = length;
+        } else {
+            height = length;
+        }
+    }
+    paintBevelSurface(cr, area, surface, x, y, width, height, horiz, sliced);
+}
+
 void
 drawFadedLine(cairo_t *cr, int x, int y, int width, int height,
               const GdkColor *col, const QtcRect *area, const QtcRect *gap,
@@ -1152,6 +1360,47 @@ drawStripedBgnd(cairo_t *cr, int x, int y, int w, int h,
     cairo_pattern_destroy(pat);
 }
 
+// The background of a toplevel of size w x h at x, y, the color and the
+// opacity are those of drawWindowBgnd.
+static void
+drawToplevelBgnd(cairo_t *cr, const QtcRect *area, int x, int y, int w, int h,
+                 const GdkColor *col, double alpha)
+{
+    if (opts.bgndAppearance == APPEARANCE_STRIPED) {
+        drawStripedBgnd(cr, x, y, w, h, col, alpha);
+    } else if (opts.bgndAppearance == APPEARANCE_FILE) {
+        Cairo::Saver saver(cr);
+        cairo_translate(cr, x, y);
+        drawBgndImage(cr, 0, 0, w, h, true);
+    } else {
+        drawBevelGradient(cr, area, x, y, w, h + 1, col,
+                          opts.bgndGrad == GT_HORIZ, false,
+                          opts.bgndAppearance, WIDGET_OTHER, alpha);
+        if (opts.bgndGrad == GT_HORIZ &&
+            qtcGetGradient(opts.bgndAppearance, &opts)->border == GB_SHINE) {
+            int size = qtcMin(BGND_SHINE_SIZE, qtcMin(h * 2, w));
+            double alpha = qtcShineAlpha(col);
+            cairo_pattern_t *pat = nullptr;
+
+            size /= BGND_SHINE_STEPS;
+            size *= BGND_SHINE_STEPS;
+            pat = cairo_pattern_create_radial(x + w / 2.0, y, 0,
+                                              x + w / 2.0, y, size / 2.0);
+            cairo_pattern_add_color_stop_rgba(pat, 0, 1, 1, 1, alpha);
+            cairo_pattern_add_color_stop_rgba(pat, 0.5, 1, 1, 1,
+                                              alpha * 0.625);
+            cairo_pattern_add_color_stop_rgba(pat, 0.75, 1, 1, 1,
+                                              alpha * 0.175);
+            cairo_pattern_add_color_stop_rgba(pat, CAIRO_GRAD_END,
+                                              1, 1, 1, 0.0);
+            cairo_set_source(cr, pat);
+            cairo_rectangle(cr, x + (w - size) / 2.0, y, size, size);
+            cairo_fill(cr);
+            cairo_pattern_destroy(pat);
+        }
+    }
+}
+
 bool
 drawWindowBgnd(cairo_t *cr, GtkStyle *style, const QtcRect *area,
                GdkWindow *window, GtkWidget *widget, int x, int y,
@@ -1220,38 +1469,41 @@ drawWindowBgnd(cairo_t *cr, GtkStyle *style, const QtcRect *area,
         }
         if (flatBgnd) {
             Cairo::rect(cr, area, -wx, -wy, ww, wh, col, alpha);
-        } else if (opts.bgndAppearance == APPEARANCE_STRIPED) {
-            drawStripedBgnd(cr, -wx, -wy, ww, wh, col, alpha);
-        } else if (opts.bgndAppearance == APPEARANCE_FILE) {
-            Cairo::Saver saver(cr);
-            cairo_translate(cr, -wx, -wy);
-            drawBgndImage(cr, 0, 0, ww, wh, true);
         } else {
-            drawBevelGradient(cr, area, -wx, -wy, ww, wh + 1, col,
-                              opts.bgndGrad == GT_HORIZ, false,
-                              opts.bgndAppearance, WIDGET_OTHER, alpha);
-            if (opts.bgndGrad == GT_HORIZ &&
-                qtcGetGradient(opts.bgndAppearance,
-                               &opts)->border == GB_SHINE) {
-                int size = qtcMin(BGND_SHINE_SIZE, qtcMin(wh * 2, ww));
-                double alpha = qtcShineAlpha(col);
-                cairo_pattern_t *pat = nullptr;
-
-                size /= BGND_SHINE_STEPS;
-                size *= BGND_SHINE_STEPS;
-                pat = cairo_pattern_create_radial(
-                    ww / 2.0 - wx, -wy, 0, ww / 2.0 - wx, -wy, size / 2.0);
-                cairo_pattern_add_color_stop_rgba(pat, 0, 1, 1, 1, alpha);
-                cairo_pattern_add_color_stop_rgba(pat, 0.5, 1, 1, 1,
-                                                  alpha * 0.625);
-                cairo_pattern_add_color_stop_rgba(pat, 0.75, 1, 1, 1,
-                                                  alpha * 0.175);
-                cairo_pattern_add_color_stop_rgba(pat, CAIRO_GRAD_END,
-                                                  1, 1, 1, 0.0);
-                cairo_set_source(cr, pat);
-                cairo_rectangle(cr, (ww - size) / 2.0 - wx, -wy, size, size);
+            // Composed once for the whole toplevel, every child that asks
+            // for a background then only copies its part of it.
+            const Window::BgndKey key = {ww, wh, col->red, col->green,
+                                         col->blue, useAlpha ? opacity : 100};
+            bool cacheable = false;
+            cairo_surface_t *bgnd = Window::cachedBgnd(topLevel, key,
+                                                       &cacheable);
+            bool created = false;
+            if (!bgnd && cacheable) {
+                bgnd = cairo_surface_create_similar(
+                    cairo_get_target(cr), CAIRO_CONTENT_COLOR_ALPHA,
+                    ww, wh + 1);
+                if (cairo_surface_status(bgnd) == CAIRO_STATUS_SUCCESS) {
+                    cairo_t *bcr = cairo_create(bgnd);
+                    cairo_set_operator(bcr, cairo_get_operator(cr));
+                    drawToplevelBgnd(bcr, nullptr, 0, 0, ww, wh, col, alpha);
+                    cairo_destroy(bcr);
+                    created = true;
+                } else {
+                    cairo_surface_destroy(bgnd);
+                    bgnd = nullptr;
+                }
+            }
+            if (bgnd) {
+                Cairo::Saver saver(cr);
+                Cairo::clipRect(cr, area);
+                cairo_set_source_surface(cr, bgnd, -wx, -wy);
+                cairo_rectangle(cr, -wx, -wy, ww, wh + 1);
                 cairo_fill(cr);
-                cairo_pattern_destroy(pat);
+            } else {
+                drawToplevelBgnd(cr, area, -wx, -wy, ww, wh, col, alpha);
+            }
+            if (created) {
+                Window::setCachedBgnd(topLevel, key, bgnd);
             }
         }
         if (useAlpha) {
@@ -1691,7 +1943,7 @@ drawProgressGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
 
 void
 drawSliderGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
-                 GtkWidget *widget, const char *detail,
+                 GtkWidget *widget, Detail detail, const char *name,
                  const QtcRect *area, int x, int y, int width, int height,
                  bool horiz)
 {
@@ -1735,7 +1987,8 @@ drawSliderGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
 
     if (state == GTK_STATE_INSENSITIVE) {
         bgndcol = &bgndcols[ORIGINAL_SHADE];
-    } else if (oneOf(detail, "trough-lower") && opts.fillSlider) {
+    } else if (detail == Detail::TroughPart &&
+               Str::endsWith(name, "-lower") && opts.fillSlider) {
         bgndcols = usedcols;
         bgndcol = &usedcols[ORIGINAL_SHADE];
         wid = WIDGET_FILLED_SLIDER_TROUGH;
@@ -1746,7 +1999,7 @@ drawSliderGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
                    DF_SUNKEN | DF_DO_BORDER | (horiz ? 0 : DF_VERT), nullptr);
 
     if (opts.fillSlider && upper != lower &&
-        state != GTK_STATE_INSENSITIVE && oneOf(detail, "trough")) {
+        state != GTK_STATE_INSENSITIVE && detail == Detail::Trough) {
         if (horiz) {
             pos += width > 10 && pos < width / 2 ? 3 : 0;
 
@@ -1777,7 +2030,7 @@ drawSliderGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
 
 void
 drawTriangularSlider(cairo_t *cr, GtkStyle *style, GtkStateType state,
-                     const char *detail, int x, int y, int width, int height)
+                     Detail detail, int x, int y, int width, int height)
 {
     GdkColor newColors[TOTAL_SHADES + 1];
     const GdkColor *btnColors = nullptr;
@@ -1801,7 +2054,7 @@ drawTriangularSlider(cairo_t *cr, GtkStyle *style, GtkStateType state,
     bool coloredMouseOver = (state == GTK_STATE_PRELIGHT &&
                              opts.coloredMouseOver &&
                              !opts.colorSliderMouseOver);
-    bool horiz = height > width || oneOf(detail, "hscale");
+    bool horiz = height > width || detail == Detail::HScale;
     int bgnd = getFill(state, false, opts.shadeSliders == SHADE_DARKEN);
     int xo = horiz ? 8 : 0;
     int yo = horiz ? 0 : 8;
@@ -3235,14 +3488,14 @@ drawShadowGap(cairo_t *cr, GtkStyle *style, GtkShadowType shadow,
 
 void
 drawCheckBox(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
-             GtkStyle *style, GtkWidget *widget, const char *detail,
+             GtkStyle *style, GtkWidget *widget, Detail detail,
              const QtcRect *area, int x, int y, int width, int height)
 {
     if (state == GTK_STATE_PRELIGHT &&
         oneOf(qtSettings.app, GTK_APP_MOZILLA, GTK_APP_JAVA)) {
         state = GTK_STATE_NORMAL;
     }
-    bool mnu = oneOf(detail, "check");
+    bool mnu = detail == Detail::Check;
     bool list = !mnu && isList(widget);
     bool on = shadow == GTK_SHADOW_IN;
     bool tri = shadow == GTK_SHADOW_ETCHED_IN;
@@ -3265,9 +3518,8 @@ drawCheckBox(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
     x += (width - checkSpace) / 2;
     y += (height - checkSpace) / 2;
     if (qtSettings.debug == DEBUG_ALL) {
-        printf(DEBUG_PREFIX "%s %d %d %d %d %d %d %d %s  ",
-               __FUNCTION__, state, shadow, x, y, width, height, mnu,
-               detail ? detail : "nullptr");
+        printf(DEBUG_PREFIX "%s %d %d %d %d %d %d %d  ",
+               __FUNCTION__, state, shadow, x, y, width, height, mnu);
         debugDisplayWidget(widget, 10);
     }
     if ((mnu && state == GTK_STATE_PRELIGHT) ||
@@ -3377,14 +3629,14 @@ drawCheckBox(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
 
 void
 drawRadioButton(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
-                GtkStyle *style, GtkWidget *widget, const char *detail,
+                GtkStyle *style, GtkWidget *widget, Detail detail,
                 const QtcRect *area, int x, int y, int width, int height)
 {
     if (state == GTK_STATE_PRELIGHT &&
         oneOf(qtSettings.app, GTK_APP_MOZILLA, GTK_APP_JAVA)) {
         state = GTK_STATE_NORMAL;
     }
-    bool mnu = oneOf(detail, "option");
+    bool mnu = detail == Detail::Option;
     bool list = !mnu && isList(widget);
     if ((mnu && state == GTK_STATE_PRELIGHT) ||
         (list && state == GTK_STATE_ACTIVE)) {
@@ -3392,7 +3644,7 @@ drawRadioButton(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
     }
 
     if (!qtSettings.qt4 && mnu) {
-        drawCheckBox(cr, state, shadow, style, widget, "check", area,
+        drawCheckBox(cr, state, shadow, style, widget, Detail::Check, area,
                      x, y, width, height);
     } else {
         bool on = shadow == GTK_SHADOW_IN;
@@ -3872,7 +4124,7 @@ drawTab(cairo_t *cr, GtkStateType state, GtkStyle *style, GtkWidget *widget,
 
 void
 drawToolbarBorders(cairo_t *cr, GtkStateType state, int x, int y, int width,
-                   int height, bool isActiveWindowMenubar, const char *detail)
+                   int height, bool isActiveWindowMenubar, Detail detail)
 {
     bool top = false;
     bool bottom = false;
@@ -3885,13 +4137,13 @@ drawToolbarBorders(cairo_t *cr, GtkStateType state, int x, int y, int width,
                              opts.shadeMenubars != SHADE_NONE) ?
                             menuColors(isActiveWindowMenubar) :
                             qtcPalette.background);
-    if (oneOf(detail, "menubar")) {
+    if (detail == Detail::MenuBar) {
         if (all) {
             top = bottom = left = right = true;
         } else {
             bottom = true;
         }
-    } else if (oneOf(detail, "toolbar")) {
+    } else if (detail == Detail::Toolbar) {
         if (all) {
             if (width < height) {
                 left = right = bottom = true;
@@ -3905,7 +4157,7 @@ drawToolbarBorders(cairo_t *cr, GtkStateType state, int x, int y, int width,
                 top = bottom = true;
             }
         }
-    } else if (oneOf(detail,"dockitem_bin", "handlebox_bin")) {
+    } else if (oneOf(detail, Detail::DockItemBin, Detail::HandleBoxBin)) {
         /* CPD: bit risky - what if only 1 item ??? */
         if (all) {
             if (width < height) {
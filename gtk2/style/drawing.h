@@ -23,6 +23,8 @@
 #ifndef __QTC_DRAWING_H__
 #define __QTC_DRAWING_H__
 
+#include "detail.h"
+
 #include <common/common.h>
 #include <qtcurve-cairo/draw.h>
 
@@ -107,12 +109,11 @@ void drawProgressGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
                         const QtcRect *area, int x, int y, int width,
                         int height, bool isList, bool horiz);
 void drawSliderGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
-                      GtkWidget *widget, const char *detail,
+                      GtkWidget *widget, Detail detail, const char *name,
                       const QtcRect *area, int x, int y, int width, int height,
                       bool horiz);
 void drawTriangularSlider(cairo_t *cr, GtkStyle *style, GtkStateType state,
-                          const char *detail, int x, int y,
-                          int width, int height);
+                          Detail detail, int x, int y, int width, int height);
 void drawScrollbarGroove(cairo_t *cr, GtkStyle *style, GtkStateType state,
                          GtkWidget *widget, const QtcRect *area, int x, int y,
                          int width, int height, bool horiz);
@@ -158,17 +159,17 @@ void drawShadowGap(cairo_t *cr, GtkStyle *style, GtkShadowType shadow,
                    int x, int y, int width, int height,
                    GtkPositionType gapSide, int gapX, int gapWidth);
 void drawCheckBox(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
-                  GtkStyle *style, GtkWidget *widget, const char *detail,
+                  GtkStyle *style, GtkWidget *widget, Detail detail,
                   const QtcRect *area, int x, int y, int width, int height);
 void drawTab(cairo_t *cr, GtkStateType state, GtkStyle *style,
              GtkWidget *widget, QtcRect *area, int x, int y,
              int width, int height, GtkPositionType gapSide);
 void drawRadioButton(cairo_t *cr, GtkStateType state, GtkShadowType shadow,
-                     GtkStyle *style, GtkWidget *widget, const char *detail,
+                     GtkStyle *style, GtkWidget *widget, Detail detail,
                      const QtcRect *area, int x, int y, int width, int height);
 void drawToolbarBorders(cairo_t *cr, GtkStateType state, int x, int y,
                         int width, int height, bool isActiveWindowMenubar,
-                        const char *detail);
+                        Detail detail);
 void drawListViewHeader(cairo_t *cr, GtkStateType state,
                         const GdkColor *btnColors, int bgnd,
                         const QtcRect *area, int x, int y,
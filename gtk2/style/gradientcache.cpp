@@ -0,0 +1,100 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "gradientcache.h"
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include <stddef.h>
+
+namespace QtCurve {
+namespace GradientCache {
+
+struct KeyHash {
+    size_t
+    operator()(const GradientKey &key) const
+    {
+        return (std::hash<int>()(key.red) ^
+                (std::hash<int>()(key.green) << 1) ^
+                (std::hash<int>()(key.blue) << 2) ^
+                (std::hash<int>()(key.app | key.flags << 8) << 3) ^
+                (std::hash<int>()(key.length) << 4) ^
+                (std::hash<double>()(key.alpha) << 5));
+    }
+};
+
+struct Entry {
+    GradientKey key;
+    cairo_pattern_t *pattern;
+};
+
+// Enough for the gradients of all the widgets of a few windows, each pattern
+// is only a few stops.
+static const size_t constMaxEntries = 256;
+
+// Most recently used first.
+static std::list<Entry> entries;
+static std::unordered_map<GradientKey, std::list<Entry>::iterator,
+                          KeyHash> entryMap;
+
+cairo_pattern_t*
+find(const GradientKey &key)
+{
+    auto it = entryMap.find(key);
+    if (it == entryMap.end()) {
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->pattern;
+}
+
+void
+insert(const GradientKey &key, cairo_pattern_t *pattern)
+{
+    entries.push_front(Entry{key, pattern});
+    auto res = entryMap.insert({key, entries.begin()});
+    if (!res.second) {
+        cairo_pattern_destroy(res.first->second->pattern);
+        entries.erase(res.first->second);
+        res.first->second = entries.begin();
+    }
+    if (entries.size() > constMaxEntries) {
+        const Entry &last = entries.back();
+        entryMap.erase(last.key);
+        cairo_pattern_destroy(last.pattern);
+        entries.pop_back();
+    }
+}
+
+void
+clear()
+{
+    for (const Entry &entry: entries) {
+        cairo_pattern_destroy(entry.pattern);
+    }
+    entries.clear();
+    entryMap.clear();
+}
+
+}
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTC_GRADIENTCACHE_H__
+#define __QTC_GRADIENTCACHE_H__
+
+#include <cairo.h>
+#include <stdint.h>
+
+namespace QtCurve {
+
+/**
+ * Everything a bevel gradient pattern depends on besides the options, the
+ * pattern starts at the origin and is moved into place by its matrix.
+ */
+struct GradientKey {
+    enum {
+        Horiz = 1 << 0,
+        TopTab = 1 << 1,
+        BotTab = 1 << 2,
+        // Stop alphas are ignored (tooltips and list view headers)
+        OpaqueStops = 1 << 3,
+        // Last stop is transparent (selected tab without tab background)
+        ClearEnd = 1 << 4,
+    };
+    uint16_t red;
+    uint16_t green;
+    uint16_t blue;
+    uint8_t app;
+    uint8_t flags;
+    int length;
+    double alpha;
+    bool
+    operator==(const GradientKey &other) const
+    {
+        return (red == other.red && green == other.green &&
+                blue == other.blue && app == other.app &&
+                flags == other.flags && length == other.length &&
+                alpha == other.alpha);
+    }
+};
+
+namespace GradientCache {
+
+// Returns a pattern owned by the cache (valid until the next insert() or
+// clear()) and marks it as recently used.
+cairo_pattern_t *find(const GradientKey &key);
+// Takes ownership of the pattern, the least recently used one is dropped
+// once the cache is full.
+void insert(const GradientKey &key, cairo_pattern_t *pattern);
+// The patterns depend on the options, drop them when those are (re)loaded.
+void clear();
+
+}
+}
+
+#endif
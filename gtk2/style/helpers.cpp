@@ -29,6 +29,7 @@
 #include <qtcurve-utils/strs.h>
 
 #include "qt_settings.h"
+#include "bevelcache.h"
 #include <gdk/gdkx.h>
 
 namespace QtCurve {
@@ -83,14 +84,28 @@ shadowToBorder(GtkShadowType shadow)
 }
 
 bool
-useButtonColor(const char *detail)
-{
-    return (detail &&
-            (oneOf(detail, "optionmenu", "button", "buttondefault",
-                   "togglebuttondefault", "togglebutton", "hscale", "vscale",
-                   "spinbutton", "spinbutton_up", "spinbutton_down", "slider",
-                   "qtc-slider", "stepper") ||
-             (detail[0] && Str::startsWith(detail + 1, "scrollbar"))));
+useButtonColor(Detail detail)
+{
+    switch (detail) {
+    case Detail::OptionMenu:
+    case Detail::Button:
+    case Detail::ButtonDefault:
+    case Detail::ToggleButtonDefault:
+    case Detail::ToggleButton:
+    case Detail::HScale:
+    case Detail::VScale:
+    case Detail::SpinButton:
+    case Detail::SpinButtonUp:
+    case Detail::SpinButtonDown:
+    case Detail::Slider:
+    case Detail::QtcSlider:
+    case Detail::Stepper:
+    case Detail::HScrollbar:
+    case Detail::VScrollbar:
+        return true;
+    default:
+        return false;
+    }
 }
 
 void
@@ -302,11 +317,11 @@ isListViewHeader(GtkWidget *widget)
 }
 
 bool
-isEvolutionListViewHeader(GtkWidget *widget, const char *detail)
+isEvolutionListViewHeader(GtkWidget *widget, Detail detail)
 {
     GtkWidget *parent = nullptr;
     return ((qtSettings.app == GTK_APP_EVOLUTION) && widget &&
-            oneOf(detail, "button") &&
+            detail == Detail::Button &&
             oneOf(gTypeName(widget), "ECanvas") &&
             (parent = gtk_widget_get_parent(widget)) &&
             (parent = gtk_widget_get_parent(parent)) &&
@@ -700,54 +715,56 @@ getFill(GtkStateType state, bool set, bool darker)
 }
 
 bool
-isSbarDetail(const char *detail)
+isSbarDetail(Detail detail)
 {
-    return (detail && detail[0] && (oneOf(detail, "stepper") ||
-                                    Str::startsWith(detail + 1, "scrollbar")));
+    return oneOf(detail, Detail::Stepper, Detail::HScrollbar,
+                 Detail::VScrollbar);
 }
 
 ECornerBits
-getRound(const char *detail, GtkWidget *widget, bool rev)
+getRound(Detail detail, const char *name, GtkWidget *widget, bool rev)
 {
-    if (detail) {
-        if (oneOf(detail, "slider")) {
+    switch (detail) {
+    case Detail::Slider:
 #ifndef SIMPLE_SCROLLBARS
-            if (!(opts.square & SQUARE_SB_SLIDER) &&
-                (opts.scrollbarType == SCROLLBAR_NONE ||
-                 opts.flatSbarButtons)) {
-                return ROUNDED_ALL;
-            }
+        if (!(opts.square & SQUARE_SB_SLIDER) &&
+            (opts.scrollbarType == SCROLLBAR_NONE || opts.flatSbarButtons)) {
+            return ROUNDED_ALL;
+        }
 #endif
+        return ROUNDED_NONE;
+    case Detail::QtcSlider:
+        return opts.square&SQUARE_SLIDER && (SLIDER_PLAIN == opts.sliderStyle || SLIDER_PLAIN_ROTATED == opts.sliderStyle)
+            ? ROUNDED_NONE : ROUNDED_ALL;
+    case Detail::Splitter:
+    case Detail::OptionMenu:
+    case Detail::ToggleButton:
+    case Detail::HScale:
+    case Detail::VScale:
+        return ROUNDED_ALL;
+    case Detail::SpinButtonUp:
+        return rev ? ROUNDED_TOPLEFT : ROUNDED_TOPRIGHT;
+    case Detail::SpinButtonDown:
+        return rev ? ROUNDED_BOTTOMLEFT : ROUNDED_BOTTOMRIGHT;
+    case Detail::HScrollbar:
+    case Detail::VScrollbar:
+        // Requires `GtkRange::stepper-position-details = 1`
+        if (Str::endsWith(name, "_start")) {
+            return detail == Detail::HScrollbar ? ROUNDED_LEFT : ROUNDED_TOP;
+        } else if (Str::endsWith(name, "_end")) {
+            return detail == Detail::VScrollbar ? ROUNDED_BOTTOM : ROUNDED_RIGHT;
+        }
+        return ROUNDED_NONE;
+    case Detail::Button:
+        if(isListViewHeader(widget))
             return ROUNDED_NONE;
-        } else if (oneOf(detail, "qtc-slider")) {
-            return opts.square&SQUARE_SLIDER && (SLIDER_PLAIN == opts.sliderStyle || SLIDER_PLAIN_ROTATED == opts.sliderStyle)
-                ? ROUNDED_NONE : ROUNDED_ALL;
-        } else if (oneOf(detail, "splitter", "optionmenu", "togglebutton",
-                         "hscale", "vscale")) {
+        else if(isComboBoxButton(widget))
+            return rev ? ROUNDED_LEFT : ROUNDED_RIGHT;
+        else
             return ROUNDED_ALL;
-        } else if (oneOf(detail, "spinbutton_up"))
-            return rev ? ROUNDED_TOPLEFT : ROUNDED_TOPRIGHT;
-        else if(oneOf(detail, "spinbutton_down"))
-            return rev ? ROUNDED_BOTTOMLEFT : ROUNDED_BOTTOMRIGHT;
-        else if (isSbarDetail(detail)) {
-            // Requires `GtkRange::stepper-position-details = 1`
-            if (Str::endsWith(detail, "_start")) {
-                return detail[0] == 'h' ? ROUNDED_LEFT : ROUNDED_TOP;
-            } else if (Str::endsWith(detail, "_end")) {
-                return detail[0] == 'v' ? ROUNDED_BOTTOM : ROUNDED_RIGHT;
-            }
-            return ROUNDED_NONE;
-        } else if (oneOf(detail, "button")) {
-            if(isListViewHeader(widget))
-                return ROUNDED_NONE;
-            else if(isComboBoxButton(widget))
-                return rev ? ROUNDED_LEFT : ROUNDED_RIGHT;
-            else
-                return ROUNDED_ALL;
-        }
+    default:
+        return ROUNDED_NONE;
     }
-
-    return ROUNDED_NONE;
 }
 
 bool
@@ -1206,6 +1223,8 @@ treeViewPathParent(GtkTreeView*, GtkTreePath *path)
 void
 generateColors()
 {
+    // The cached bevels tell the palettes apart by their address.
+    BevelCache::clear();
     shadeColors(&qtSettings.colors[PAL_ACTIVE][COLOR_WINDOW],
                 qtcPalette.background);
     shadeColors(&qtSettings.colors[PAL_ACTIVE][COLOR_BUTTON],
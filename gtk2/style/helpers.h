@@ -25,6 +25,7 @@
 
 #include "config.h"
 #include "qt_settings.h"
+#include "detail.h"
 #include <common/common.h>
 #include <qtcurve-cairo/utils.h>
 
@@ -102,7 +103,7 @@ isFakeGtk()
 }
 GdkColor *menuColors(bool active);
 EBorder shadowToBorder(GtkShadowType shadow);
-bool useButtonColor(const char *detail);
+bool useButtonColor(Detail detail);
 void shadeColors(const GdkColor *base, GdkColor *vals);
 bool isSortColumn(GtkWidget *button);
 GdkColor *getCellCol(GdkColor *std, const char *detail);
@@ -114,7 +115,7 @@ bool isButtonOnHandlebox(GtkWidget *widget, bool *horiz);
 bool isOnStatusBar(GtkWidget *widget, int level);
 bool isList(GtkWidget *widget);
 bool isListViewHeader(GtkWidget *widget);
-bool isEvolutionListViewHeader(GtkWidget *widget, const char *detail);
+bool isEvolutionListViewHeader(GtkWidget *widget, Detail detail);
 bool isOnListViewHeader(GtkWidget *w, int level);
 bool isPathButton(GtkWidget *widget);
 GtkWidget *getComboEntry(GtkWidget *widget);
@@ -164,7 +165,7 @@ void sanitizeSize(GdkWindow *window, int *width, int *height);
 EStepper getStepper(GtkWidget *widget, int x, int y, int width, int height);
 
 int getFill(GtkStateType state, bool set, bool darker=false);
-bool isSbarDetail(const char *detail);
+bool isSbarDetail(Detail detail);
 bool isHorizontalProgressbar(GtkWidget *widget);
 bool isComboBoxPopupWindow(GtkWidget *widget, int level);
 bool isComboBoxList(GtkWidget *widget);
@@ -188,7 +189,8 @@ void enableBlurBehind(GtkWidget *w, bool enable);
 void getTopLevelSize(GdkWindow *window, int *w, int *h);
 void getTopLevelOrigin(GdkWindow *window, int *x, int *y);
 bool mapToTopLevel(GdkWindow *window, GtkWidget *widget, int *x, int *y, int *w, int *h); //, bool frame)
-ECornerBits getRound(const char *detail, GtkWidget *widget, bool rev);
+ECornerBits getRound(Detail detail, const char *name, GtkWidget *widget,
+                     bool rev);
 
 bool treeViewCellHasChildren(GtkTreeView *treeView, GtkTreePath *path);
 bool treeViewCellIsLast(GtkTreeView *treeView, GtkTreePath *path);
@@ -27,6 +27,7 @@
 #include "qt_settings.h"
 
 #include <qtcurve-utils/gtkutils.h>
+#include <qtcurve-utils/shm_cache.h>
 
 #include <unordered_map>
 
@@ -85,6 +86,80 @@ pixbufCacheValueNew(const PixKey &key)
     return res;
 }
 
+// The keys hold every input of the shared images, the options they depend
+// on and the palette select the segment all the same so that processes with
+// another look do not share anything.
+static uint64_t
+sharedCacheConfig()
+{
+    const int values[] = {opts.xCheck, opts.crButton, opts.smallRadio,
+                          opts.shadeCheckRadio, opts.crColor,
+                          opts.customCheckRadioColor.red,
+                          opts.customCheckRadioColor.green,
+                          opts.customCheckRadioColor.blue};
+    uint64_t res = SharedCache::hash(values, sizeof(values));
+    res = SharedCache::hash(opts.customShades, sizeof(opts.customShades), res);
+    for (const auto &pal: qtSettings.colors) {
+        for (const GdkColor &col: pal) {
+            const uint16_t rgb[] = {col.red, col.green, col.blue};
+            res = SharedCache::hash(rgb, sizeof(rgb), res);
+        }
+    }
+    return res;
+}
+
+// Only set when QTCURVE_SHARED_CACHE is enabled. Never freed, pixbufs
+// created by sharedPixbuf() point into it.
+static SharedCache*
+sharedCache()
+{
+    static SharedCache *cache = [] () -> SharedCache* {
+        if (!SharedCache::enabled()) {
+            return nullptr;
+        }
+        SharedCache *res = new SharedCache("gtk2-pixbufs",
+                                           sharedCacheConfig());
+        if (!res->isValid()) {
+            delete res;
+            return nullptr;
+        }
+        return res;
+    }();
+    return cache;
+}
+
+// Look up the check pixbuf in (or add it to) the cache shared with the
+// other processes. The returned pixbuf uses the shared memory in place.
+static GdkPixbuf*
+sharedPixbuf(const PixKey &key)
+{
+    SharedCache *cache = sharedCache();
+    if (!cache) {
+        return pixbufCacheValueNew(key);
+    }
+    const struct {
+        uint16_t red, green, blue, xCheck;
+        double shade;
+    } sharedKey = {key.col.red, key.col.green, key.col.blue,
+                   uint16_t(opts.xCheck), key.shade};
+    SharedCache::Image img;
+    if (!cache->find(&sharedKey, sizeof(sharedKey), &img)) {
+        GdkPixbuf *res = pixbufCacheValueNew(key);
+        if (gdk_pixbuf_get_n_channels(res) != 4 ||
+            !cache->insert(&sharedKey, sizeof(sharedKey),
+                           {gdk_pixbuf_get_pixels(res),
+                            gdk_pixbuf_get_width(res),
+                            gdk_pixbuf_get_height(res),
+                            gdk_pixbuf_get_rowstride(res)}, &img)) {
+            return res;
+        }
+        g_object_unref(res);
+    }
+    return gdk_pixbuf_new_from_data(const_cast<guchar*>(img.data),
+                                    GDK_COLORSPACE_RGB, true, 8, img.width,
+                                    img.height, img.stride, nullptr, nullptr);
+}
+
 GdkPixbuf*
 getPixbuf(GdkColor *widgetColor, EPixmap p, double shade)
 {
@@ -94,7 +169,7 @@ getPixbuf(GdkColor *widgetColor, EPixmap p, double shade)
     const PixKey key = {*widgetColor, shade};
     auto &pixbuf = pixbufMap[key];
     if (pixbuf.get() == nullptr) {
-        pixbuf = pixbufCacheValueNew(key);
+        pixbuf = sharedPixbuf(key);
     }
     return pixbuf.get();
 }
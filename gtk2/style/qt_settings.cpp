@@ -28,10 +28,13 @@
 #include <qtcurve-utils/log.h>
 #include <qtcurve-utils/dirs.h>
 #include <qtcurve-utils/strs.h>
-#include <qtcurve-utils/process.h>
+#include <qtcurve-utils/ini.h>
+#include <qtcurve-utils/map.h>
 
 #include <common/config_file.h>
 #include "helpers.h"
+#include "gradientcache.h"
+#include "bevelcache.h"
 #include <dirent.h>
 #include <locale.h>
 #include <gmodule.h>
@@ -51,34 +54,11 @@ Options opts;
 #define qtc_gtkrc_printf(str_buff, args...)     \
     gtk_rc_parse_string(str_buff.printf(args))
 
-static char*
-getKdeHome()
-{
-    static uniqueStr dir = [] {
-        size_t len = 0;
-        const char *const args[] = {"kde4-config", "--localprefix", nullptr};
-        char *res = qtcPopenStdout("kde4-config", args, 300, &len);
-        if (res && res[strspn(res, " \t\b\n\f\v")]) {
-            if (res[len - 1] == '\n') {
-                res[len - 1] = '\0';
-            }
-            return res;
-        }
-        if ((res = getenv(getuid() ? "KDEHOME" : "KDEROOTHOME"))) {
-            return strdup(res);
-        }
-        // according to kdecore/kernel/kstandarddirs.h, ~/.kde is the default for KDEHOME
-        // distributions using the default should not have to patch this code.
-        return Str::cat(getHome(), ".kde");
-    };
-    return dir.get();
-}
-
 static const char*
 kdeFile(const char *f)
 {
     static Str::Buff<1024> buff;
-    return buff.cat(getKdeHome(), KDE_CFG_DIR, f);
+    return buff.cat(getKDE4LocalPrefix(), KDE_CFG_DIR, f);
 }
 
 static const char*
@@ -312,31 +292,59 @@ typedef enum
     EFF_INACTIVE
 } Effect;
 
-static ColorType getColorType(const char *line)
+typedef enum {
+    KEY_UNKNOWN = -1,
+    KEY_THEME,
+    KEY_SIZE,
+    KEY_TOOL_BUTTON_STYLE,
+    KEY_SHOW_ICONS_ON_PUSH_BUTTONS,
+    KEY_START_DRAG_TIME,
+    KEY_ACTIVE_BACKGROUND,
+    KEY_ACTIVE_FOREGROUND,
+    KEY_INACTIVE_BACKGROUND,
+    KEY_INACTIVE_FOREGROUND,
+    KEY_FONT,
+    KEY_MENU_FONT,
+    KEY_TOOLBAR_FONT,
+    KEY_CONTRAST,
+    KEY_WIDGET_STYLE,
+    KEY_SHADE_SORT_COLUMN,
+    // [ColorEffects:*]
+    KEY_COLOR,
+    KEY_COLOR_AMOUNT,
+    KEY_COLOR_EFFECT,
+    KEY_CONTRAST_AMOUNT,
+    KEY_CONTRAST_EFFECT,
+    KEY_INTENSITY_AMOUNT,
+    KEY_INTENSITY_EFFECT,
+    KEY_ENABLE,
+    KEY_CHANGE_SELECTION_COLOR
+} KdeKey;
+
+static ColorType
+getColorType(const StrView &key)
 {
-    if(0==strncasecmp(line, "BackgroundAlternate=", 20))
-        return BackgroundAlternate;
-    if(0==strncasecmp(line, "BackgroundNormal=", 17))
-        return BackgroundNormal;
-    if(0==strncasecmp(line, "ForegroundNormal=", 17))
-        return ForegroundNormal;
-    if(0==strncasecmp(line, "DecorationFocus=", 16))
-        return DecorationFocus;
-    if(0==strncasecmp(line, "DecorationHover=", 16))
-        return DecorationHover;
-    return UnknownColor;
+    static const StrMap<ColorType, false> map{
+        {"BackgroundAlternate", BackgroundAlternate},
+        {"BackgroundNormal", BackgroundNormal},
+        {"ForegroundNormal", ForegroundNormal},
+        {"DecorationFocus", DecorationFocus},
+        {"DecorationHover", DecorationHover},
+    };
+    return map.search(key.str, key.len, UnknownColor);
 }
 
-static GdkColor readColor(const char *line)
+static GdkColor
+readColor(const StrView &value)
 {
-    const char *eq = strchr(line, '=');
+    char buff[64];
     GdkColor col;
     int red;
     int green;
     int blue;
 
-    if (eq && ++eq && *eq != '\0' &&
-        sscanf(eq, "%d,%d,%d", &red, &green, &blue) == 3) {
+    if (sscanf(value.copy(buff, sizeof(buff)), "%d,%d,%d",
+               &red, &green, &blue) == 3) {
         col.red = toGtkColor(red);
         col.green = toGtkColor(green);
         col.blue = toGtkColor(blue);
@@ -346,20 +354,38 @@ static GdkColor readColor(const char *line)
     return col;
 }
 
-static int readInt(const char *line, int offset)
+static int
+readInt(const StrView &value)
 {
-    return line[offset]!='\0' ? atoi(&line[offset]) : 0;
+    char buff[32];
+    return atoi(value.copy(buff, sizeof(buff)));
 }
 
-static double readDouble(const char *line, int offset)
+static double
+readDouble(const StrView &value)
 {
-    return line[offset]!='\0' ? g_ascii_strtod(&line[offset], nullptr) : 0;
+    char buff[32];
+    return g_ascii_strtod(value.copy(buff, sizeof(buff)), nullptr);
 }
 
 static bool
-readBool(const char *line, int offset)
+readBool(const StrView &value)
 {
-    return line[offset]!='\0' ? 0==strncasecmp(&line[offset], "true", 4) : false;
+    return value.len >= 4 && strncasecmp(value.str, "true", 4) == 0;
+}
+
+static bool
+startsWith(const StrView &value, const char *prefix)
+{
+    size_t len = strlen(prefix);
+    return value.len >= len && strncasecmp(value.str, prefix, len) == 0;
+}
+
+static char*
+dupValue(char *old, const StrView &value)
+{
+    char *res = (char*)realloc(old, value.len + 1);
+    return value.copy(res, value.len + 1);
 }
 
 typedef struct
@@ -385,16 +411,14 @@ static void initFont(QtFontDetails *f, bool setFamily)
 }
 
 static void
-parseFontLine(const char *line, QtFontDetails *font)
+parseFontLine(const StrView &value, QtFontDetails *font)
 {
-    int n = -1;
-    char *l;
-    char fontLine[MAX_CONFIG_INPUT_LINE_LEN+1];
+    int n = 0;
+    char fontLine[MAX_CONFIG_INPUT_LINE_LEN + 1];
     QtFontDetails rc;
 
     initFont(&rc, false);
-    memcpy(fontLine, line, MAX_CONFIG_INPUT_LINE_LEN + 1);
-    l = strtok(fontLine, "=");
+    char *l = strtok(value.copy(fontLine, sizeof(fontLine)), ",");
 
     while (l) {
         switch (n) {
@@ -494,30 +518,29 @@ GdkColor mixColors(const GdkColor *c1, const GdkColor *c2, double bias)
     return col;
 }
 
-static void readKwinrc()
+static void
+readKwinrc()
 {
-    if (FILE *f = fopen(kwinrc(), "r")) {
-        int  section = SECT_NONE;
-        char line[MAX_CONFIG_INPUT_LINE_LEN + 1];
+    Ini::File file(kwinrc());
+    if (file.isValid()) {
+        int section = SECT_NONE;
+        Ini::Tokenizer tokenizer = file.tokenizer();
+        Ini::Token token;
 
         if (qtSettings.debug)
             fprintf(stderr, DEBUG_PREFIX "Reading kwinrc\n");
 
-        while(nullptr!=fgets(line, MAX_CONFIG_INPUT_LINE_LEN, f))
-            if(line[0]=='[')
-            {
-                if(0==strncasecmp(line, "[Compositing]", 13))
-                    section=SECT_KWIN_COMPOS;
-                else
-                    section=SECT_NONE;
-            }
-            else if (SECT_KWIN_COMPOS==section && 0==strncasecmp(line, "Backend=", 8))
-            {
-                if (strstr(line, "=XRender"))
-                    opts.square|=SQUARE_POPUP_MENUS|SQUARE_TOOLTIPS;
+        while ((token = tokenizer.next()) != Ini::Token::End) {
+            if (token == Ini::Token::Group) {
+                section = (tokenizer.group().equalsNoCase("Compositing") ?
+                           SECT_KWIN_COMPOS : SECT_NONE);
+            } else if (section == SECT_KWIN_COMPOS &&
+                       tokenizer.key().equalsNoCase("Backend")) {
+                if (startsWith(tokenizer.value(), "XRender"))
+                    opts.square |= SQUARE_POPUP_MENUS | SQUARE_TOOLTIPS;
                 break;
             }
-        fclose(f);
+        }
     }
 }
 
@@ -526,8 +549,7 @@ static void readKdeGlobals(const char *rc, int rd, bool first)
     ColorEffect   effects[2];
     int found = 0;
     int colorsFound = 0;
-    char          line[MAX_CONFIG_INPUT_LINE_LEN+1];
-    FILE          *f=fopen(rc, "r");
+    Ini::File file(rc);
     QtFontDetails fonts[FONT_NUM_STD];
 
     for (int i = 0;i < FONT_NUM_STD;++i) {
@@ -578,72 +600,79 @@ static void readKdeGlobals(const char *rc, int rd, bool first)
         qtSettings.colors[PAL_ACTIVE][COLOR_HOVER]=setGdkColor(119, 183, 255);
     }
 
-    if(f)
-    {
-        int section=SECT_NONE;
+    if (file.isValid()) {
+        static const StrMap<int, false> sections{
+            {"Icons", SECT_ICONS},
+            {"Toolbar style", SECT_TOOLBAR_STYLE},
+            {"MainToolbarIcons", SECT_MAIN_TOOLBAR_ICONS},
+            {"SmallIcons", SECT_SMALL_ICONS},
+            {"Colors:View", SECT_KDE4_COL_VIEW},
+            {"Colors:Button", SECT_KDE4_COL_BUTTON},
+            {"Colors:Selection", SECT_KDE4_COL_SEL},
+            {"Colors:Tooltip", SECT_KDE4_COL_TOOLTIP},
+            {"Colors:Window", SECT_KDE4_COL_WINDOW},
+            {"ColorEffects:Disabled", SECT_KDE4_EFFECT_DISABLED},
+            {"ColorEffects:Inactive", SECT_KDE4_EFFECT_INACTIVE},
+            {"General", SECT_GENERAL},
+            {"KDE", SECT_KDE},
+            {"WM", SECT_KDE4_COL_WM},
+        };
+        static const StrMap<KdeKey, false> keys{
+            {"Theme", KEY_THEME},
+            {"Size", KEY_SIZE},
+            {"ToolButtonStyle", KEY_TOOL_BUTTON_STYLE},
+            {"ShowIconsOnPushButtons", KEY_SHOW_ICONS_ON_PUSH_BUTTONS},
+            {"StartDragTime", KEY_START_DRAG_TIME},
+            {"activeBackground", KEY_ACTIVE_BACKGROUND},
+            {"activeForeground", KEY_ACTIVE_FOREGROUND},
+            {"inactiveBackground", KEY_INACTIVE_BACKGROUND},
+            {"inactiveForeground", KEY_INACTIVE_FOREGROUND},
+            {"font", KEY_FONT},
+            {"menuFont", KEY_MENU_FONT},
+            {"toolBarFont", KEY_TOOLBAR_FONT},
+            {"contrast", KEY_CONTRAST},
+            {"widgetStyle", KEY_WIDGET_STYLE},
+            {"shadeSortColumn", KEY_SHADE_SORT_COLUMN},
+            {"Color", KEY_COLOR},
+            {"ColorAmount", KEY_COLOR_AMOUNT},
+            {"ColorEffect", KEY_COLOR_EFFECT},
+            {"ContrastAmount", KEY_CONTRAST_AMOUNT},
+            {"ContrastEffect", KEY_CONTRAST_EFFECT},
+            {"IntensityAmount", KEY_INTENSITY_AMOUNT},
+            {"IntensityEffect", KEY_INTENSITY_EFFECT},
+            {"Enable", KEY_ENABLE},
+            {"ChangeSelectionColor", KEY_CHANGE_SELECTION_COLOR},
+        };
+        int section = SECT_NONE;
+        Ini::Tokenizer tokenizer = file.tokenizer();
+        Ini::Token token;
 
         if(qtSettings.debug)
             fprintf(stderr, DEBUG_PREFIX"Reading kdeglobals - %s\n", rc);
 
-        while(found!=rd && nullptr!=fgets(line, MAX_CONFIG_INPUT_LINE_LEN, f))
-            if(line[0]=='[')
-            {
-                if(0==strncasecmp(line, "[Icons]", 7))
-                    section=SECT_ICONS;
-                else if(0==strncasecmp(line, "[Toolbar style]", 15))
-                    section=SECT_TOOLBAR_STYLE;
-                else if(0==strncasecmp(line, "[MainToolbarIcons]", 18))
-                    section=SECT_MAIN_TOOLBAR_ICONS;
-                else if(0==strncasecmp(line, "[SmallIcons]", 12))
-                    section=SECT_SMALL_ICONS;
-                else if(0==strncasecmp(line, "[Colors:View]", 13))
-                    section=SECT_KDE4_COL_VIEW;
-                else if(0==strncasecmp(line, "[Colors:Button]", 15))
-                    section=SECT_KDE4_COL_BUTTON;
-                else if(0==strncasecmp(line, "[Colors:Selection]", 18))
-                    section=SECT_KDE4_COL_SEL;
-                else if(0==strncasecmp(line, "[Colors:Tooltip]", 16))
-                    section=SECT_KDE4_COL_TOOLTIP;
-                else if(0==strncasecmp(line, "[Colors:Window]", 15))
-                    section=SECT_KDE4_COL_WINDOW;
-                else if(0==strncasecmp(line, "[ColorEffects:Disabled]", 23))
-                    section=SECT_KDE4_EFFECT_DISABLED;
-                else if(0==strncasecmp(line, "[ColorEffects:Inactive]", 23))
-                    section=SECT_KDE4_EFFECT_INACTIVE;
-                else if(0==strncasecmp(line, "[General]", 9))
-                    section=SECT_GENERAL;
-                else if(0==strncasecmp(line, "[KDE]", 5))
-                    section=SECT_KDE;
-                else if(0==strncasecmp(line, "[WM]", 4))
-                    section=SECT_KDE4_COL_WM;
-                else
-                {
-                    section=SECT_NONE;
-                    if(colorsFound==ALL_KDE4_PAL_SETTINGS)
-                        found|=RD_KDE4_PAL;
-                    if(found==rd)
-                        break;
+        while (found != rd && (token = tokenizer.next()) != Ini::Token::End) {
+            if (token == Ini::Token::Group) {
+                const StrView &group = tokenizer.group();
+                section = sections.search(group.str, group.len, SECT_NONE);
+                if (section == SECT_NONE &&
+                    colorsFound == ALL_KDE4_PAL_SETTINGS) {
+                    found |= RD_KDE4_PAL;
                 }
+                continue;
             }
-            else if (SECT_ICONS==section && rd&RD_ICONS && !(found&RD_ICONS) &&
-                     0==strncasecmp(line, "Theme=", 6)) {
-                char *eq = strstr(line, "=");
-
-                if(eq && ++eq) {
-                    unsigned int len = strlen(eq);
-
-                    qtSettings.icons = (char*)realloc(qtSettings.icons,
-                                                      len + 1);
-                    strcpy(qtSettings.icons, eq);
-                    if('\n'==qtSettings.icons[len-1])
-                        qtSettings.icons[len-1]='\0';
-                }
+            const StrView &value = tokenizer.value();
+            KdeKey key = keys.search(tokenizer.key().str, tokenizer.key().len,
+                                     KEY_UNKNOWN);
+
+            if (SECT_ICONS==section && rd&RD_ICONS && !(found&RD_ICONS) &&
+                KEY_THEME == key) {
+                qtSettings.icons = dupValue(qtSettings.icons, value);
                 found|=RD_ICONS;
             }
             else if (SECT_SMALL_ICONS==section && rd&RD_SMALL_ICON_SIZE && !(found&RD_SMALL_ICON_SIZE) &&
-                     0==strncasecmp(line, "Size=", 5))
+                     KEY_SIZE == key)
             {
-                int size=readInt(line, 5);
+                int size=readInt(value);
 
                 if(0!=size)
                 {
@@ -655,66 +684,55 @@ static void readKdeGlobals(const char *rc, int rd, bool first)
             }
             else if (SECT_TOOLBAR_STYLE==section && rd&RD_TOOLBAR_STYLE &&
                      !(found&RD_TOOLBAR_STYLE) &&
-                     0==strncasecmp(line, "ToolButtonStyle=", 16)) {
-                char *eq = strstr(line, "=");
-
-                if(eq && ++eq)
-                {
-                    if(0==strncasecmp(eq, "IconOnly", 8))
-                        qtSettings.toolbarStyle=GTK_TOOLBAR_ICONS;
-                    else if(0==strncasecmp(eq, "TextOnly", 8))
-                        qtSettings.toolbarStyle=GTK_TOOLBAR_TEXT;
-                    else if (0==strncasecmp(eq, "TextBesideIcon", 14))
-                        qtSettings.toolbarStyle=GTK_TOOLBAR_BOTH_HORIZ;
-                    else if (0==strncasecmp(eq, "TextUnderIcon", 13))
-                        qtSettings.toolbarStyle=GTK_TOOLBAR_BOTH;
-                    found|=RD_TOOLBAR_STYLE;
-                }
+                     KEY_TOOL_BUTTON_STYLE == key) {
+                if (startsWith(value, "IconOnly"))
+                    qtSettings.toolbarStyle=GTK_TOOLBAR_ICONS;
+                else if (startsWith(value, "TextOnly"))
+                    qtSettings.toolbarStyle=GTK_TOOLBAR_TEXT;
+                else if (startsWith(value, "TextBesideIcon"))
+                    qtSettings.toolbarStyle=GTK_TOOLBAR_BOTH_HORIZ;
+                else if (startsWith(value, "TextUnderIcon"))
+                    qtSettings.toolbarStyle=GTK_TOOLBAR_BOTH;
+                found|=RD_TOOLBAR_STYLE;
             }
             else if (SECT_MAIN_TOOLBAR_ICONS==section && rd&RD_TOOLBAR_ICON_SIZE &&
-                        !(found&RD_TOOLBAR_ICON_SIZE) && 0==strncasecmp(line, "Size=", 5))
+                        !(found&RD_TOOLBAR_ICON_SIZE) && KEY_SIZE == key)
             {
-                qtSettings.iconSizes.tbSize = readInt(line, 5);
+                qtSettings.iconSizes.tbSize = readInt(value);
                 found|=RD_TOOLBAR_ICON_SIZE;
             }
             else if (SECT_KDE==section && rd&RD_BUTTON_ICONS && !(found&RD_BUTTON_ICONS) &&
-                        0==strncasecmp(line, "ShowIconsOnPushButtons=", 23))
+                        KEY_SHOW_ICONS_ON_PUSH_BUTTONS == key)
             {
-                qtSettings.buttonIcons=readBool(line, 23);
+                qtSettings.buttonIcons=readBool(value);
                 found|=RD_BUTTON_ICONS;
             }
-//             else if (SECT_KDE==section && rd&RD_DRAG_DIST && !(found&RD_DRAG_DIST) &&
-//                         0==strncasecmp(line, "StartDragDist=", 14))
-//             {
-//                 qtSettings.startDragDist=readInt(line, 14);
-//                 found|=RD_DRAG_DIST;
-//             }
             else if (SECT_KDE==section && rd&RD_DRAG_TIME && !(found&RD_DRAG_TIME) &&
-                        0==strncasecmp(line, "StartDragTime=", 14))
+                        KEY_START_DRAG_TIME == key)
             {
-                qtSettings.startDragTime=readInt(line, 14);
+                qtSettings.startDragTime=readInt(value);
                 found|=RD_DRAG_TIME;
             }
             else if (SECT_KDE4_COL_WM==section && rd&RD_KDE4_PAL &&
                      !(found&RD_KDE4_PAL)) {
                 colorsFound|=section;
-                if(0==strncasecmp(line, "activeBackground=", 17))
-                    qtSettings.colors[PAL_ACTIVE][COLOR_WINDOW_BORDER]=readColor(line);
-                else if(0==strncasecmp(line, "activeForeground=", 17))
-                    qtSettings.colors[PAL_ACTIVE][COLOR_WINDOW_BORDER_TEXT]=readColor(line);
-                else if(0==strncasecmp(line, "inactiveBackground=", 19))
-                    qtSettings.colors[PAL_INACTIVE][COLOR_WINDOW_BORDER]=readColor(line);
-                else if(0==strncasecmp(line, "inactiveForeground=", 19))
-                    qtSettings.colors[PAL_INACTIVE][COLOR_WINDOW_BORDER_TEXT]=readColor(line);
+                if (KEY_ACTIVE_BACKGROUND == key)
+                    qtSettings.colors[PAL_ACTIVE][COLOR_WINDOW_BORDER]=readColor(value);
+                else if (KEY_ACTIVE_FOREGROUND == key)
+                    qtSettings.colors[PAL_ACTIVE][COLOR_WINDOW_BORDER_TEXT]=readColor(value);
+                else if (KEY_INACTIVE_BACKGROUND == key)
+                    qtSettings.colors[PAL_INACTIVE][COLOR_WINDOW_BORDER]=readColor(value);
+                else if (KEY_INACTIVE_FOREGROUND == key)
+                    qtSettings.colors[PAL_INACTIVE][COLOR_WINDOW_BORDER_TEXT]=readColor(value);
             } else if (section>=SECT_KDE4_COL_BUTTON &&
                        section<=SECT_KDE4_COL_WINDOW &&
                        rd&RD_KDE4_PAL && !(found&RD_KDE4_PAL)) {
-                ColorType colorType=getColorType(line);
+                ColorType colorType=getColorType(tokenizer.key());
 
                 colorsFound|=section;
                 if(UnknownColor!=colorType)
                 {
-                    GdkColor color=readColor(line);
+                    GdkColor color=readColor(value);
 
                     switch(section)
                     {
@@ -767,36 +785,32 @@ static void readKdeGlobals(const char *rc, int rd, bool first)
                     }
                 }
             } else if (SECT_GENERAL==section && rd&RD_FONT && !(found&RD_FONT) &&
-                       0==strncasecmp(line, "font=", 5)) {
-                parseFontLine(line, &fonts[FONT_GENERAL]);
+                       KEY_FONT == key) {
+                parseFontLine(value, &fonts[FONT_GENERAL]);
                 found|=RD_FONT;
             }
             else if (SECT_GENERAL==section && rd&RD_MENU_FONT && !(found&RD_MENU_FONT) &&
-                     0==strncasecmp(line, "menuFont=", 9))
+                     KEY_MENU_FONT == key)
             {
-                parseFontLine(line, &fonts[FONT_MENU]);
+                parseFontLine(value, &fonts[FONT_MENU]);
                 found|=RD_MENU_FONT;
             }
             else if (SECT_GENERAL==section && rd&RD_TB_FONT && !(found&RD_TB_FONT) &&
-                     0==strncasecmp(line, "toolBarFont=", 12))
+                     KEY_TOOLBAR_FONT == key)
             {
-                parseFontLine(line, &fonts[FONT_TOOLBAR]);
+                parseFontLine(value, &fonts[FONT_TOOLBAR]);
                 found|=RD_TB_FONT;
             } else if (rd&RD_CONTRAST && !(found&RD_CONTRAST) &&
-                       SECT_KDE==section && 0==strncasecmp(line, "contrast=", 9)) {
-                opts.contrast=readInt(line, 9);
+                       SECT_KDE==section && KEY_CONTRAST == key) {
+                opts.contrast=readInt(value);
                 if(opts.contrast>10 || opts.contrast<0)
                     opts.contrast=DEFAULT_CONTRAST;
                 found|=RD_CONTRAST;
             }
 #ifdef QTC_GTK2_STYLE_SUPPORT
             else if(SECT_GENERAL==section && rd&RD_STYLE && !(found&RD_STYLE) &&
-                    0==strncasecmp(line, "widgetStyle=", 12)) {
-                int len=strlen(line);
-                qtSettings.styleName=realloc(qtSettings.styleName, strlen(&line[12])+1);
-                if('\n'==line[len-1])
-                    line[len-1]='\0';
-                strcpy(qtSettings.styleName, &line[12]);
+                    KEY_WIDGET_STYLE == key) {
+                qtSettings.styleName = dupValue(qtSettings.styleName, value);
                 found|=RD_STYLE;
             }
 #endif
@@ -805,38 +819,48 @@ static void readKdeGlobals(const char *rc, int rd, bool first)
                     rd&RD_KDE4_PAL && !(found&RD_KDE4_PAL)) {
                 colorsFound|=section;
                 Effect eff=SECT_KDE4_EFFECT_DISABLED==section ? EFF_DISABLED : EFF_INACTIVE;
-                if(0==strncasecmp(line, "Color=", 6))
-                    effects[eff].col=readColor(line);
-                else if(0==strncasecmp(line, "ColorAmount=", 12))
-                    effects[eff].color.amount=readDouble(line, 12);
-                else if(0==strncasecmp(line, "ColorEffect=", 12))
+                switch (key) {
+                case KEY_COLOR:
+                    effects[eff].col=readColor(value);
+                    break;
+                case KEY_COLOR_AMOUNT:
+                    effects[eff].color.amount=readDouble(value);
+                    break;
+                case KEY_COLOR_EFFECT:
                     effects[eff].color.effect =
-                        (ColAdjustEffects)readInt(line, 12);
-                else if(0==strncasecmp(line, "ContrastAmount=", 15))
-                    effects[eff].contrast.amount=readDouble(line, 15);
-                else if(0==strncasecmp(line, "ContrastEffect=", 15))
+                        (ColAdjustEffects)readInt(value);
+                    break;
+                case KEY_CONTRAST_AMOUNT:
+                    effects[eff].contrast.amount=readDouble(value);
+                    break;
+                case KEY_CONTRAST_EFFECT:
                     effects[eff].contrast.effect =
-                        (ColAdjustEffects)readInt(line, 15);
-                else if(0==strncasecmp(line, "IntensityAmount=", 16))
-                    effects[eff].intensity.amount=readDouble(line, 16);
-                else if(0==strncasecmp(line, "IntensityEffect=", 16))
+                        (ColAdjustEffects)readInt(value);
+                    break;
+                case KEY_INTENSITY_AMOUNT:
+                    effects[eff].intensity.amount=readDouble(value);
+                    break;
+                case KEY_INTENSITY_EFFECT:
                     effects[eff].intensity.effect =
-                        (ColAdjustEffects)readInt(line, 16);
-                else if(0==strncasecmp(line, "Enable=", 7))
-                    effects[eff].enabled=readBool(line, 7);
-                else if(0==strncasecmp(line, "ChangeSelectionColor=", 21))
-                    qtSettings.inactiveChangeSelectionColor=readBool(line, 21);
+                        (ColAdjustEffects)readInt(value);
+                    break;
+                case KEY_ENABLE:
+                    effects[eff].enabled=readBool(value);
+                    break;
+                case KEY_CHANGE_SELECTION_COLOR:
+                    qtSettings.inactiveChangeSelectionColor=readBool(value);
+                    break;
+                default:
+                    break;
+                }
             }
             else if(SECT_GENERAL==section && rd&RD_LIST_SHADE && !(found&RD_LIST_SHADE) &&
-                    0==strncasecmp(line, "shadeSortColumn=", 16))
+                    KEY_SHADE_SORT_COLUMN == key)
             {
-                qtSettings.shadeSortedList=readBool(line, 16);
+                qtSettings.shadeSortedList=readBool(value);
                 found|=RD_LIST_SHADE;
             }
-            else if(found==rd)
-                break;
-
-        fclose(f);
+        }
     }
     else if (!first)
     {
@@ -956,22 +980,9 @@ static int qt_refs = 0;
 static const char*
 kdeIconsPrefix()
 {
-    static uniqueStr dir = [] {
-        size_t len = 0;
-        const char *const args[] = {"kde4-config", "--install", "icon",
-                                    nullptr};
-        char *res = qtcPopenStdout("kde4-config", args, 300, &len);
-        if (res && res[strspn(res, " \t\b\n\f\v")]) {
-            if (res[len - 1]=='\n') {
-                res[len - 1]='\0';
-            }
-            return res;
-        }
-        return strdup(QTC_KDE4_ICONS_PREFIX &&
-                      strlen(QTC_KDE4_ICONS_PREFIX) > 2 ?
-                      QTC_KDE4_ICONS_PREFIX : DEFAULT_ICON_PREFIX);
-    };
-    return dir.get();
+    return getKDE4IconsPrefix(QTC_KDE4_ICONS_PREFIX &&
+                              strlen(QTC_KDE4_ICONS_PREFIX) > 2 ?
+                              QTC_KDE4_ICONS_PREFIX : DEFAULT_ICON_PREFIX);
 }
 
 static char*
@@ -979,7 +990,7 @@ getIconPath()
 {
     static Str::Buff<1024> buff;
 
-    const char *kdeHome = getKdeHome();
+    const char *kdeHome = getKDE4LocalPrefix();
     const char *kdePrefix = kdeIconsPrefix();
     const char *defIcons = defaultIcons();
     bool nonDefIcons = qtSettings.icons && strcmp(qtSettings.icons, defIcons);
@@ -1175,7 +1186,7 @@ qtSettingsInit()
             /* Is the user using a non-default QtCurve style? */
             if (qtSettings.styleName &&
                 Str::startsWith(qtSettings.styleName, THEME_PREFIX)) {
-                rcFile = themeFile(getKdeHome(), qtSettings.styleName,
+                rcFile = themeFile(getKDE4LocalPrefix(), qtSettings.styleName,
                                    str_buff);
 
                 if (!rcFile) {
@@ -1942,6 +1953,10 @@ static void qtSettingsExit()
 
 void qtSettingsSetColors(GtkStyle *style, GtkRcStyle *rc_style)
 {
+    // A new style, the options or the palette may have been reloaded.
+    GradientCache::clear();
+    BevelCache::clear();
+
     SET_COLOR(style, rc_style, bg, GTK_RC_BG, GTK_STATE_NORMAL, COLOR_WINDOW)
     SET_COLOR(style, rc_style, bg, GTK_RC_BG, GTK_STATE_SELECTED, COLOR_SELECTED)
     SET_COLOR_X(style, rc_style, bg, GTK_RC_BG, GTK_STATE_INSENSITIVE, COLOR_WINDOW, false)
@@ -56,6 +56,7 @@
 #include "drawing.h"
 #include "pixcache.h"
 #include "shadowhelper.h"
+#include "detail.h"
 #include "config.h"
 
 namespace QtCurve {
@@ -143,6 +144,7 @@ gtkDrawFlatBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
     const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
 
     bool isMenuOrToolTipWindow =
@@ -160,7 +162,7 @@ gtkDrawFlatBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
     sanitizeSize(window, &width, &height);
 
     if (!opts.gtkButtonOrder && opts.reorderGtkButtons &&
-        GTK_IS_WINDOW(widget) && oneOf(detail, "base")) {
+        GTK_IS_WINDOW(widget) && d == Detail::Base) {
         GtkWidget *topLevel = gtk_widget_get_toplevel(widget);
         GtkWidgetProps topProps(topLevel);
 
@@ -183,7 +185,7 @@ gtkDrawFlatBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
     }
 
     if (opts.windowDrag > WM_DRAG_MENU_AND_TOOLBAR &&
-        oneOf(detail, "base", "eventbox", "viewportbin")) {
+        oneOf(d, Detail::Base, Detail::EventBox, Detail::ViewportBin)) {
         WMMove::setup(widget);
     }
 
@@ -244,11 +246,12 @@ gtkDrawFlatBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
         }
     }
 
-    if (widget && qtcIsCustomBgnd(opts) && oneOf(detail, "base", "eventbox")) {
+    if (widget && qtcIsCustomBgnd(opts) &&
+        oneOf(d, Detail::Base, Detail::EventBox)) {
         Scrollbar::setup(widget);
     }
 
-    if (qtcIsCustomBgnd(opts) && oneOf(detail, "viewportbin")) {
+    if (qtcIsCustomBgnd(opts) && d == Detail::ViewportBin) {
         GtkRcStyle *st = widget ? gtk_widget_get_modifier_style(widget) : nullptr;
         // if the app hasn't modified bg, draw background gradient
         if (st && !(st->color_flags[state]&GTK_RC_BG)) {
@@ -386,32 +389,32 @@ gtkDrawFlatBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
                               y, selW, height, round, true, alpha, factor);
             }
         }
-    } else if (oneOf(detail, "checkbutton")) {
+    } else if (d == Detail::CheckButton) {
         if (state == GTK_STATE_PRELIGHT && opts.crHighlight &&
             width > opts.crSize * 2) {
             GdkColor col=shadeColor(&style->bg[state], TO_FACTOR(opts.crHighlight));
             drawSelectionGradient(cr, (QtcRect*)area, x, y, width, height,
                                   ROUNDED_ALL, false, 1.0, &col, true);
         }
-    } else if (oneOf(detail, "expander")) {
+    } else if (d == Detail::Expander) {
         if (state == GTK_STATE_PRELIGHT && opts.expanderHighlight) {
             GdkColor col = shadeColor(&style->bg[state],
                                       TO_FACTOR(opts.expanderHighlight));
             drawSelectionGradient(cr, (QtcRect*)area, x, y, width, height,
                                   ROUNDED_ALL, false, 1.0, &col, true);
         }
-    } else if (oneOf(detail, "tooltip")) {
+    } else if (d == Detail::Tooltip) {
         drawToolTip(cr, widget, (QtcRect*)area, x, y, width, height);
-    } else if (oneOf(detail, "icon_view_item")) {
+    } else if (d == Detail::IconViewItem) {
         drawSelection(cr, style, state, (QtcRect*)area, widget, x, y,
                       width, height, ROUNDED_ALL, false, 1.0, 0);
     } else if (state != GTK_STATE_SELECTED &&
-               qtcIsCustomBgnd(opts) && oneOf(detail, "eventbox")) {
+               qtcIsCustomBgnd(opts) && d == Detail::EventBox) {
         drawWindowBgnd(cr, style, nullptr, window, widget, x, y, width, height);
     } else if (!(qtSettings.app == GTK_APP_JAVA && widget &&
                  GTK_IS_LABEL(widget))) {
         if (state != GTK_STATE_PRELIGHT || opts.crHighlight ||
-            noneOf(detail, "checkbutton")) {
+            d != Detail::CheckButton) {
             parent_class->draw_flat_box(style, window, state, shadow, area,
                                         widget, _detail, x, y, width, height);
         }
@@ -441,7 +444,7 @@ gtkDrawHandle(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_WINDOW(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     QtcRect *area = (QtcRect*)_area;
     bool paf = widgetIsType(widget, "PanelAppletFrame");
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
@@ -462,12 +465,12 @@ gtkDrawHandle(GtkStyle *style, GdkWindow *window, GtkStateType state,
         }
     }
 
-    if (oneOf(detail, "paned") || oneOf(detail + 1, "paned")) {
+    if (oneOf(d, Detail::Paned, Detail::HPaned, Detail::VPaned)) {
         drawSplitter(cr, state, style, area, x, y, width, height);
-    } else if ((oneOf(detail, "handlebox") &&
+    } else if ((d == Detail::HandleBox &&
                 (qtSettings.app == GTK_APP_JAVA ||
                  (widget && GTK_IS_HANDLE_BOX(widget)))) ||
-               oneOf(detail, "dockitem") || paf) {
+               d == Detail::DockItem || paf) {
         /* Note: I'm not sure why the 'widget && GTK_IS_HANDLE_BOX(widget)' is in
          * the following 'if' - its been there for a while. But this breaks the
          * toolbar handles for Java Swing apps. I'm leaving it in for non Java
@@ -536,7 +539,7 @@ gtkDrawArrow(GtkStyle *style, GdkWindow *window, GtkStateType state,
              int x, int y, int width, int height)
 {
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     if (qtSettings.debug == DEBUG_ALL) {
         printf(DEBUG_PREFIX "%s %d %d %d %d %d %d %d %s  ", __FUNCTION__,
                state, shadow, arrow_type, x, y, width, height, _detail);
@@ -545,7 +548,7 @@ gtkDrawArrow(GtkStyle *style, GdkWindow *window, GtkStateType state,
     QtcRect *area = (QtcRect*)_area;
     cairo_t *cr = gdk_cairo_create(window);
 
-    if (oneOf(detail, "arrow")) {
+    if (d == Detail::Arrow) {
         bool onComboEntry = isOnComboEntry(widget, 0);
 
         if (isOnComboBox(widget, 0) && !onComboEntry) {
@@ -606,11 +609,11 @@ gtkDrawArrow(GtkStyle *style, GdkWindow *window, GtkStateType state,
                          false, true, opts.vArrows);
         }
     } else {
-        int isSpinButton = oneOf(detail, "spinbutton");
-        bool isMenuItem = oneOf(detail, "menuitem");
+        int isSpinButton = d == Detail::SpinButton;
+        bool isMenuItem = d == Detail::MenuItem;
         /* int a_width = LARGE_ARR_WIDTH; */
         /* int a_height = LARGE_ARR_HEIGHT; */
-        bool sbar = isSbarDetail(detail);
+        bool sbar = isSbarDetail(d);
         bool smallArrows = isSpinButton && !opts.unifySpin;
         int stepper = (sbar ? getStepper(widget, x, y, opts.sliderWidth,
                                          opts.sliderWidth) : STEPPER_NONE);
@@ -712,31 +715,31 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
     const char *detail = _detail ? _detail : "";
-    bool sbar = isSbarDetail(detail);
-    bool pbar = oneOf(detail, "bar"); //  && GTK_IS_PROGRESS_BAR(widget);
-    bool qtcSlider = !pbar && oneOf(detail, "qtc-slider");
-    bool slider = qtcSlider || (!pbar && oneOf(detail, "slider"));
-    bool hscale = !slider && oneOf(detail, "hscale");
-    bool vscale = !hscale && oneOf(detail, "vscale");
-    bool menubar = !vscale && oneOf(detail, "menubar");
-    bool button = !menubar && oneOf(detail, "button");
-    bool togglebutton = !button && oneOf(detail, "togglebutton");
-    bool optionmenu = !togglebutton && oneOf(detail, "optionmenu");
-    bool stepper = !optionmenu && oneOf(detail, "stepper");
-    bool vscrollbar = (!optionmenu && Str::startsWith(detail, "vscrollbar"));
-    bool hscrollbar = (!vscrollbar && Str::startsWith(detail, "hscrollbar"));
-    bool spinUp = !hscrollbar && oneOf(detail, "spinbutton_up");
-    bool spinDown = !spinUp && oneOf(detail, "spinbutton_down");
-    bool menuScroll = strstr(detail, "menu_scroll_arrow_");
+    Detail d = classifyDetail(_detail);
+    bool sbar = isSbarDetail(d);
+    bool pbar = d == Detail::Bar; //  && GTK_IS_PROGRESS_BAR(widget);
+    bool qtcSlider = d == Detail::QtcSlider;
+    bool slider = qtcSlider || d == Detail::Slider;
+    bool hscale = d == Detail::HScale;
+    bool vscale = d == Detail::VScale;
+    bool menubar = d == Detail::MenuBar;
+    bool button = d == Detail::Button;
+    bool togglebutton = d == Detail::ToggleButton;
+    bool optionmenu = d == Detail::OptionMenu;
+    bool stepper = d == Detail::Stepper;
+    bool vscrollbar = d == Detail::VScrollbar;
+    bool spinUp = d == Detail::SpinButtonUp;
+    bool spinDown = d == Detail::SpinButtonDown;
+    bool menuScroll = d == Detail::MenuScrollArrow;
     bool rev = (reverseLayout(widget) ||
                 (widget && reverseLayout(gtk_widget_get_parent(widget))));
     bool activeWindow = true;
     GdkColor new_cols[TOTAL_SHADES + 1];
     const GdkColor *btnColors = qtcPalette.background;
     int bgnd = getFill(state, btnDown);
-    auto round = getRound(detail, widget, rev);
+    auto round = getRound(d, detail, widget, rev);
     bool lvh = (isListViewHeader(widget) ||
-                isEvolutionListViewHeader(widget, detail));
+                isEvolutionListViewHeader(widget, d));
     bool sunken = (btnDown || shadow == GTK_SHADOW_IN ||
                    state == GTK_STATE_ACTIVE || bgnd == 2 || bgnd == 3);
     GtkWidget *parent = nullptr;
@@ -753,7 +756,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
     }
 
     // FIXME, need to update useButtonColor if the logic below changes right now
-    if (useButtonColor(detail)) {
+    if (useButtonColor(d)) {
         if (slider | hscale | vscale | sbar && state == GTK_STATE_INSENSITIVE) {
             btnColors = qtcPalette.background;
         } else if (QT_CUSTOM_COLOR_BUTTON(style)) {
@@ -840,7 +843,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
                            &btnColors[bgnd], btnColors, round, wid, BORDER_FLAT,
                            DF_DO_BORDER | (sunken ? DF_SUNKEN : 0), widget);
         }
-    } else if (oneOf(detail, "spinbutton")) {
+    } else if (d == Detail::SpinButton) {
         if (qtcIsFlatBgnd(opts.bgndAppearance) ||
             !(widget && drawWindowBgnd(cr, style, (QtcRect*)area, window,
                                        widget, x, y, width, height))) {
@@ -920,7 +923,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
         }
     } else if (button || togglebutton || optionmenu || sbar ||
                hscale || vscale || stepper || slider) {
-        bool combo = oneOf(detail, "optionmenu") || isOnComboBox(widget, 0);
+        bool combo = optionmenu || isOnComboBox(widget, 0);
         bool combo_entry = combo && isOnComboEntry(widget, 0);
         bool horiz_tbar;
         bool tbar_button = isButtonOnToolbar(widget, &horiz_tbar);
@@ -981,7 +984,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
             /* Try and guess if this button is a toolbar button... */
             if (oneOf(widgetType, WIDGET_STD_BUTTON, WIDGET_TOGGLE_BUTTON) &&
                 isMozillaWidget(widget) && GTK_IS_BUTTON(widget) &&
-                oneOf(detail, "button") && ((width > 22 && width < 56 &&
+                d == Detail::Button && ((width > 22 && width < 56 &&
                                              height > 30) || height >= 32 ||
                                             ((width == 30 || width == 45) &&
                                              height == 30)))
@@ -1422,9 +1425,8 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
                 }
             }
         }
-    } else if (oneOf(detail, "buttondefault", "togglebuttondefault")) {
-    } else if (widget && (oneOf(detail, "trough") ||
-                          Str::startsWith(detail, "trough-"))) {
+    } else if (oneOf(d, Detail::ButtonDefault, Detail::ToggleButtonDefault)) {
+    } else if (widget && oneOf(d, Detail::Trough, Detail::TroughPart)) {
         bool list = isList(widget);
         bool pbar = list || GTK_IS_PROGRESS_BAR(widget);
         bool scale = !pbar && GTK_IS_SCALE(widget);
@@ -1433,8 +1435,8 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
                       width > height);
 
         if (scale) {
-            drawSliderGroove(cr, style, state, widget, detail, (QtcRect*)area,
-                             x, y, width, height, horiz);
+            drawSliderGroove(cr, style, state, widget, d, detail,
+                             (QtcRect*)area, x, y, width, height, horiz);
         } else if (pbar) {
             drawProgressGroove(cr, style, state, window, widget, (QtcRect*)area,
                                x, y, width, height, list, horiz);
@@ -1442,18 +1444,19 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
             drawScrollbarGroove(cr, style, state, widget, (QtcRect*)area,
                                 x, y, width, height, horiz);
         }
-    } else if (oneOf(detail, "entry-progress")) {
+    } else if (d == Detail::EntryProgress) {
         int adjust = (opts.fillProgress ? 4 : 3) - (opts.etchEntry ? 1 : 0);
         drawProgress(cr, style, state, widget, (QtcRect*)area, x - adjust,
                      y - adjust, width + adjust, height + 2 * adjust,
                      rev, true);
-    } else if (oneOf(detail, "dockitem", "dockitem_bin")) {
+    } else if (oneOf(d, Detail::DockItem, Detail::DockItemBin)) {
         if (qtcIsCustomBgnd(opts) && widget) {
             drawWindowBgnd(cr, style, (QtcRect*)area, window, widget,
                            x, y, width, height);
         }
-    } else if (widget && ((menubar || oneOf(detail, "toolbar", "handlebox",
-                                            "handlebox_bin")) ||
+    } else if (widget && ((menubar || oneOf(d, Detail::Toolbar,
+                                            Detail::HandleBox,
+                                            Detail::HandleBoxBin)) ||
                           widgetIsType(widget, "PanelAppletFrame"))) {
         //if(GTK_SHADOW_NONE!=shadow)
         {
@@ -1489,7 +1492,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
             if (drawGradient) {
                 drawBevelGradient(cr, (QtcRect*)area, x, y - menuBarAdjust, width,
                                   height + menuBarAdjust, col,
-                                  (menubar ? true : oneOf(detail, "handlebox") ?
+                                  (menubar ? true : d == Detail::HandleBox ?
                                    width < height : width > height),
                                   false, MODIFY_AGUA(app), WIDGET_OTHER, alpha);
             } else if (fillBackground) {
@@ -1498,26 +1501,26 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
             }
             if (shadow != GTK_SHADOW_NONE && opts.toolbarBorders != TB_NONE) {
                 drawToolbarBorders(cr, state, x, y, width, height,
-                                   menubar && activeWindow, detail);
+                                   menubar && activeWindow, d);
             }
         }
     } else if (widget && pbar) {
         drawProgress(cr, style, state, widget, (QtcRect*)area,
                      x, y, width, height, rev, false);
-    } else if (oneOf(detail, "menuitem")) {
+    } else if (d == Detail::MenuItem) {
         drawMenuItem(cr, state, style, widget, (QtcRect*)area,
                      x, y, width, height);
-    } else if (oneOf(detail, "menu")) {
+    } else if (d == Detail::Menu) {
         drawMenu(cr, widget, (QtcRect*)area, x, y, width, height);
-    } else if ((!strcmp(detail, "paned") || !strcmp(detail + 1, "paned"))) {
+    } else if (oneOf(d, Detail::Paned, Detail::HPaned, Detail::VPaned)) {
         gtkDrawHandle(style, window, state, shadow, area, widget, detail,
                       x, y, width, height,
-                      *detail == 'h' ? GTK_ORIENTATION_VERTICAL :
+                      d == Detail::HPaned ? GTK_ORIENTATION_VERTICAL :
                       GTK_ORIENTATION_HORIZONTAL);
-    } else if (strcmp(detail + 1, "ruler") == 0) {
+    } else if (oneOf(d, Detail::HRuler, Detail::VRuler)) {
         drawBevelGradient(cr, (QtcRect*)area, x, y, width, height,
                           &qtcPalette.background[ORIGINAL_SHADE],
-                          detail[0] == 'h', false, opts.lvAppearance,
+                          d == Detail::HRuler, false, opts.lvAppearance,
                           WIDGET_LISTVIEW_HEADER);
 
 //        if(qtcIsFlatBgnd(opts.bgndAppearance) || !widget || !drawWindowBgnd(cr, style, area, widget, x, y, width, height))
@@ -1526,7 +1529,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
 //             if(widget && IMG_NONE!=opts.bgndImage.type)
 //                 drawWindowBgnd(cr, style, area, widget, x, y, width, height);
 //        }
-    } else if (oneOf(detail, "hseparator")) {
+    } else if (d == Detail::HSeparator) {
         bool isMenuItem = widget && GTK_IS_MENU_ITEM(widget);
         const GdkColor *cols=qtcPalette.background;
         int offset=opts.menuStripe && (isMozilla() || isMenuItem) ? 20 : 0;
@@ -1541,7 +1544,7 @@ drawBox(GtkStyle *style, GdkWindow *window, GtkStateType state,
         drawFadedLine(cr, x + 1 + offset, y + height / 2, width - (1 + offset),
                       1, &cols[isMenuItem ? MENU_SEP_SHADE : QTC_STD_BORDER],
                       (QtcRect*)area, nullptr, true, true, true);
-    } else if (oneOf(detail, "vseparator")) {
+    } else if (d == Detail::VSeparator) {
         drawFadedLine(cr, x + width / 2, y, 1, height,
                       &qtcPalette.background[QTC_STD_BORDER], (QtcRect*)area,
                       nullptr, true, true, false);
@@ -1594,7 +1597,7 @@ gtkDrawShadow(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     sanitizeSize(window, &width, &height);
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
     bool comboBoxList = isComboBoxList(widget);
@@ -1604,7 +1607,7 @@ gtkDrawShadow(GtkStyle *style, GdkWindow *window, GtkStateType state,
         bool square = opts.square & SQUARE_POPUP_MENUS;
 
         if ((!square || opts.popupBorder) &&
-            (!comboList || noneOf(detail, "viewport"))) {
+            (!comboList || d != Detail::Viewport)) {
             bool nonGtk = square || isFakeGtk();
             bool composActive = !nonGtk && compositingActive(widget);
             bool isAlphaWidget = (!nonGtk && composActive &&
@@ -1693,7 +1696,7 @@ gtkDrawShadow(GtkStyle *style, GdkWindow *window, GtkStateType state,
 
         WidgetMap::setup(parent, widget, 1);
         ComboBox::setup(widget, parent);
-    } else if (oneOf(detail, "entry", "text")) {
+    } else if (oneOf(d, Detail::Entry, Detail::Text)) {
         GtkWidget *parent=widget ? gtk_widget_get_parent(widget) : nullptr;
         if (parent && isList(parent)) {
             // Dont draw shadow for entries in listviews...
@@ -1752,9 +1755,9 @@ gtkDrawShadow(GtkStyle *style, GdkWindow *window, GtkStateType state,
             }
         }
     } else {
-        bool frame = !_detail || strcmp(detail, "frame") == 0;
-        bool scrolledWindow = oneOf(detail, "scrolled_window");
-        bool viewport = !scrolledWindow && strstr(detail, "viewport");
+        bool frame = !_detail || d == Detail::Frame;
+        bool scrolledWindow = d == Detail::ScrolledWindow;
+        bool viewport = oneOf(d, Detail::Viewport, Detail::ViewportBin);
         bool drawSquare = ((frame && opts.square & SQUARE_FRAME) ||
                            (!viewport && !scrolledWindow &&
                             !_detail && !widget));
@@ -1977,10 +1980,10 @@ gtkDrawCheck(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     QtcRect *area = (QtcRect*)_area;
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
-    drawCheckBox(cr, state, shadow, style, widget, detail, area,
+    drawCheckBox(cr, state, shadow, style, widget, d, area,
                  x, y, width, height);
     cairo_destroy(cr);
 }
@@ -1992,10 +1995,10 @@ gtkDrawOption(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     QtcRect *area = (QtcRect*)_area;
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
-    drawRadioButton(cr, state, shadow, style, widget, detail, area,
+    drawRadioButton(cr, state, shadow, style, widget, d, area,
                     x, y, width, height);
     cairo_destroy(cr);
 }
@@ -2019,10 +2022,10 @@ gtkDrawLayout(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
     const QtcRect *area = (QtcRect*)_area;
     cairo_t *cr = gdk_cairo_create(window);
-    if (GTK_IS_PROGRESS(widget) || oneOf(detail, "progressbar")) {
+    if (GTK_IS_PROGRESS(widget) || d == Detail::ProgressBar) {
         drawLayout(cr, style, state, use_text, area, x, y, layout);
     } else {
         Style *qtc_style = (Style*)style;
@@ -2054,7 +2057,7 @@ gtkDrawLayout(GtkStyle *style, GdkWindow *window, GtkStateType state,
             debugDisplayWidget(widget, 10);
         }
 
-        if (oneOf(detail, "cellrenderertext") && widget &&
+        if (d == Detail::CellRendererText && widget &&
             gtk_widget_get_state(widget) == GTK_STATE_INSENSITIVE)
              state = GTK_STATE_INSENSITIVE;
 
@@ -2064,7 +2067,7 @@ gtkDrawLayout(GtkStyle *style, GdkWindow *window, GtkStateType state,
            if not used, when an item is selected it gets the selected text
            color - but when the window changes focus it gets the normal
            text color! */
-         if (oneOf(detail, "cellrenderertext") && state == GTK_STATE_ACTIVE)
+         if (d == Detail::CellRendererText && state == GTK_STATE_ACTIVE)
              state = GTK_STATE_SELECTED;
 #endif
 
@@ -2255,7 +2258,6 @@ gtkDrawBoxGap(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
 
     if ((opts.thin & THIN_FRAMES) && gapX == 0) {
@@ -2268,7 +2270,8 @@ gtkDrawBoxGap(GtkStyle *style, GdkWindow *window, GtkStateType state,
                width, height, gapSide, gapX, gapWidth,
                opts.borderTab ? BORDER_LIGHT : BORDER_RAISED, true);
 
-    if (opts.windowDrag > WM_DRAG_MENU_AND_TOOLBAR && oneOf(detail, "notebook")) {
+    if (opts.windowDrag > WM_DRAG_MENU_AND_TOOLBAR &&
+        classifyDetail(_detail) == Detail::Notebook) {
         WMMove::setup(widget);
     }
 
@@ -2286,7 +2289,6 @@ gtkDrawExtension(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
     if (qtSettings.debug == DEBUG_ALL) {
         printf(DEBUG_PREFIX "%s %d %d %d %d %d %d %d %s  ", __FUNCTION__, state,
                shadow, gapSide, x, y, width, height, _detail);
@@ -2294,7 +2296,7 @@ gtkDrawExtension(GtkStyle *style, GdkWindow *window, GtkStateType state,
     }
     sanitizeSize(window, &width, &height);
 
-    if (oneOf(detail, "tab")) {
+    if (classifyDetail(_detail) == Detail::Tab) {
         QtcRect *area = (QtcRect*)_area;
         cairo_t *cr = Cairo::gdkCreateClip(window, area);
         drawTab(cr, state, style, widget, area, x, y, width, height, gapSide);
@@ -2315,8 +2317,9 @@ gtkDrawSlider(GtkStyle *style, GdkWindow *window, GtkStateType state,
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
     const char *detail = _detail ? _detail : "";
-    bool scrollbar = oneOf(detail, "slider");
-    bool scale = oneOf(detail, "hscale", "vscale");
+    Detail d = classifyDetail(_detail);
+    bool scrollbar = d == Detail::Slider;
+    bool scale = oneOf(d, Detail::HScale, Detail::VScale);
 
     if (qtSettings.debug == DEBUG_ALL) {
         printf(DEBUG_PREFIX "%s %d %d %d %d %d %d %s  ", __FUNCTION__, state,
@@ -2341,7 +2344,7 @@ gtkDrawSlider(GtkStyle *style, GdkWindow *window, GtkStateType state,
             state=GTK_STATE_PRELIGHT;
 
         // FIXME, need to update useButtonColor if the logic below changes
-        if (useButtonColor(detail)) {
+        if (useButtonColor(d)) {
             if(scrollbar|scale && GTK_STATE_INSENSITIVE==state)
                 btnColors=qtcPalette.background;
             else if(QT_CUSTOM_COLOR_BUTTON(style))
@@ -2432,7 +2435,7 @@ gtkDrawSlider(GtkStyle *style, GdkWindow *window, GtkStateType state,
             }
         }
     } else {
-        drawTriangularSlider(cr, style, state, detail, x, y, width, height);
+        drawTriangularSlider(cr, style, state, d, x, y, width, height);
     }
     cairo_destroy(cr);
 }
@@ -2460,8 +2463,8 @@ gtkDrawHLine(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
-    bool tbar = strcmp(detail, "toolbar");
+    Detail d = classifyDetail(_detail);
+    bool tbar = d != Detail::Toolbar;
     int light = 0;
     int dark = tbar ? (opts.toolbarSeparators == LINE_FLAT ? 4 : 3) : 5;
 
@@ -2502,7 +2505,7 @@ gtkDrawHLine(GtkStyle *style, GdkWindow *window, GtkStateType state,
                 }
             }
         }
-    } else if (oneOf(detail, "label")) {
+    } else if (d == Detail::Label) {
         if (state == GTK_STATE_INSENSITIVE) {
             /* Cairo::hLine(cr, (x1 < x2 ? x1 : x2) + 1, y + 1, abs(x2 - x1), */
             /*              &qtcPalette.background[light]); */
@@ -2515,8 +2518,8 @@ gtkDrawHLine(GtkStyle *style, GdkWindow *window, GtkStateType state,
         drawFadedLine(cr, x1 < x2 ? x1 : x2, y, abs(x2 - x1), 1,
                       &qtcPalette.background[dark], (QtcRect*)area, nullptr,
                       true, true, true);
-    } else if (oneOf(detail, "menuitem") ||
-               (widget && oneOf(detail, "hseparator") && isMenuitem(widget))) {
+    } else if (d == Detail::MenuItem ||
+               (widget && d == Detail::HSeparator && isMenuitem(widget))) {
         int       offset=opts.menuStripe && (isMozilla() || (widget && GTK_IS_MENU_ITEM(widget))) ? 20 : 0;
         GdkColor *cols=qtcPalette.background;
 
@@ -2553,7 +2556,7 @@ gtkDrawVLine(GtkStyle *style, GdkWindow *window, GtkStateType state,
 {
     QTC_RET_IF_FAIL(GTK_IS_STYLE(style));
     QTC_RET_IF_FAIL(GDK_IS_DRAWABLE(window));
-    const char *detail = _detail ? _detail : "";
+    Detail d = classifyDetail(_detail);
 
     if (qtSettings.debug == DEBUG_ALL) {
         printf(DEBUG_PREFIX "%s %d %d %d %d %s  ", __FUNCTION__, state, x, y1,
@@ -2563,9 +2566,9 @@ gtkDrawVLine(GtkStyle *style, GdkWindow *window, GtkStateType state,
 
     cairo_t *cr = Cairo::gdkCreateClip(window, area);
 
-    if (!(oneOf(detail, "vseparator") && isOnComboBox(widget, 0))) {
+    if (!(d == Detail::VSeparator && isOnComboBox(widget, 0))) {
          /* CPD: Combo handled in drawBox */
-        bool tbar = oneOf(detail, "toolbar");
+        bool tbar = d == Detail::Toolbar;
         int dark = tbar ? 3 : 5;
         int light = 0;
 
@@ -110,6 +110,27 @@ registerWidget(GtkWidget* widget)
     return true;
 }
 
+// The owner of shared shadow pixmaps has gone, install their replacement on
+// every window that has a shadow.
+static GdkFilterReturn
+ownerFilter(GdkXEvent *xevent, GdkEvent*, void*)
+{
+    XEvent *event = (XEvent*)xevent;
+    if (event->type != DestroyNotify ||
+        !qtcX11ShadowOwnerDestroyed(event->xdestroywindow.window))
+        return GDK_FILTER_CONTINUE;
+    GList *toplevels = gtk_window_list_toplevels();
+    for (GList *item = toplevels;item;item = item->next) {
+        GtkWidget *widget = GTK_WIDGET(item->data);
+        if (GtkWidgetProps(widget)->shadowSet &&
+            gtk_widget_get_realized(widget)) {
+            installX11Shadows(widget);
+        }
+    }
+    g_list_free(toplevels);
+    return GDK_FILTER_CONTINUE;
+}
+
 static gboolean
 realizeHook(GSignalInvocationHint*, unsigned, const GValue *params, void*)
 {
@@ -135,6 +156,7 @@ void initialize()
                 realizeSignalId, (GQuark)0, realizeHook,
                 0, nullptr);
         }
+        gdk_window_add_filter(nullptr, ownerFilter, nullptr);
     }
 }
 
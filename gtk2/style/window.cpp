@@ -47,6 +47,9 @@ typedef struct {
     int timer;
     GtkWidget *widget;
     bool locked;
+    // Composed background, dropped when the window is resized
+    cairo_surface_t *bgnd;
+    BgndKey bgndKey;
 } QtCWindow;
 
 static GHashTable *table = nullptr;
@@ -66,6 +69,7 @@ lookupHash(void *hash, bool create)
         rv->width = rv->height = rv->timer = 0;
         rv->widget = nullptr;
         rv->locked = false;
+        rv->bgnd = nullptr;
         g_hash_table_insert(table, hash, rv);
         rv = (QtCWindow*)g_hash_table_lookup(table, hash);
     }
@@ -73,17 +77,42 @@ lookupHash(void *hash, bool create)
 }
 
 static void
-removeFromHash(void *hash)
+dropBgnd(QtCWindow *window)
 {
-    if (table) {
-        QtCWindow *tv = lookupHash(hash, false);
-        if (tv) {
-            if (tv->timer) {
-                g_source_remove(tv->timer);
-                g_object_unref(G_OBJECT(tv->widget));
-            }
-            g_hash_table_remove(table, hash);
+    if (window->bgnd) {
+        cairo_surface_destroy(window->bgnd);
+        window->bgnd = nullptr;
+    }
+}
+
+static void
+forget(void *hash)
+{
+    QtCWindow *tv = lookupHash(hash, false);
+    if (tv) {
+        if (tv->timer) {
+            g_source_remove(tv->timer);
+            g_object_unref(G_OBJECT(tv->widget));
         }
+        dropBgnd(tv);
+        g_hash_table_remove(table, hash);
+    }
+}
+
+// "destroy-event" is rarely emitted, make sure the cached background does
+// not outlive the window.
+static void
+finalized(void*, GObject *widget)
+{
+    forget(widget);
+}
+
+static void
+removeFromHash(void *hash)
+{
+    if (table && lookupHash(hash, false)) {
+        g_object_weak_unref(G_OBJECT(hash), finalized, nullptr);
+        forget(hash);
     }
 }
 
@@ -249,6 +278,9 @@ configure(GtkWidget*, GdkEventConfigure *event, void *data)
                    event->height != window->height)) {
         window->width = event->width;
         window->height = event->height;
+        // Not cached again until the delayed update, the size keeps
+        // changing while the window is being resized.
+        dropBgnd(window);
 
         // schedule delayed timeOut
         if (!window->timer) {
@@ -388,6 +420,31 @@ mapWindow(GtkWidget *widget, GdkEventKey*, void*)
     return false;
 }
 
+cairo_surface_t*
+cachedBgnd(GtkWidget *topLevel, const BgndKey &key, bool *cacheable)
+{
+    QtCWindow *window = topLevel ? lookupHash(topLevel, false) : nullptr;
+    *cacheable = window && !window->timer;
+    if (*cacheable && window->bgnd && window->bgndKey == key) {
+        return window->bgnd;
+    }
+    return nullptr;
+}
+
+void
+setCachedBgnd(GtkWidget *topLevel, const BgndKey &key,
+              cairo_surface_t *surface)
+{
+    QtCWindow *window = lookupHash(topLevel, false);
+    if (!window) {
+        cairo_surface_destroy(surface);
+        return;
+    }
+    dropBgnd(window);
+    window->bgnd = surface;
+    window->bgndKey = key;
+}
+
 bool
 isActive(GtkWidget *widget)
 {
@@ -411,6 +468,7 @@ setup(GtkWidget *widget, int opacity)
                 window->width = alloc.width;
                 window->height = alloc.height;
                 window->widget = widget;
+                g_object_weak_ref(G_OBJECT(widget), finalized, nullptr);
             }
         }
         props->windowDestroy.conn("destroy-event", destroy);
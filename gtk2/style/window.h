@@ -23,11 +23,32 @@
 #define __QTC_WINDOW_H__
 
 #include <gtk/gtk.h>
+#include <cairo.h>
 #include <stdint.h>
 
 namespace QtCurve {
 namespace Window {
 
+/**
+ * What the composed background of a toplevel window depends on besides the
+ * options, see drawWindowBgnd.
+ */
+struct BgndKey {
+    int width;
+    int height;
+    uint16_t red;
+    uint16_t green;
+    uint16_t blue;
+    int opacity;
+    bool
+    operator==(const BgndKey &other) const
+    {
+        return (width == other.width && height == other.height &&
+                red == other.red && green == other.green &&
+                blue == other.blue && opacity == other.opacity);
+    }
+};
+
 bool isActive(GtkWidget *widget);
 bool setup(GtkWidget *widget, int opacity);
 GtkWidget *getMenuBar(GtkWidget *parent, int level);
@@ -35,6 +56,14 @@ bool setStatusBarProp(GtkWidget *w);
 GtkWidget *getStatusBar(GtkWidget *parent, int level);
 void statusBarDBus(GtkWidget *widget, bool state);
 void menuBarDBus(GtkWidget *widget, int32_t size);
+// Returns the background cached for topLevel if it was composed for the same
+// key. cacheable is set to whether a new one can be stored, which is not the
+// case for windows that are not set up or are being resized.
+cairo_surface_t *cachedBgnd(GtkWidget *topLevel, const BgndKey &key,
+                            bool *cacheable);
+// Takes ownership of the surface.
+void setCachedBgnd(GtkWidget *topLevel, const BgndKey &key,
+                   cairo_surface_t *surface);
 
 }
 }
@@ -22,6 +22,10 @@
 
 #include "color.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#endif
+
 static void
 qtcColorHCYFromColor(const QtcColor *color, QtcColorHCY *hcy)
 {
@@ -374,46 +378,162 @@ _qtcCalcRingAlphas(const QtcColor *bgnd)
     qtc_ring_alpha[2] = v * 0.55;
 }
 
+// qtcAdjustPix: every color channel becomes `color - source` (clamped to
+// [0, 255]), where source is the second byte of the pixel before it is
+// changed. The byte order is a template parameter so that the per pixel
+// loop does not switch on it, four channels images also go through a SSE2
+// or AVX2 kernel.
+template<QtcPixelByteOrder order>
+static inline void
+adjustPixScalar(unsigned char *pix, int num, int numChannels,
+                int r, int g, int b)
+{
+    typedef QtCurve::PixelOrder<order> Order;
+    for (int i = 0;i < num;i++, pix += numChannels) {
+        unsigned char source = pix[1];
+        pix[Order::R] = qtcBound(0, r - source, 255);
+        pix[Order::G] = qtcBound(0, g - source, 255);
+        pix[Order::B] = qtcBound(0, b - source, 255);
+    }
+}
+
+// Color of a pixel as 16 bits words. The colors are bound to [0, 510] so
+// that `color - source` fits in a word and saturates to the same value as
+// with the original color.
+template<QtcPixelByteOrder order>
+static inline void
+adjustPixWords(short words[4], int r, int g, int b)
+{
+    typedef QtCurve::PixelOrder<order> Order;
+    words[Order::R] = qtcBound(0, r, 510);
+    words[Order::G] = qtcBound(0, g, 510);
+    words[Order::B] = qtcBound(0, b, 510);
+    words[Order::A] = 0;
+}
+
+#ifdef __SSE2__
+// 4 pixels per iteration, returns the number of pixels done.
+template<QtcPixelByteOrder order>
+static int
+adjustPixSSE2(unsigned char *pix, int num, int r, int g, int b)
+{
+    typedef QtCurve::PixelOrder<order> Order;
+    short words[4];
+    adjustPixWords<order>(words, r, g, b);
+    const __m128i color = _mm_setr_epi16(words[0], words[1], words[2],
+                                         words[3], words[0], words[1],
+                                         words[2], words[3]);
+    const __m128i keep = _mm_set1_epi32(int(0xffu << (Order::A * 8)));
+    const __m128i zero = _mm_setzero_si128();
+    int done = num & ~3;
+    for (int i = 0;i < done;i += 4, pix += 16) {
+        __m128i src = _mm_loadu_si128((const __m128i*)pix);
+        __m128i lo = _mm_unpacklo_epi8(src, zero);
+        __m128i hi = _mm_unpackhi_epi8(src, zero);
+        // Broadcast the second byte of each pixel
+        lo = _mm_shufflelo_epi16(_mm_shufflehi_epi16(lo, 0x55), 0x55);
+        hi = _mm_shufflelo_epi16(_mm_shufflehi_epi16(hi, 0x55), 0x55);
+        __m128i res = _mm_packus_epi16(_mm_sub_epi16(color, lo),
+                                       _mm_sub_epi16(color, hi));
+        res = _mm_or_si128(_mm_andnot_si128(keep, res),
+                           _mm_and_si128(keep, src));
+        _mm_storeu_si128((__m128i*)pix, res);
+    }
+    return done;
+}
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define QTC_ADJUST_PIX_AVX2
+
+// Same as adjustPixSSE2 with 8 pixels per iteration. Unpack, shuffle and
+// pack all work within the 128 bits lanes so the pixels stay in order.
+template<QtcPixelByteOrder order>
+__attribute__((target("avx2"))) static int
+adjustPixAVX2(unsigned char *pix, int num, int r, int g, int b)
+{
+    typedef QtCurve::PixelOrder<order> Order;
+    short words[4];
+    adjustPixWords<order>(words, r, g, b);
+    const __m256i color = _mm256_setr_epi16(
+        words[0], words[1], words[2], words[3],
+        words[0], words[1], words[2], words[3],
+        words[0], words[1], words[2], words[3],
+        words[0], words[1], words[2], words[3]);
+    const __m256i keep = _mm256_set1_epi32(
+        int(0xffu << (Order::A * 8)));
+    const __m256i zero = _mm256_setzero_si256();
+    int done = num & ~7;
+    for (int i = 0;i < done;i += 8, pix += 32) {
+        __m256i src = _mm256_loadu_si256((const __m256i*)pix);
+        __m256i lo = _mm256_unpacklo_epi8(src, zero);
+        __m256i hi = _mm256_unpackhi_epi8(src, zero);
+        lo = _mm256_shufflelo_epi16(_mm256_shufflehi_epi16(lo, 0x55), 0x55);
+        hi = _mm256_shufflelo_epi16(_mm256_shufflehi_epi16(hi, 0x55), 0x55);
+        __m256i res = _mm256_packus_epi16(_mm256_sub_epi16(color, lo),
+                                          _mm256_sub_epi16(color, hi));
+        res = _mm256_or_si256(_mm256_andnot_si256(keep, res),
+                              _mm256_and_si256(keep, src));
+        _mm256_storeu_si256((__m256i*)pix, res);
+    }
+    return done;
+}
+
+static bool
+hasAVX2()
+{
+    static const bool res = [] {
+        __builtin_cpu_init();
+        return bool(__builtin_cpu_supports("avx2"));
+    }();
+    return res;
+}
+#endif
+
+template<QtcPixelByteOrder order>
+static void
+adjustPix(unsigned char *data, int numChannels, int w, int h, int stride,
+          int r, int g, int b)
+{
+    for (int row = 0;row < h;row++, data += stride) {
+        int done = 0;
+        if (numChannels == 4) {
+#ifdef QTC_ADJUST_PIX_AVX2
+            if (hasAVX2()) {
+                done = adjustPixAVX2<order>(data, w, r, g, b);
+            }
+#endif
+#ifdef __SSE2__
+            done += adjustPixSSE2<order>(data + done * 4, w - done, r, g, b);
+#endif
+        }
+        adjustPixScalar<order>(data + done * numChannels, w - done,
+                               numChannels, r, g, b);
+    }
+}
+
 QTC_EXPORT void
 qtcAdjustPix(unsigned char *data, int numChannels, int w, int h, int stride,
              int ro, int go, int bo, double shade,
              QtcPixelByteOrder byte_order)
 {
-    int width = w * numChannels;
-    int offset = 0;
     int r = (int)(ro * shade + 0.5);
     int g = (int)(go * shade + 0.5);
     int b = (int)(bo * shade + 0.5);
 
-    for (int row = 0;row < h;row++) {
-        for (int column = 0;column < width;column += numChannels) {
-            unsigned char source = data[offset + column + 1];
-            int new_r = qtcBound(0, r - source, 255);
-            int new_g = qtcBound(0, g - source, 255);
-            int new_b = qtcBound(0, b - source, 255);
-            switch (byte_order) {
-            case QTC_PIXEL_ARGB:
-                /* ARGB */
-                data[offset + column + 1] = new_r;
-                data[offset + column + 2] = new_g;
-                data[offset + column + 3] = new_b;
-                break;
-            case QTC_PIXEL_BGRA:
-                /* BGRA */
-                data[offset + column] = new_b;
-                data[offset + column + 1] = new_g;
-                data[offset + column + 2] = new_r;
-                break;
-            default:
-            case QTC_PIXEL_RGBA:
-                /* GdkPixbuf is RGBA */
-                data[offset + column] = new_r;
-                data[offset + column + 1] = new_g;
-                data[offset + column + 2] = new_b;
-                break;
-            }
-        }
-        offset += stride;
+    switch (byte_order) {
+    case QTC_PIXEL_ARGB:
+        adjustPix<QTC_PIXEL_ARGB>(data, numChannels, w, h, stride, r, g, b);
+        break;
+    case QTC_PIXEL_BGRA:
+        adjustPix<QTC_PIXEL_BGRA>(data, numChannels, w, h, stride, r, g, b);
+        break;
+    default:
+    case QTC_PIXEL_RGBA:
+        /* GdkPixbuf is RGBA */
+        adjustPix<QTC_PIXEL_RGBA>(data, numChannels, w, h, stride, r, g, b);
+        break;
     }
 }
 
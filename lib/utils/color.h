@@ -212,6 +212,31 @@ void qtcAdjustPix(unsigned char *data, int numChannels, int w, int h,
                   int stride, int ro, int go, int bo, double shade,
                   QtcPixelByteOrder byte_order);
 
+namespace QtCurve {
+
+/**
+ * Offsets of the channels of a 32 bits pixel in memory.
+ */
+template<QtcPixelByteOrder order>
+struct PixelOrder;
+
+template<>
+struct PixelOrder<QTC_PIXEL_ARGB> {
+    enum {R = 1, G = 2, B = 3, A = 0};
+};
+
+template<>
+struct PixelOrder<QTC_PIXEL_BGRA> {
+    enum {R = 2, G = 1, B = 0, A = 3};
+};
+
+template<>
+struct PixelOrder<QTC_PIXEL_RGBA> {
+    enum {R = 0, G = 1, B = 2, A = 3};
+};
+
+}
+
 #ifndef QTC_UTILS_INTERNAL
 
 #ifdef QTC_UTILS_QT
@@ -22,6 +22,8 @@
 #include "dirs.h"
 #include "log.h"
 #include "strs.h"
+#include "ini.h"
+#include "process.h"
 
 #include <config.h>
 
@@ -32,6 +34,8 @@
 #include <sys/types.h>
 #include <dirent.h>
 #include <libgen.h>
+#include <ctype.h>
+#include <time.h>
 
 namespace QtCurve {
 
@@ -114,6 +118,134 @@ getXDGDataHome()
     return dir.get();
 }
 
+QTC_EXPORT const char*
+getXDGCacheHome()
+{
+    static uniqueStr dir = [] {
+        const char *env_home = getenv("XDG_CACHE_HOME");
+        if (env_home && *env_home == '/') {
+            return Str::cat(env_home, "/");
+        } else {
+            return Str::cat(getHome(), ".cache/");
+        }
+    };
+    return dir.get();
+}
+
+// kde4-config
+// Running kde4-config on every startup is slow and can stall for the whole
+// timeout, so it is only run in a background process which saves its
+// answers in ~/.cache/qtcurve/kde4-config for the next startups.
+#define KDE4_CONFIG_CACHE "qtcurve/kde4-config"
+#define KDE4_CONFIG_CACHE_AGE (24 * 60 * 60)
+
+struct KDE4Config {
+    uniqueStr localPrefix;
+    uniqueStr iconsPrefix;
+};
+
+static char*
+runKDE4Config(const char *arg1, const char *arg2)
+{
+    size_t len = 0;
+    const char *const args[] = {"kde4-config", arg1, arg2, nullptr};
+    char *res = qtcPopenStdout("kde4-config", args, 1000, &len);
+    if (res) {
+        while (len > 0 && isspace(res[len - 1])) {
+            res[--len] = '\0';
+        }
+    }
+    return res;
+}
+
+static void
+refreshKDE4ConfigCache(void*)
+{
+    uniqueStr local_prefix(runKDE4Config("--localprefix", nullptr));
+    uniqueStr icons_prefix(runKDE4Config("--install", "icon"));
+    // Saved even if kde4-config is not installed so that it is not tried
+    // again on every startup.
+    uniqueStr dir(Str::cat(getXDGCacheHome(), "qtcurve/"));
+    makePath(dir.get(), 0700);
+    uniqueStr path(Str::cat(getXDGCacheHome(), KDE4_CONFIG_CACHE));
+    Str::Buff<1024> tmp_path;
+    tmp_path.printf("%s.tmp-%d", path.get(), int(getpid()));
+    FILE *f = fopen(tmp_path.get(), "w");
+    if (!f) {
+        return;
+    }
+    fprintf(f, "[kde4-config]\nlocalprefix=%s\nicon=%s\n",
+            local_prefix.get() ? local_prefix.get() : "",
+            icons_prefix.get() ? icons_prefix.get() : "");
+    if (fclose(f) == 0) {
+        rename(tmp_path.get(), path.get());
+    } else {
+        unlink(tmp_path.get());
+    }
+}
+
+static const KDE4Config&
+getKDE4Config()
+{
+    static const KDE4Config config = [] {
+        KDE4Config res{nullptr, nullptr};
+        uniqueStr path(Str::cat(getXDGCacheHome(), KDE4_CONFIG_CACHE));
+        Ini::File file(path.get());
+        if (file.isValid()) {
+            Ini::Tokenizer tokenizer = file.tokenizer();
+            Ini::Token token;
+            while ((token = tokenizer.next()) != Ini::Token::End) {
+                const StrView &value = tokenizer.value();
+                if (token != Ini::Token::Entry || value.empty()) {
+                    continue;
+                }
+                if (tokenizer.key() == "localprefix") {
+                    res.localPrefix.reset(strndup(value.str, value.len));
+                } else if (tokenizer.key() == "icon") {
+                    res.iconsPrefix.reset(strndup(value.str, value.len));
+                }
+            }
+        }
+        struct stat stats;
+        if (stat(path.get(), &stats) != 0 ||
+            stats.st_mtime + KDE4_CONFIG_CACHE_AGE < time(nullptr)) {
+            qtcForkBackground(refreshKDE4ConfigCache, nullptr);
+        }
+        return res;
+    }();
+    return config;
+}
+
+QTC_EXPORT const char*
+getKDE4LocalPrefix()
+{
+    static uniqueStr dir = [] {
+        const char *env = getenv(getuid() ? "KDEHOME" : "KDEROOTHOME");
+        if (env && *env == '/') {
+            return strdup(env);
+        }
+        if (const char *cached = getKDE4Config().localPrefix.get()) {
+            return strdup(cached);
+        }
+        // according to kdecore/kernel/kstandarddirs.h, ~/.kde is the default
+        // for KDEHOME, some distributions use ~/.kde4 instead.
+        char *kde4 = Str::cat(getHome(), ".kde4");
+        if (isDir(kde4)) {
+            return kde4;
+        }
+        free(kde4);
+        return Str::cat(getHome(), ".kde");
+    };
+    return dir.get();
+}
+
+QTC_EXPORT const char*
+getKDE4IconsPrefix(const char *def)
+{
+    const char *cached = getKDE4Config().iconsPrefix.get();
+    return cached ? cached : def;
+}
+
 // TODO
 const std::forward_list<uniqueStr>&
 getKDE4Home()
@@ -61,6 +61,27 @@ const char *getXDGDataHome();
  */
 const char *getXDGConfigHome();
 
+/**
+ * Get XDG_CACHE_HOME directory. This is usually `~/.cache/`
+ * The returned string is guaranteed to end with '/'
+ */
+const char *getXDGCacheHome();
+
+/**
+ * Get the KDE 4 local prefix (KDEHOME), as `kde4-config --localprefix` would
+ * report it, without running `kde4-config`. The answer comes from the
+ * environment, from the cache written by a previous background run of
+ * `kde4-config` or from the default directories, in this order.
+ */
+const char *getKDE4LocalPrefix();
+
+/**
+ * Get the KDE 4 icon directory (`kde4-config --install icon`), see
+ * getKDE4LocalPrefix(). \param def is returned when the cache has no answer
+ * yet.
+ */
+const char *getKDE4IconsPrefix(const char *def);
+
 /**
  * Return the absolute path of \param file with the QtCurve configure directory
  * as the current directory. If the optional argument \param buff is not NULL
@@ -173,6 +173,9 @@ class GtkWidgetProps {
         DEF_WIDGET_SIG_CONN_PROPS(windowKeyRelease);
         DEF_WIDGET_SIG_CONN_PROPS(windowMap);
         DEF_WIDGET_SIG_CONN_PROPS(windowClientEvent);
+
+        DEF_WIDGET_SIG_CONN_PROPS(animWindowState);
+        DEF_WIDGET_SIG_CONN_PROPS(animMap);
 #undef DEF_WIDGET_SIG_CONN_PROPS
     };
 
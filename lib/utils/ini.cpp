@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "ini.h"
+#include "log.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace QtCurve {
+namespace Ini {
+
+static inline bool
+isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline StrView
+trimmed(const char *start, const char *end)
+{
+    while (start < end && isBlank(*start)) {
+        start++;
+    }
+    while (end > start && isBlank(end[-1])) {
+        end--;
+    }
+    return StrView{start, size_t(end - start)};
+}
+
+QTC_EXPORT Token
+Tokenizer::next()
+{
+    while (m_pos < m_end) {
+        const char *eol = (const char*)memchr(m_pos, '\n', m_end - m_pos);
+        if (!eol) {
+            eol = m_end;
+        }
+        StrView line = trimmed(m_pos, eol);
+        m_pos = eol < m_end ? eol + 1 : m_end;
+        if (line.empty() || line.str[0] == '#') {
+            continue;
+        }
+        if (line.str[0] == '[') {
+            if (line.len < 2 || line.str[line.len - 1] != ']') {
+                continue;
+            }
+            m_group = StrView{line.str + 1, line.len - 2};
+            return Token::Group;
+        }
+        const char *eq = (const char*)memchr(line.str, '=', line.len);
+        if (!eq) {
+            continue;
+        }
+        m_key = trimmed(line.str, eq);
+        m_value = trimmed(eq + 1, line.str + line.len);
+        return Token::Entry;
+    }
+    return Token::End;
+}
+
+QTC_EXPORT
+File::File(const char *path)
+    : m_data(nullptr),
+      m_size(0),
+      m_valid(false)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            m_valid = true;
+        } else {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+                              fd, 0);
+            if (data != MAP_FAILED) {
+                m_data = (const char*)data;
+                m_size = st.st_size;
+                m_valid = true;
+            } else {
+                qtcWarn("Failed to map %s\n", path);
+            }
+        }
+    }
+    close(fd);
+}
+
+QTC_EXPORT
+File::~File()
+{
+    if (m_data) {
+        munmap((void*)m_data, m_size);
+    }
+}
+
+}
+}
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef _QTC_UTILS_INI_H_
+#define _QTC_UTILS_INI_H_
+
+#include "utils.h"
+#include "number.h"
+
+namespace QtCurve {
+
+/**
+ * Non-owning, not NUL terminated, view of a string.
+ */
+struct StrView {
+    const char *str;
+    size_t len;
+
+    bool
+    empty() const
+    {
+        return len == 0;
+    }
+    bool
+    operator==(const char *other) const
+    {
+        return strncmp(str, other, len) == 0 && other[len] == '\0';
+    }
+    bool
+    operator!=(const char *other) const
+    {
+        return !(*this == other);
+    }
+    bool
+    equalsNoCase(const char *other) const
+    {
+        return strncasecmp(str, other, len) == 0 && other[len] == '\0';
+    }
+    /**
+     * Copy the view to \param buff (of \param size bytes) as a NUL
+     * terminated string, truncating it if necessary.
+     */
+    char*
+    copy(char *buff, size_t size) const
+    {
+        size_t n = qtcMin(len, size - 1);
+        memcpy(buff, str, n);
+        buff[n] = '\0';
+        return buff;
+    }
+};
+
+namespace Ini {
+
+enum class Token {
+    End,
+    Group,
+    Entry
+};
+
+/**
+ * Single pass tokenizer of KConfig style ini files.
+ *
+ * Returns the group headers and the `key=value` entries of the buffer in
+ * order, as views into the buffer, so nothing is copied or allocated and
+ * the buffer does not need to be NUL terminated. Surrounding whitespace is
+ * stripped, empty lines, `#` comments and lines without a `=` are skipped.
+ * Nested groups (`[a][b]`) are returned as `a][b`, keys keep their locale
+ * or `[$e]` suffix.
+ */
+class Tokenizer {
+public:
+    Tokenizer(const char *data, size_t len)
+        : m_pos(data),
+          m_end(data + len),
+          m_group{data, 0},
+          m_key{data, 0},
+          m_value{data, 0}
+    {
+    }
+    Token next();
+    const StrView&
+    group() const
+    {
+        return m_group;
+    }
+    const StrView&
+    key() const
+    {
+        return m_key;
+    }
+    const StrView&
+    value() const
+    {
+        return m_value;
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+    StrView m_group;
+    StrView m_key;
+    StrView m_value;
+};
+
+/**
+ * Read only memory mapping of a config file.
+ */
+class File {
+public:
+    explicit File(const char *path);
+    ~File();
+    File(const File&) = delete;
+    File &operator=(const File&) = delete;
+
+    bool
+    isValid() const
+    {
+        return m_valid;
+    }
+    Tokenizer
+    tokenizer() const
+    {
+        return Tokenizer(m_data, m_size);
+    }
+
+private:
+    const char *m_data;
+    size_t m_size;
+    bool m_valid;
+};
+
+}
+}
+
+#endif
@@ -58,6 +58,18 @@ class StrMap : std::vector<std::pair<const char*, Val> > {
             return strcasecmp(a, b);
         }
     }
+    // Compare the NUL terminated \param a with the first \param len bytes
+    // of \param b.
+    static int
+    strncmp_func(const char *a, const char *b, size_t len)
+    {
+        int res = case_sens ? strncmp(a, b, len) : strncasecmp(a, b, len);
+        if (res != 0) {
+            return res;
+        }
+        size_t a_len = strnlen(a, len + 1);
+        return a_len > len ? 1 : (a_len < len ? -1 : 0);
+    }
     template<typename... Ts, int ...S>
     StrMap(seq<S...>, Ts&&... ts)
         : StrMap{{ts, Val(S)}...}
@@ -94,6 +106,27 @@ public:
         qtcAssign(is_def, false);
         return lower_it->second;
     }
+    /**
+     * Search for the first \param len bytes of \param key, which does not
+     * need to be NUL terminated.
+     */
+    Val
+    search(const char *key, size_t len, Val def, bool *is_def=nullptr) const
+    {
+        QTC_RET_IF_FAIL(key, def);
+        auto lower_it = std::lower_bound(
+            this->begin(), this->end(), key, [len] (const pair_type &a,
+                                                    const char *key) {
+                return strncmp_func(a.first, key, len) < 0;
+            });
+        if (lower_it == this->end() ||
+            strncmp_func(lower_it->first, key, len) != 0) {
+            qtcAssign(is_def, true);
+            return def;
+        }
+        qtcAssign(is_def, false);
+        return lower_it->second;
+    }
 };
 
 }
@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "mask.h"
+#include "number.h"
+
+namespace QtCurve {
+
+QTC_EXPORT
+RoundedMask::RoundedMask(std::initializer_list<int> insets, bool roundBottom)
+    : m_numBands(0),
+      m_rows(0),
+      m_roundBottom(roundBottom)
+{
+    for (int inset: insets) {
+        if (m_rows == constMaxRows) {
+            break;
+        }
+        if (m_numBands && m_bands[m_numBands - 1].inset == inset) {
+            m_bands[m_numBands - 1].height++;
+        } else {
+            m_bands[m_numBands++] = Band{m_rows, 1, inset};
+        }
+        m_rows++;
+    }
+    // Rows that are not cut belong to the middle band.
+    while (m_numBands && m_bands[m_numBands - 1].inset <= 0) {
+        m_rows -= m_bands[--m_numBands].height;
+    }
+}
+
+QTC_EXPORT int
+RoundedMask::rects(int x, int y, int w, int h, Rect *rects) const
+{
+    int count = 0;
+    auto add = [&] (int top, int height, int inset) {
+        if (height <= 0 || w <= 2 * inset) {
+            return;
+        }
+        if (count && rects[count - 1].x == x + inset &&
+            rects[count - 1].y + rects[count - 1].height == y + top) {
+            rects[count - 1].height += height;
+        } else {
+            rects[count++] = Rect{x + inset, y + top, w - 2 * inset, height};
+        }
+    };
+    // When the window is smaller than the corners the top ones get the first
+    // half of it and the bottom ones the rest.
+    int topRows = qtcMin(m_rows, m_roundBottom ? h / 2 : h);
+    int bottomRows = m_roundBottom ? qtcMin(m_rows, h - topRows) : 0;
+    for (int i = 0;i < m_numBands;i++) {
+        const Band &band = m_bands[i];
+        add(band.start, qtcMin(band.height, topRows - band.start), band.inset);
+    }
+    add(topRows, h - topRows - bottomRows, 0);
+    for (int i = m_numBands - 1;i >= 0;i--) {
+        const Band &band = m_bands[i];
+        int height = qtcMin(band.height, bottomRows - band.start);
+        add(h - band.start - height, height, band.inset);
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef _QTC_UTILS_MASK_H_
+#define _QTC_UTILS_MASK_H_
+
+#include "utils.h"
+#include <initializer_list>
+
+namespace QtCurve {
+
+/**
+ * Shape of a window with cut corners (menus, tooltips, the KWin decoration),
+ * given by how far each of the first rows of a corner is cut from the sides.
+ * The rows with the same cut are merged into bands once, a mask of any size
+ * and position is then a short list of y-x banded rectangles, as expected
+ * by QRegion::setRects(), cairo_region_create_rectangles() and the YXBanded
+ * ordering of the X shape extension, so no region union is needed.
+ *
+ * Masks are usually static objects, one per shape.
+ */
+class RoundedMask {
+public:
+    struct Rect {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+    static const int constMaxRows = 16;
+    static const int constMaxRects = constMaxRows * 2 + 1;
+
+    /**
+     * \param insets cut of the first rows of the top corners, the bottom
+     * corners are the mirror image if \param roundBottom, otherwise square.
+     */
+    RoundedMask(std::initializer_list<int> insets, bool roundBottom=true);
+
+    /**
+     * Maximum number of rectangles returned by rects(), never more than
+     * constMaxRects.
+     */
+    int
+    maxRects() const
+    {
+        return m_numBands * 2 + 1;
+    }
+    /**
+     * Fill \param rects (at least maxRects() long) with the mask of the
+     * \param w x \param h rect at (\param x, \param y) and return the number
+     * of rectangles.
+     */
+    int rects(int x, int y, int w, int h, Rect *rects) const;
+
+private:
+    struct Band {
+        int start;
+        int height;
+        int inset;
+    };
+
+    Band m_bands[constMaxRows];
+    int m_numBands;
+    int m_rows;
+    bool m_roundBottom;
+};
+
+}
+
+#endif
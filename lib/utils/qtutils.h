@@ -23,12 +23,14 @@
 #define __QTC_UTILS_QT_UTILS_H__
 
 #include "utils.h"
+#include "mask.h"
 #include <QtGlobal>
 #include <QWidget>
 #include <config.h>
 #include <QStyleOption>
 #include <QObject>
 #include <QRect>
+#include <QRegion>
 
 namespace QtCurve {
 
@@ -129,6 +131,23 @@ qtcToWidget(const QObject *obj)
     return nullptr;
 }
 
+// Region of \param mask covering \param r, set from its banded rectangles
+// in one go.
+static inline QRegion
+qtcMaskRegion(const RoundedMask &mask, const QRect &r)
+{
+    RoundedMask::Rect rects[RoundedMask::constMaxRects];
+    QRect qrects[RoundedMask::constMaxRects];
+    int n = mask.rects(r.x(), r.y(), r.width(), r.height(), rects);
+    for (int i = 0;i < n;i++) {
+        qrects[i].setRect(rects[i].x, rects[i].y,
+                          rects[i].width, rects[i].height);
+    }
+    QRegion region;
+    region.setRects(qrects, n);
+    return region;
+}
+
 class Style;
 template<class StyleType=Style, class C>
 static inline StyleType*
@@ -24,6 +24,10 @@
 
 #include <cstdlib>
 
+// The shadow is rendered row by row in float. The corner tiles are mirror
+// images of each other and the edges are one row of a corner, so only the
+// bottom-right corner and one edge are computed, the other tiles are copies.
+
 static void
 qtcCreateShadowGradient(float *buff, size_t size)
 {
@@ -33,106 +37,76 @@ qtcCreateShadowGradient(float *buff, size_t size)
     }
 }
 
-static void
-qtcFillShadowPixel(uint8_t *pixel, const QtcColor *c1,
-                   const QtcColor *c2, double bias, QtcPixelByteOrder order)
-{
-    uint8_t alpha = qtcBound(0, 0xff * bias, 0xff);
-    if (alpha == 0) {
-        memset(pixel, 0, 4);
-        return;
-    }
-    QtcColor color;
-    // c1 is the start color, c2 the end color
-    _qtcColorMix(c2, c1, bias, &color);
-    uint8_t red = qtcBound(0, 0xff * color.red, 0xff) * alpha / 0xff;
-    uint8_t green = qtcBound(0, 0xff * color.green, 0xff) * alpha / 0xff;
-    uint8_t blue = qtcBound(0, 0xff * color.blue, 0xff) * alpha / 0xff;
-    switch (order) {
-    case QTC_PIXEL_ARGB:
-        pixel[0] = alpha;
-        pixel[1] = red;
-        pixel[2] = green;
-        pixel[3] = blue;
-        break;
-    case QTC_PIXEL_BGRA:
-        pixel[0] = blue;
-        pixel[1] = green;
-        pixel[2] = red;
-        pixel[3] = alpha;
-        break;
-    default:
-    case QTC_PIXEL_RGBA:
-        pixel[0] = red;
-        pixel[1] = green;
-        pixel[2] = blue;
-        pixel[3] = alpha;
-        break;
-    }
-}
-
+// Gradient value at \param distance, linearly interpolated. The gradient
+// has one extra zero entry so that the last index does not need a branch.
 static inline float
-_qtcDistance(int x, int y, int x0, int y0, bool square)
+qtcShadowGradientValue(const float *gradient, size_t size, float distance)
 {
-    int dx = x - x0;
-    int dy = y - y0;
-    if (dx == 0) {
-        return std::abs(dy);
-    }
-    if (dy == 0) {
-        return std::abs(dx);
+    if (distance > size - 1) {
+        return 0;
     }
-    return (square ? qtcMax(std::abs(dx), std::abs(dy)) :
-            sqrtf(dx * dx + dy * dy));
+    int index = int(distance);
+    float frac = distance - index;
+    return gradient[index] * (1 - frac) + gradient[index + 1] * frac;
 }
 
-static inline float
-_qtcGradientGetValue(float *gradient, size_t size, float distance)
+// Premultiplied pixels for the alpha values (bias) \param bias, c1 is the
+// color of the opaque end and c2 the one of the transparent end.
+template<QtcPixelByteOrder order>
+static void
+qtcShadowFillRow(uint8_t *pixels, const float *bias, size_t num,
+                 const float c1[3], const float c2[3])
 {
-    if (distance < 0 || distance > size - 1) {
-        return 0;
+    typedef QtCurve::PixelOrder<order> Order;
+    for (size_t i = 0;i < num;i++, pixels += 4) {
+        float b = qtcBound(0.0f, bias[i], 1.0f);
+        int alpha = int(0xff * b);
+        pixels[Order::R] = (int(qtcBound(0.0f, 0xff * (c2[0] +
+                                                        (c1[0] - c2[0]) * b),
+                                         255.0f)) * alpha / 0xff);
+        pixels[Order::G] = (int(qtcBound(0.0f, 0xff * (c2[1] +
+                                                        (c1[1] - c2[1]) * b),
+                                         255.0f)) * alpha / 0xff);
+        pixels[Order::B] = (int(qtcBound(0.0f, 0xff * (c2[2] +
+                                                        (c1[2] - c2[2]) * b),
+                                         255.0f)) * alpha / 0xff);
+        pixels[Order::A] = alpha;
     }
-    int index = floorf(distance);
-    if (qtcEqual(index, distance)) {
-        return gradient[index];
-    }
-    return (gradient[index] * (index + 1 - distance) +
-            gradient[index + 1] * (distance - index));
 }
 
-static QtCurve::Image*
-qtcShadowSubImage(size_t size, float *gradient, int vertical_align,
-                  int horizontal_align, const QtcColor *c1, const QtcColor *c2,
-                  bool square, QtcPixelByteOrder order)
+typedef void (*QtcShadowFillFunc)(uint8_t*, const float*, size_t,
+                                  const float*, const float*);
+
+static QtcShadowFillFunc
+qtcShadowFillFunc(QtcPixelByteOrder order)
 {
-    int height = vertical_align ? size : 1;
-    int y0 = vertical_align == -1 ? height - 1 : 0;
-    int width = horizontal_align ? size : 1;
-    int x0 = horizontal_align == -1 ? width - 1 : 0;
-    auto *res = new QtCurve::Image(width, height, 4);
-    for (int x = 0;x < width;x++) {
-        for (int y = 0;y < height;y++) {
-            qtcFillShadowPixel(
-                &res->data[(x + y * width) * 4], c1, c2,
-                _qtcGradientGetValue(
-                    gradient, size, _qtcDistance(x, y, x0, y0, square)), order);
-        }
+    switch (order) {
+    case QTC_PIXEL_ARGB:
+        return qtcShadowFillRow<QTC_PIXEL_ARGB>;
+    case QTC_PIXEL_BGRA:
+        return qtcShadowFillRow<QTC_PIXEL_BGRA>;
+    default:
+    case QTC_PIXEL_RGBA:
+        return qtcShadowFillRow<QTC_PIXEL_RGBA>;
     }
-    return res;
 }
 
-void
-qtcShadowCreate(size_t size, const QtcColor *c1, const QtcColor *c2,
-                size_t radius, bool square, QtcPixelByteOrder order,
-                QtCurve::Image **images)
+QTC_EXPORT QtCurve::Image*
+qtcShadowCreateAtlas(size_t size, const QtcColor *c1, const QtcColor *c2,
+                     size_t radius, bool square, QtcPixelByteOrder order,
+                     QtcShadowTile tiles[8])
 {
-    size_t full_size = size + radius;
-    QtCurve::LocalBuff<float, 128> gradient(full_size);
+    const size_t full_size = size + radius;
+    QtCurve::LocalBuff<float, 128> gradient(full_size + 1);
     for (size_t i = 0;i < radius;i++) {
         gradient[i] = 0;
     }
     qtcCreateShadowGradient(gradient.get() + radius, size);
-    int aligns[8][2] = {
+    gradient[full_size] = 0;
+
+    // Top, top-right, right, bottom-right, bottom, bottom-left, left,
+    // top-left. Horizontal and vertical direction of the shadow.
+    static const int aligns[8][2] = {
         {0, -1},
         {1, -1},
         {1, 0},
@@ -142,8 +116,52 @@ qtcShadowCreate(size_t size, const QtcColor *c1, const QtcColor *c2,
         {-1, 0},
         {-1, -1},
     };
+    unsigned width = 0;
     for (int i = 0;i < 8;i++) {
-        images[i] = qtcShadowSubImage(full_size, gradient.get(), aligns[i][1],
-                                      aligns[i][0], c1, c2, square, order);
+        tiles[i].x = width;
+        tiles[i].width = aligns[i][0] ? full_size : 1;
+        tiles[i].height = aligns[i][1] ? full_size : 1;
+        width += tiles[i].width;
+    }
+    auto *res = new QtCurve::Image(width, full_size, 4);
+    const size_t stride = width * 4;
+    const float color1[3] = {float(c1->red), float(c1->green),
+                             float(c1->blue)};
+    const float color2[3] = {float(c2->red), float(c2->green),
+                             float(c2->blue)};
+    QtcShadowFillFunc fill = qtcShadowFillFunc(order);
+
+    // Bottom-right corner, the distance is measured from its top-left pixel.
+    QtCurve::LocalBuff<float, 128> bias(full_size);
+    uint8_t *corner = &res->data[tiles[3].x * 4];
+    for (size_t y = 0;y < full_size;y++) {
+        for (size_t x = 0;x < full_size;x++) {
+            float distance = (square ? float(qtcMax(x, y)) :
+                              sqrtf(float(x * x + y * y)));
+            bias[x] = qtcShadowGradientValue(gradient.get(), full_size,
+                                             distance);
+        }
+        fill(corner + y * stride, bias.get(), full_size, color1, color2);
+    }
+    const size_t row_size = full_size * 4;
+    for (size_t y = 0;y < full_size;y++) {
+        const uint8_t *src = corner + y * stride;
+        uint8_t *top_right = &res->data[(full_size - 1 - y) * stride +
+                                        tiles[1].x * 4];
+        uint8_t *bottom_left = &res->data[y * stride + tiles[5].x * 4];
+        uint8_t *top_left = &res->data[(full_size - 1 - y) * stride +
+                                       tiles[7].x * 4];
+        memcpy(top_right, src, row_size);
+        for (size_t x = 0;x < full_size;x++) {
+            memcpy(bottom_left + (full_size - 1 - x) * 4, src + x * 4, 4);
+        }
+        memcpy(top_left, bottom_left, row_size);
+        // The edges are the first row and column of the corners.
+        memcpy(&res->data[y * stride + tiles[4].x * 4], src, 4);
+        memcpy(&res->data[(full_size - 1 - y) * stride + tiles[0].x * 4],
+               src, 4);
     }
+    memcpy(&res->data[tiles[2].x * 4], corner, row_size);
+    memcpy(&res->data[tiles[6].x * 4], &res->data[tiles[5].x * 4], row_size);
+    return res;
 }
@@ -22,6 +22,22 @@
 #include "image.h"
 #include "color.h"
 
-void qtcShadowCreate(size_t size, const QtcColor *c1, const QtcColor *c2,
-                     size_t radius, bool square, QtcPixelByteOrder order,
-                     QtCurve::Image *images[8]);
+/**
+ * Position of a shadow tile in the atlas created by qtcShadowCreateAtlas().
+ */
+typedef struct {
+    unsigned x;
+    unsigned width;
+    unsigned height;
+} QtcShadowTile;
+
+/**
+ * Render the eight tiles of a window shadow (top, top-right, right, ...,
+ * top-left, in the order of _KDE_NET_WM_SHADOW) side by side in one image.
+ * Tile i is the \param tiles[i].width x \param tiles[i].height rectangle
+ * at (\param tiles[i].x, 0) of the returned image.
+ */
+QtCurve::Image *qtcShadowCreateAtlas(size_t size, const QtcColor *c1,
+                                     const QtcColor *c2, size_t radius,
+                                     bool square, QtcPixelByteOrder order,
+                                     QtcShadowTile tiles[8]);
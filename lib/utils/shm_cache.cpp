@@ -0,0 +1,318 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "shm_cache.h"
+#include "log.h"
+#include "strs.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+
+namespace QtCurve {
+
+static const uint32_t constShmMagic = 0x51746353; // "QtcS"
+static const uint32_t constShmVersion = 1;
+static const uint32_t constShmSlots = 4096;
+// Segments that nobody opened for that long are removed (see removeStale()).
+static const time_t constShmStaleAge = 24 * 60 * 60;
+
+// The header is followed by the slot table (offsets of the entries, 0 for
+// empty slots) and then by the entries.
+struct SharedCache::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t nslots;
+    uint32_t used;
+    uint32_t padding[3];
+
+    uint32_t*
+    slots()
+    {
+        return reinterpret_cast<uint32_t*>(this + 1);
+    }
+};
+
+// Followed by the key and by the pixels, aligned to 16 bytes.
+struct SharedCache::Entry {
+    uint64_t hash;
+    uint32_t key_len;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+};
+
+static inline size_t
+align16(size_t size)
+{
+    return (size + 15) & ~size_t(15);
+}
+
+size_t
+SharedCache::pixelOffset(size_t key_len)
+{
+    return align16(sizeof(SharedCache::Entry) + key_len);
+}
+
+QTC_EXPORT bool
+SharedCache::enabled()
+{
+    static bool _enabled = Str::convert(getenv("QTCURVE_SHARED_CACHE"), false);
+    return _enabled;
+}
+
+QTC_EXPORT uint64_t
+SharedCache::hash(const void *data, size_t len, uint64_t seed)
+{
+    // FNV-1a
+    const uint8_t *bytes = (const uint8_t*)data;
+    uint64_t res = seed;
+    for (size_t i = 0;i < len;i++) {
+        res = (res ^ bytes[i]) * 1099511628211ull;
+    }
+    return res;
+}
+
+// The segments of other versions or configs stay around until the system is
+// restarted. Whether a segment is still mapped somewhere cannot be told, but
+// every process touches its segment when opening it, so the ones that have
+// not been touched for a while are left over. Processes still using them
+// keep their mapping anyway. Only implemented where the segments are visible
+// in /dev/shm (Linux).
+static void
+removeStale(const char *name)
+{
+    DIR *dir = opendir("/dev/shm");
+    if (!dir) {
+        return;
+    }
+    // name is "/qtcurve-<uid>-<name>-<config>"
+    const char *self = name + 1;
+    size_t prefix_len = strrchr(self, '-') + 1 - self;
+    size_t len = strlen(self);
+    time_t now = time(nullptr);
+    while (struct dirent *ent = readdir(dir)) {
+        const char *other = ent->d_name;
+        if (strlen(other) != len || strncmp(other, self, prefix_len) != 0 ||
+            strspn(other + prefix_len, "0123456789abcdef") !=
+            len - prefix_len || strcmp(other, self) == 0) {
+            continue;
+        }
+        struct stat st;
+        if (fstatat(dirfd(dir), other, &st, 0) == 0 &&
+            st.st_mtime + constShmStaleAge < now) {
+            char path[sizeof(ent->d_name) + 1];
+            snprintf(path, sizeof(path), "/%s", other);
+            shm_unlink(path);
+        }
+    }
+    closedir(dir);
+}
+
+QTC_EXPORT
+SharedCache::SharedCache(const char *name, uint64_t config, size_t size)
+    : m_fd(-1),
+      m_base(nullptr),
+      m_size(0)
+{
+    // Built-in images may change between versions.
+    const char *version = qtcVersion();
+    config = hash(version, strlen(version), config);
+    snprintf(m_name, sizeof(m_name), "/qtcurve-%u-%s-%016" PRIx64,
+             (unsigned)getuid(), name, config);
+    size_t data_start = align16(sizeof(Header) +
+                                constShmSlots * sizeof(uint32_t));
+    if (size <= data_start || size > UINT32_MAX) {
+        return;
+    }
+    bool create = true;
+    m_fd = shm_open(m_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (m_fd == -1 && errno == EEXIST) {
+        create = false;
+        m_fd = shm_open(m_name, O_RDWR, 0600);
+    }
+    if (m_fd == -1) {
+        qtcWarn("Cannot open shared cache %s: %s\n", m_name, strerror(errno));
+        return;
+    }
+    if (create) {
+        if (ftruncate(m_fd, size) == -1) {
+            qtcWarn("Cannot resize shared cache %s\n", m_name);
+            unlink();
+            return;
+        }
+        // A new segment usually replaces the one of an old version or
+        // config.
+        removeStale(m_name);
+    } else {
+        // Mark the segment as used, see removeStale().
+        futimens(m_fd, nullptr);
+        struct stat st;
+        // The creator may not have resized it yet, just don't share then.
+        if (fstat(m_fd, &st) == -1 || size_t(st.st_size) <= data_start) {
+            return;
+        }
+        size = st.st_size;
+    }
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      m_fd, 0);
+    if (base == MAP_FAILED) {
+        qtcWarn("Cannot map shared cache %s\n", m_name);
+        return;
+    }
+    Header *header = (Header*)base;
+    if (create) {
+        header->version = constShmVersion;
+        header->size = size;
+        header->nslots = constShmSlots;
+        header->used = data_start;
+        // Readers only look at the segment once the magic is there.
+        __atomic_store_n(&header->magic, constShmMagic, __ATOMIC_RELEASE);
+    } else if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) !=
+               constShmMagic || header->version != constShmVersion ||
+               header->size != size || header->nslots != constShmSlots) {
+        munmap(base, size);
+        return;
+    }
+    m_base = (uint8_t*)base;
+    m_size = size;
+}
+
+QTC_EXPORT
+SharedCache::~SharedCache()
+{
+    if (m_base) {
+        munmap(m_base, m_size);
+    }
+    if (m_fd != -1) {
+        close(m_fd);
+    }
+}
+
+QTC_EXPORT void
+SharedCache::unlink()
+{
+    shm_unlink(m_name);
+}
+
+bool
+SharedCache::lookup(uint64_t hash, const void *key, size_t key_len,
+                    Image *img, uint32_t *slot) const
+{
+    Header *header = (Header*)m_base;
+    uint32_t *slots = header->slots();
+    uint32_t mask = constShmSlots - 1;
+    for (uint32_t i = 0;i < constShmSlots;i++) {
+        uint32_t idx = (hash + i) & mask;
+        uint32_t offset = __atomic_load_n(&slots[idx], __ATOMIC_ACQUIRE);
+        if (!offset) {
+            if (slot) {
+                *slot = idx;
+            }
+            return false;
+        }
+        // Another process could have written anything in here, check
+        // everything against the size of the mapping.
+        if (offset > m_size - sizeof(Entry)) {
+            continue;
+        }
+        const Entry *entry = (const Entry*)(m_base + offset);
+        if (entry->hash != hash || entry->key_len != key_len ||
+            offset + pixelOffset(key_len) + size_t(entry->stride) *
+            entry->height > m_size ||
+            memcmp(entry + 1, key, key_len) != 0) {
+            continue;
+        }
+        if (img) {
+            img->data = m_base + offset + pixelOffset(key_len);
+            img->width = entry->width;
+            img->height = entry->height;
+            img->stride = entry->stride;
+        }
+        return true;
+    }
+    if (slot) {
+        *slot = constShmSlots;
+    }
+    return false;
+}
+
+QTC_EXPORT bool
+SharedCache::find(const void *key, size_t key_len, Image *img) const
+{
+    QTC_RET_IF_FAIL(m_base, false);
+    return lookup(hash(key, key_len), key, key_len, img, nullptr);
+}
+
+QTC_EXPORT bool
+SharedCache::insert(const void *key, size_t key_len, const Image &img,
+                    Image *stored)
+{
+    QTC_RET_IF_FAIL(m_base && img.data && img.width > 0 && img.height > 0 &&
+                    img.stride > 0, false);
+    // The file lock serializes the processes but not the threads of one.
+    std::lock_guard<std::mutex> lock(m_writeLock);
+    // Never wait for another process, rendering locally is cheaper.
+    if (flock(m_fd, LOCK_EX | LOCK_NB) == -1) {
+        return false;
+    }
+    bool res = false;
+    Header *header = (Header*)m_base;
+    uint64_t key_hash = hash(key, key_len);
+    uint32_t slot;
+    if (lookup(key_hash, key, key_len, stored, &slot)) {
+        res = true;
+    } else if (slot < constShmSlots) {
+        size_t offset = align16(header->used);
+        size_t len = (pixelOffset(key_len) +
+                      size_t(img.stride) * img.height);
+        if (offset + len <= m_size) {
+            Entry *entry = (Entry*)(m_base + offset);
+            entry->hash = key_hash;
+            entry->key_len = key_len;
+            entry->width = img.width;
+            entry->height = img.height;
+            entry->stride = img.stride;
+            memcpy(entry + 1, key, key_len);
+            uint8_t *data = m_base + offset + pixelOffset(key_len);
+            memcpy(data, img.data, size_t(img.stride) * img.height);
+            header->used = offset + len;
+            // Publish the entry only once it is complete.
+            __atomic_store_n(&header->slots()[slot], uint32_t(offset),
+                             __ATOMIC_RELEASE);
+            if (stored) {
+                *stored = {data, img.width, img.height, img.stride};
+            }
+            res = true;
+        }
+    }
+    flock(m_fd, LOCK_UN);
+    return res;
+}
+
+}
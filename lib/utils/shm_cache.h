@@ -0,0 +1,112 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef _QTC_UTILS_SHM_CACHE_H_
+#define _QTC_UTILS_SHM_CACHE_H_
+
+#include "utils.h"
+#include <mutex>
+
+namespace QtCurve {
+
+/**
+ * Cache of rendered images shared by all the QtCurve processes of a user
+ * through a POSIX shared memory segment. It is opt-in, see enabled().
+ *
+ * The segment is append only. Writers are serialized by a lock on the
+ * segment, they append an entry and then publish its offset in a hash table.
+ * Readers never lock. Entries are never moved or removed so the pixels
+ * returned by find() stay valid as long as the SharedCache object is alive
+ * and can be wrapped in a QImage or a cairo surface without copying.
+ * When the segment is full new entries are simply not shared.
+ *
+ * Keys are arbitrary byte strings compared in full, they must hold every
+ * input of the rendering. The pixel format is up to the caller, so it
+ * should be part of the name or of the key.
+ *
+ * Segments of other versions or configs that have not been opened for a day
+ * are removed when a new segment is created.
+ */
+class SharedCache {
+public:
+    struct Image {
+        const uint8_t *data;
+        int width;
+        int height;
+        int stride;
+    };
+
+    /**
+     * Map (or create) the segment of \param name and \param config (usually
+     * a hash of the options the rendering depends on) for the current user
+     * and QtCurve version.
+     * \param size size of the segment, only used when creating it.
+     */
+    SharedCache(const char *name, uint64_t config,
+                size_t size=8 * 1024 * 1024);
+    ~SharedCache();
+    SharedCache(const SharedCache&) = delete;
+    SharedCache &operator=(const SharedCache&) = delete;
+
+    /**
+     * Whether the shared cache is enabled (QTCURVE_SHARED_CACHE=1).
+     */
+    static bool enabled();
+    static uint64_t hash(const void *data, size_t len,
+                         uint64_t seed=14695981039346656037ull);
+
+    bool
+    isValid() const
+    {
+        return m_base != nullptr;
+    }
+    bool find(const void *key, size_t key_len, Image *img) const;
+    /**
+     * Copy \param img into the cache. Return false if the entry could not
+     * be added (segment full or another process is writing), otherwise set
+     * \param stored (if not NULL) to the shared copy.
+     */
+    bool insert(const void *key, size_t key_len, const Image &img,
+                Image *stored=nullptr);
+    /**
+     * Remove the name of the segment, processes that have already mapped
+     * it keep using it.
+     */
+    void unlink();
+
+private:
+    struct Header;
+    struct Entry;
+
+    static size_t pixelOffset(size_t key_len);
+    bool lookup(uint64_t hash, const void *key, size_t key_len,
+                Image *img, uint32_t *slot) const;
+
+    char m_name[64];
+    int m_fd;
+    uint8_t *m_base;
+    size_t m_size;
+    std::mutex m_writeLock;
+};
+
+}
+
+#endif
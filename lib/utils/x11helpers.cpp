@@ -34,6 +34,7 @@ static int shadow_size = 30;
 #include "log.h"
 #include "number.h"
 #include "shadow_p.h"
+#include "shm_cache.h"
 #include "x11utils_p.h"
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
@@ -56,22 +57,155 @@ static uint32_t shadow_data_xcb[8 + 4];
  **/
 static unsigned long shadow_data_xlib[8 + 4];
 
-static xcb_pixmap_t
-qtcX11ShadowCreatePixmap(const QtCurve::Image *data)
+/**
+ * With the shared cache enabled (see SharedCache::enabled()) the first
+ * process publishes its shadow pixmaps in the _QTCURVE_SHADOW_ property of
+ * the root window as {version, config hash, pixmaps[8]} and claims the
+ * _QTCURVE_SHADOW_S<screen> selection with a window of its own. Other
+ * processes with the same shadow settings reuse the pixmaps instead of
+ * uploading their own. The pixmaps belong to the publisher, the borrowers
+ * watch the selection owner window and replace the pixmaps when it is
+ * destroyed, which the X server also does when the publisher dies.
+ **/
+static const uint32_t shadow_shared_version = 2;
+static bool shadow_shared = false;
+// The selection owner, created by us when we publish, else the publisher.
+static xcb_window_t shadow_owner = 0;
+
+static uint32_t
+qtcX11ShadowConfigHash(int radius, const QtcColor *c1, const QtcColor *c2)
+{
+    const double config[] = {double(shadow_size), double(radius),
+                             c1->red, c1->green, c1->blue,
+                             c2->red, c2->green, c2->blue,
+                             double(QTC_PIXEL_XCB)};
+    uint64_t hash = QtCurve::SharedCache::hash(qtcVersion(),
+                                               strlen(qtcVersion()));
+    hash = QtCurve::SharedCache::hash(config, sizeof(config), hash);
+    return uint32_t(hash ^ (hash >> 32));
+}
+
+// Whether shadow_xpixmaps are the pixmaps of a shadow of full_size.
+static bool
+qtcX11ShadowPixmapsValid(int full_size)
 {
-    xcb_pixmap_t pixmap = qtcX11GenerateId();
+    // One round trip for the eight pixmaps
+    xcb_get_geometry_cookie_t cookies[8];
+    for (int i = 0;i < 8;i++) {
+        cookies[i] = xcb_get_geometry(qtc_xcb_conn, shadow_xpixmaps[i]);
+    }
+    bool valid = true;
+    for (int i = 0;i < 8;i++) {
+        xcb_get_geometry_reply_t *geom =
+            xcb_get_geometry_reply(qtc_xcb_conn, cookies[i], nullptr);
+        // Tiles are in the order top, top-right, right, ... top-left.
+        int width = i % 4 == 0 ? 1 : full_size;
+        int height = i % 4 == 2 ? 1 : full_size;
+        if (!geom || geom->depth != 32 || geom->width != width ||
+            geom->height != height) {
+            valid = false;
+        }
+        free(geom);
+    }
+    return valid;
+}
+
+static void
+qtcX11ShadowWatchOwner(xcb_window_t owner, bool watch)
+{
+    const uint32_t mask = watch ? XCB_EVENT_MASK_STRUCTURE_NOTIFY : 0;
+    qtcX11CallVoid(change_window_attributes, owner, XCB_CW_EVENT_MASK,
+                   &mask);
+}
+
+// Whether the pixmaps published on the root window can be used, the owner
+// of the selection is watched from now on if they can.
+static bool
+qtcX11ShadowFindShared(uint32_t config_hash, int full_size)
+{
+    xcb_get_selection_owner_reply_t *owner_reply =
+        qtcX11Call(get_selection_owner, qtc_x11_qtc_shadow_s_default);
+    QTC_RET_IF_FAIL(owner_reply, false);
+    xcb_window_t owner = owner_reply->owner;
+    free(owner_reply);
+    if (!owner) {
+        return false;
+    }
+    // Watch before reading the property so that a publisher exiting in
+    // between is not missed. The owner window being gone already shows up
+    // as an error for the attributes request.
+    qtcX11ShadowWatchOwner(owner, true);
+    xcb_get_window_attributes_reply_t *attr =
+        qtcX11Call(get_window_attributes, owner);
+    QTC_RET_IF_FAIL(attr, false);
+    free(attr);
+    xcb_get_property_reply_t *reply =
+        qtcX11GetProperty(0, qtc_root_window, qtc_x11_qtc_shadow,
+                          XCB_ATOM_CARDINAL, 0, 10);
+    bool found = false;
+    if (reply && reply->format == 32 &&
+        xcb_get_property_value_length(reply) == 10 * sizeof(uint32_t)) {
+        const uint32_t *data = (const uint32_t*)xcb_get_property_value(reply);
+        if (data[0] == shadow_shared_version && data[1] == config_hash) {
+            memcpy(shadow_xpixmaps, data + 2, sizeof(shadow_xpixmaps));
+            found = qtcX11ShadowPixmapsValid(full_size);
+        }
+    }
+    free(reply);
+    if (found) {
+        shadow_owner = owner;
+    } else {
+        qtcX11ShadowWatchOwner(owner, false);
+    }
+    return found;
+}
+
+static void
+qtcX11ShadowPublish(uint32_t config_hash)
+{
+    shadow_owner = qtcX11GenerateId();
+    qtcX11CallVoid(create_window, XCB_COPY_FROM_PARENT, shadow_owner,
+                   qtc_root_window, -1, -1, 1, 1, 0,
+                   XCB_WINDOW_CLASS_INPUT_ONLY, XCB_COPY_FROM_PARENT,
+                   0, (const uint32_t*)nullptr);
+    uint32_t data[10] = {shadow_shared_version, config_hash};
+    memcpy(data + 2, shadow_xpixmaps, sizeof(shadow_xpixmaps));
+    qtcX11ChangeProperty(XCB_PROP_MODE_REPLACE, qtc_root_window,
+                         qtc_x11_qtc_shadow, XCB_ATOM_CARDINAL, 32,
+                         10, data);
+    qtcX11CallVoid(set_selection_owner, shadow_owner,
+                   qtc_x11_qtc_shadow_s_default, XCB_CURRENT_TIME);
+    qtcX11Flush();
+}
 
-    // create X11 pixmap
-    qtcX11CallVoid(create_pixmap, 32, pixmap, qtc_root_window,
-                   data->width, data->height);
+static void
+qtcX11ShadowUpload(int radius, const QtcColor *c1, const QtcColor *c2)
+{
+    QtcShadowTile tiles[8];
+    QtCurve::Image *atlas = qtcShadowCreateAtlas(shadow_size, c1, c2,
+                                                 radius, false,
+                                                 QTC_PIXEL_XCB, tiles);
+
+    // Upload all the tiles at once and split them on the server side.
+    xcb_pixmap_t atlas_pixmap = qtcX11GenerateId();
+    qtcX11CallVoid(create_pixmap, 32, atlas_pixmap, qtc_root_window,
+                   atlas->width, atlas->height);
     xcb_gcontext_t cid = qtcX11GenerateId();
-    qtcX11CallVoid(create_gc, cid, pixmap, 0, (const uint32_t*)0);
-    qtcX11CallVoid(put_image, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, cid,
-                   data->width, data->height, 0, 0, 0, 32, data->data.size(),
-                   (unsigned char*)&data->data[0]);
+    qtcX11CallVoid(create_gc, cid, atlas_pixmap, 0, (const uint32_t*)0);
+    qtcX11CallVoid(put_image, XCB_IMAGE_FORMAT_Z_PIXMAP, atlas_pixmap, cid,
+                   atlas->width, atlas->height, 0, 0, 0, 32,
+                   atlas->data.size(), (unsigned char*)&atlas->data[0]);
+    for (int i = 0;i < 8;i++) {
+        shadow_xpixmaps[i] = qtcX11GenerateId();
+        qtcX11CallVoid(create_pixmap, 32, shadow_xpixmaps[i],
+                       qtc_root_window, tiles[i].width, tiles[i].height);
+        qtcX11CallVoid(copy_area, atlas_pixmap, shadow_xpixmaps[i], cid,
+                       tiles[i].x, 0, 0, 0, tiles[i].width, tiles[i].height);
+    }
     qtcX11CallVoid(free_gc, cid);
+    qtcX11CallVoid(free_pixmap, atlas_pixmap);
     qtcX11Flush();
-    return pixmap;
+    delete atlas;
 }
 
 void
@@ -80,12 +214,21 @@ qtcX11ShadowInit()
     int shadow_radius = 4;
     QtcColor c1 = {0.4, 0.4, 0.4};
     QtcColor c2 = {0.2, 0.2, 0.2};
-    QtCurve::Image *shadow_images[8];
-    qtcShadowCreate(shadow_size, &c1, &c2, shadow_radius, false,
-                    QTC_PIXEL_XCB, shadow_images);
-    for (int i = 0;i < 8;i++) {
-        shadow_xpixmaps[i] = qtcX11ShadowCreatePixmap(shadow_images[i]);
-        delete shadow_images[i];
+    bool share = (QtCurve::SharedCache::enabled() && qtc_root_window &&
+                  qtc_x11_qtc_shadow && qtc_x11_qtc_shadow_s_default);
+    uint32_t config_hash = 0;
+    shadow_shared = false;
+    shadow_owner = 0;
+    if (share) {
+        config_hash = qtcX11ShadowConfigHash(shadow_radius, &c1, &c2);
+        shadow_shared = qtcX11ShadowFindShared(config_hash,
+                                               shadow_size + shadow_radius);
+    }
+    if (!shadow_shared) {
+        qtcX11ShadowUpload(shadow_radius, &c1, &c2);
+        if (share) {
+            qtcX11ShadowPublish(config_hash);
+        }
     }
 
     memcpy(shadow_data_xcb, shadow_xpixmaps, sizeof(shadow_xpixmaps));
@@ -102,6 +245,27 @@ void
 qtcX11ShadowDestroy()
 {
     QTC_RET_IF_FAIL(qtc_xcb_conn);
+    // Owned by the process which published them
+    if (shadow_shared) {
+        qtcX11ShadowWatchOwner(shadow_owner, false);
+        shadow_shared = false;
+        shadow_owner = 0;
+        return;
+    }
+    if (shadow_owner) {
+        // Unpublish before the pixmaps go away, unless another process has
+        // taken over the selection and the property with it. Destroying
+        // the owner window tells the borrowers to replace the pixmaps.
+        xcb_get_selection_owner_reply_t *reply =
+            qtcX11Call(get_selection_owner, qtc_x11_qtc_shadow_s_default);
+        if (reply && reply->owner == shadow_owner) {
+            qtcX11CallVoid(delete_property, qtc_root_window,
+                           qtc_x11_qtc_shadow);
+        }
+        free(reply);
+        qtcX11CallVoid(destroy_window, shadow_owner);
+        shadow_owner = 0;
+    }
     for (unsigned int i = 0;
          i < sizeof(shadow_xpixmaps) / sizeof(shadow_xpixmaps[0]);i++) {
         qtcX11CallVoid(free_pixmap, shadow_xpixmaps[i]);
@@ -109,6 +273,17 @@ qtcX11ShadowDestroy()
     qtcX11Flush();
 }
 
+QTC_EXPORT bool
+qtcX11ShadowOwnerDestroyed(xcb_window_t win)
+{
+    if (!shadow_shared || !win || win != shadow_owner) {
+        return false;
+    }
+    // The publisher has gone, so have the pixmaps.
+    qtcX11ShadowInit();
+    return true;
+}
+
 QTC_EXPORT void
 qtcX11ShadowInstall(xcb_window_t win, const int margins[4])
 {
@@ -239,6 +414,44 @@ qtcX11GetShortProp(xcb_window_t win, xcb_atom_t atom)
     return res;
 }
 
+QTC_EXPORT uint32_t
+qtcX11GetCardinalProps(xcb_window_t win, unsigned n, const xcb_atom_t *atoms,
+                       uint32_t *vals)
+{
+    QTC_RET_IF_FAIL(qtc_xcb_conn && win && n <= 32, 0);
+    // Send all the requests before waiting for the first reply.
+    xcb_get_property_cookie_t cookies[32];
+    for (unsigned i = 0;i < n;i++) {
+        cookies[i] = xcb_get_property(qtc_xcb_conn, 0, win, atoms[i],
+                                      XCB_ATOM_CARDINAL, 0, 1);
+    }
+    uint32_t found = 0;
+    for (unsigned i = 0;i < n;i++) {
+        xcb_get_property_reply_t *reply =
+            xcb_get_property_reply(qtc_xcb_conn, cookies[i], nullptr);
+        if (!reply) {
+            continue;
+        }
+        if (xcb_get_property_value_length(reply) > 0) {
+            const void *val = xcb_get_property_value(reply);
+            switch (reply->format) {
+            case 8:
+                vals[i] = *(const uint8_t*)val;
+                break;
+            case 16:
+                vals[i] = *(const uint16_t*)val;
+                break;
+            default:
+                vals[i] = *(const uint32_t*)val;
+                break;
+            }
+            found |= 1u << i;
+        }
+        free(reply);
+    }
+    return found;
+}
+
 static inline void
 qtcX11SetShortProp(xcb_window_t win, xcb_atom_t atom, unsigned short prop)
 {
@@ -290,6 +503,12 @@ qtcX11ShadowUninstall(xcb_window_t)
 {
 }
 
+QTC_EXPORT bool
+qtcX11ShadowOwnerDestroyed(xcb_window_t)
+{
+    return false;
+}
+
 // WM Move
 QTC_EXPORT void
 qtcX11MoveTrigger(xcb_window_t, uint32_t, uint32_t)
@@ -308,6 +527,12 @@ qtcX11GetShortProp(xcb_window_t, xcb_atom_t)
     return -1;
 }
 
+QTC_EXPORT uint32_t
+qtcX11GetCardinalProps(xcb_window_t, unsigned, const xcb_atom_t*, uint32_t*)
+{
+    return 0;
+}
+
 QTC_EXPORT void
 qtcX11SetMenubarSize(xcb_window_t, unsigned short)
 {
@@ -25,6 +25,14 @@
 #include "x11base.h"
 
 int32_t qtcX11GetShortProp(xcb_window_t win, xcb_atom_t atom);
+/**
+ * Read the first item of \param n (at most 32) CARDINAL properties of
+ * \param win in a single round trip. Bit i of the return value is set if
+ * the property atoms[i] exists, in which case its value is stored in
+ * vals[i].
+ */
+uint32_t qtcX11GetCardinalProps(xcb_window_t win, unsigned n,
+                                const xcb_atom_t *atoms, uint32_t *vals);
 void qtcX11SetMenubarSize(xcb_window_t win, unsigned short s);
 void qtcX11SetStatusBar(xcb_window_t win);
 void qtcX11SetOpacity(xcb_window_t win, unsigned short o);
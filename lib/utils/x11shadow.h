@@ -27,5 +27,11 @@
 void qtcX11ShadowInstall(xcb_window_t win);
 void qtcX11ShadowInstall(xcb_window_t win, const int margins[4]);
 void qtcX11ShadowUninstall(xcb_window_t win);
+/**
+ * To be called for every DestroyNotify event. Returns true if the window was
+ * the owner of shared shadow pixmaps, the shadows have been replaced and
+ * have to be installed again on the windows that have them.
+ **/
+bool qtcX11ShadowOwnerDestroyed(xcb_window_t win);
 
 #endif
@@ -49,11 +49,14 @@ int qtc_default_screen_no = -1;
 xcb_window_t qtc_root_window = {0};
 xcb_screen_t *qtc_default_screen = nullptr;
 static char wm_cm_s_atom_name[100] = "_NET_WM_CM_S";
+static char qtc_shadow_s_atom_name[100] = "_QTCURVE_SHADOW_S";
 
 xcb_atom_t qtc_x11_net_wm_moveresize;
 xcb_atom_t qtc_x11_net_wm_cm_s_default;
 xcb_atom_t qtc_x11_kde_net_wm_shadow;
 xcb_atom_t qtc_x11_kde_net_wm_blur_behind_region;
+xcb_atom_t qtc_x11_qtc_shadow;
+xcb_atom_t qtc_x11_qtc_shadow_s_default;
 static xcb_atom_t qtc_x11_xembed_info;
 
 static const struct {
@@ -72,6 +75,8 @@ static const struct {
     {&qtc_x11_qtc_toggle_statusbar, "_QTCURVE_TOGGLE_STATUSBAR_"},
     {&qtc_x11_qtc_opacity, "_QTCURVE_OPACITY_"},
     {&qtc_x11_qtc_bgnd, "_QTCURVE_BGND_"},
+    {&qtc_x11_qtc_shadow, "_QTCURVE_SHADOW_"},
+    {&qtc_x11_qtc_shadow_s_default, qtc_shadow_s_atom_name},
     {&qtc_x11_xembed_info, "_XEMBED_INFO"}
 };
 #define QTC_X11_ATOM_N (sizeof(qtc_x11_atoms) / sizeof(qtc_x11_atoms[0]))
@@ -163,6 +168,8 @@ qtcX11InitXcb(xcb_connection_t *conn, int screen_no)
     }
     const size_t base_len = strlen("_NET_WM_CM_S");
     sprintf(wm_cm_s_atom_name + base_len, "%d", screen_no);
+    const size_t shadow_base_len = strlen("_QTCURVE_SHADOW_S");
+    sprintf(qtc_shadow_s_atom_name + shadow_base_len, "%d", screen_no);
     qtcX11AtomsInit();
     qtcX11ShadowInit();
 }
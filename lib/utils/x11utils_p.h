@@ -33,6 +33,8 @@ extern xcb_atom_t qtc_x11_kde_net_wm_blur_behind_region;
 extern xcb_atom_t qtc_x11_kde_net_wm_shadow;
 extern xcb_atom_t qtc_x11_net_wm_moveresize;
 extern xcb_atom_t qtc_x11_net_wm_cm_s_default;
+extern xcb_atom_t qtc_x11_qtc_shadow;
+extern xcb_atom_t qtc_x11_qtc_shadow_s_default;
 
 template <typename Ret, typename Cookie, typename... Args, typename... Args2>
 static inline Ret*
@@ -49,6 +49,7 @@
 #include "shadowhelper.h"
 #include "utils.h"
 
+#include <QApplication>
 #include <QDockWidget>
 #include <QMenu>
 #include <QPainter>
@@ -58,12 +59,42 @@
 #include <qtcurve-utils/x11shadow.h>
 #include <qtcurve-utils/qtprops.h>
 
+#ifdef Q_WS_X11
+#  include <X11/Xlib.h>
+#endif
+
 namespace QtCurve {
 const char *const ShadowHelper::netWMForceShadowPropertyName =
     "_KDE_NET_WM_FORCE_SHADOW";
 const char *const ShadowHelper::netWMSkipShadowPropertyName =
     "_KDE_NET_WM_SKIP_SHADOW";
 
+// Qt4 has a single application wide event filter, the one installed
+// before is called from ours.
+static ShadowHelper *filterHelper = nullptr;
+static QCoreApplication::EventFilter prevEventFilter = nullptr;
+
+ShadowHelper::ShadowHelper(QObject *parent): QObject(parent)
+{
+    if (!filterHelper) {
+        filterHelper = this;
+        prevEventFilter = qApp->setEventFilter(x11EventFilter);
+    }
+}
+
+ShadowHelper::~ShadowHelper()
+{
+    if (filterHelper == this) {
+        QCoreApplication::EventFilter current =
+            qApp->setEventFilter(prevEventFilter);
+        // Someone has chained after us, keep theirs.
+        if (current != x11EventFilter) {
+            qApp->setEventFilter(current);
+        }
+        filterHelper = nullptr;
+    }
+}
+
 bool
 ShadowHelper::registerWidget(QWidget *widget, bool force)
 {
@@ -100,6 +131,23 @@ ShadowHelper::eventFilter(QObject *object, QEvent *event)
     return false;
 }
 
+bool
+ShadowHelper::x11EventFilter(void *message, long *result)
+{
+#ifdef Q_WS_X11
+    XEvent *event = static_cast<XEvent*>(message);
+    if (filterHelper && event->type == DestroyNotify &&
+        qtcX11ShadowOwnerDestroyed(event->xdestroywindow.window)) {
+        foreach (QWidget *widget, QApplication::topLevelWidgets()) {
+            if (QtcQWidgetProps(widget)->shadowRegistered) {
+                filterHelper->installX11Shadows(widget);
+            }
+        }
+    }
+#endif
+    return prevEventFilter && prevEventFilter(message, result);
+}
+
 bool
 ShadowHelper::acceptWidget(QWidget *widget) const
 {
@@ -60,9 +60,9 @@ public:
     static const char *const netWMForceShadowPropertyName;
     static const char *const netWMSkipShadowPropertyName;
     //! constructor
-    ShadowHelper(QObject *parent): QObject(parent)
-    {
-    }
+    ShadowHelper(QObject *parent);
+    //! destructor
+    ~ShadowHelper() override;
 
     //! register widget
     bool registerWidget(QWidget*, bool force=false);
@@ -73,6 +73,9 @@ public:
     //! event filter
     bool eventFilter(QObject*, QEvent*) override;
 
+    //! X event filter, shared shadow pixmaps can go away with their owner
+    static bool x11EventFilter(void *message, long *result);
+
 protected:
     //! accept widget
     bool acceptWidget(QWidget*) const;
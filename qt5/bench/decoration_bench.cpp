@@ -0,0 +1,208 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+// Focus switch storm replay for the KWin decoration.
+//
+// A set of windows of usual sizes is painted the way the decoration paints
+// them when the focus moves from one window to the next: the previously
+// active and the newly active window are repainted. Every repaint is done
+// once by painting the frame with the style and once through the frame
+// layer cache the decoration uses. The caption is painted in both cases.
+//
+// Usage: qtcurve-decoration-bench [-n switches] [-w windows]
+
+#include "qtcurveframelayer.h"
+
+#include <common/common.h>
+#include <qtcurve-utils/timer.h>
+
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPluginLoader>
+#include <QStyle>
+#include <QStyleOption>
+#include <QStylePlugin>
+#include <QVariantMap>
+#include <QVector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace QtCurve;
+using namespace QtCurve::KWin;
+
+static const int constTitleBarHeight = 24;
+static const int constBorder = 4;
+
+static const QSize benchSizes[] = {
+    QSize(800, 600),
+    QSize(1024, 768),
+    QSize(1280, 1024),
+    QSize(1920, 1080),
+    QSize(400, 300),
+};
+
+struct Window {
+    QSize size;
+    QImage image;
+    QString caption;
+};
+
+static void
+paintFrame(QStyle *style, QPainter *p, const QSize &size, bool active)
+{
+    const QRect r(QPoint(0, 0), size);
+    const QPalette &palette = QApplication::palette();
+    QStyleOptionTitleBar opt;
+    opt.palette = palette;
+    opt.palette.setColor(QPalette::Button,
+                         palette.color(active ? QPalette::Active :
+                                       QPalette::Inactive,
+                                       QPalette::Highlight));
+    opt.state = (QStyle::State_Horizontal | QStyle::State_Enabled |
+                 QStyle::State_Raised | QtC_StateKWin |
+                 (active ? QStyle::State_Active : QStyle::State_None));
+    opt.titleBarState = opt.state;
+    p->setRenderHint(QPainter::Antialiasing, true);
+    p->fillRect(r, palette.color(QPalette::Window));
+    opt.rect = r.adjusted(0, 6, 0, 0);
+    opt.version = TBAR_BORDER_VERSION_HACK;
+    style->drawPrimitive(QStyle::PE_FrameWindow, &opt, p, nullptr);
+    opt.version = 1;
+    opt.rect = QRect(0, 0, size.width(), constTitleBarHeight);
+    style->drawComplexControl(QStyle::CC_TitleBar, &opt, p, nullptr);
+}
+
+static void
+paintCaption(QPainter *p, const Window &window)
+{
+    p->drawText(QRect(60, 0, window.size.width() - 120, constTitleBarHeight),
+                Qt::AlignVCenter | Qt::AlignHCenter, window.caption);
+}
+
+static void
+paintDirect(QStyle *style, Window &window, bool active)
+{
+    QPainter p(&window.image);
+    paintFrame(style, &p, window.size, active);
+    paintCaption(&p, window);
+}
+
+static void
+paintCached(QStyle *style, FrameCache &cache, Window &window, bool active)
+{
+    PixmapKey key(PixmapKey::KEY_DECORATION,
+                  quint32(window.size.width() | window.size.height() << 16),
+                  quint32(active));
+    FrameLayer layer;
+    if (!cache.find(key, &layer)) {
+        QPixmap frame(window.size);
+        frame.fill(Qt::transparent);
+        QPainter framePainter(&frame);
+        paintFrame(style, &framePainter, window.size, active);
+        framePainter.end();
+        layer = FrameLayer(frame, QRect(QPoint(0, 0), window.size)
+                           .adjusted(constBorder, constTitleBarHeight,
+                                     -constBorder, -constBorder));
+        cache.insert(key, layer);
+    }
+    QPainter p(&window.image);
+    layer.render(&p);
+    paintCaption(&p, window);
+}
+
+int
+main(int argc, char **argv)
+{
+    int switches = 200;
+    int numWindows = 30;
+    for (int i = 1;i < argc - 1;i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            switches = qMax(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-w") == 0) {
+            numWindows = qMax(2, atoi(argv[++i]));
+        }
+    }
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QPluginLoader loader(QStringLiteral(QTC_BENCH_STYLE_PLUGIN));
+    auto plugin = qobject_cast<QStylePlugin*>(loader.instance());
+    QStyle *style = plugin ? plugin->create(QStringLiteral("qtcurve")) : nullptr;
+    if (!style) {
+        fprintf(stderr, "Cannot load %s: %s\n", QTC_BENCH_STYLE_PLUGIN,
+                qPrintable(loader.errorString()));
+        return 1;
+    }
+    QApplication::setStyle(style);
+
+    QVector<Window> windows(numWindows);
+    const int numSizes = sizeof(benchSizes) / sizeof(benchSizes[0]);
+    for (int i = 0;i < numWindows;i++) {
+        windows[i].size = benchSizes[i % numSizes];
+        windows[i].image = QImage(windows[i].size,
+                                  QImage::Format_ARGB32_Premultiplied);
+        windows[i].caption = QStringLiteral("Window %1 - QtCurve").arg(i);
+    }
+
+    // Alt-Tab like walk over the windows, every second switch goes back to
+    // the previous window.
+    auto focusSwitch = [numWindows] (int i, int *from, int *to) {
+        int prev = (i / 2) % numWindows;
+        int next = (prev + 1) % numWindows;
+        *from = i % 2 ? next : prev;
+        *to = i % 2 ? prev : next;
+    };
+    int from;
+    int to;
+
+    tic();
+    for (int i = 0;i < switches;i++) {
+        focusSwitch(i, &from, &to);
+        paintDirect(style, windows[from], false);
+        paintDirect(style, windows[to], true);
+    }
+    uint64_t directNs = toc();
+
+    FrameCache cache(16 << 20);
+    tic();
+    for (int i = 0;i < switches;i++) {
+        focusSwitch(i, &from, &to);
+        paintCached(style, cache, windows[from], false);
+        paintCached(style, cache, windows[to], true);
+    }
+    uint64_t cachedNs = toc();
+
+    QVariantMap stats;
+    cache.addStatistics(stats, QStringLiteral("frameCache"));
+    printf("%d windows, %d focus switches\n", numWindows, switches);
+    printf("direct: %10.0f ns/switch\n", double(directNs) / switches);
+    printf("cached: %10.0f ns/switch\n", double(cachedNs) / switches);
+    for (auto it = stats.constBegin();it != stats.constEnd();++it) {
+        printf("%s: %s\n", qPrintable(it.key()),
+               qPrintable(it.value().toString()));
+    }
+    return 0;
+}
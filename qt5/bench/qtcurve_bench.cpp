@@ -0,0 +1,600 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+// Offscreen benchmark of the QtCurve paint path.
+//
+// Every element handled by Style::drawPrimitive, Style::drawControl and
+// Style::drawComplexControl is rendered into a QImage for a matrix of sizes,
+// states and configuration presets. For each combination the time per call,
+// the number of heap allocations per call and the hit rate of the style's
+// pixmap caches are reported.
+//
+// Usage: qtcurve-bench [-n iterations] [-p preset] [-e element] [-t themedir]
+// -p and -e select presets/elements whose name contains the given string.
+
+#include <qtcurve-utils/timer.h>
+
+#include <QApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QPluginLoader>
+#include <QStyle>
+#include <QStyleOption>
+#include <QStylePlugin>
+#include <QVariantMap>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace QtCurve;
+
+static std::atomic<uint64_t> allocCount{0};
+
+#ifdef __GLIBC__
+// Count every heap allocation made by Qt and the style while painting.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void*
+malloc(size_t size) __THROW
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void*
+calloc(size_t n, size_t size) __THROW
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void*
+realloc(void *ptr, size_t size) __THROW
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+void*
+operator new(size_t size)
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void *p) noexcept
+{
+    free(p);
+}
+#endif
+
+enum class Kind {
+    Primitive,
+    Control,
+    Complex
+};
+
+static void
+initOption(QStyleOption&)
+{
+}
+
+static void
+initOption(QStyleOptionButton &opt)
+{
+    opt.text = QStringLiteral("Button");
+}
+
+static void
+initOption(QStyleOptionFrame &opt)
+{
+    opt.lineWidth = 1;
+    opt.midLineWidth = 0;
+}
+
+static void
+initOption(QStyleOptionTab &opt)
+{
+    opt.text = QStringLiteral("Tab");
+    opt.position = QStyleOptionTab::Middle;
+    opt.shape = QTabBar::RoundedNorth;
+}
+
+static void
+initOption(QStyleOptionTabBarBase &opt)
+{
+    opt.shape = QTabBar::RoundedNorth;
+}
+
+static void
+initOption(QStyleOptionTabWidgetFrame &opt)
+{
+    opt.lineWidth = 1;
+    opt.shape = QTabBar::RoundedNorth;
+}
+
+static void
+initOption(QStyleOptionHeader &opt)
+{
+    opt.text = QStringLiteral("Header");
+    opt.position = QStyleOptionHeader::Middle;
+    opt.sortIndicator = QStyleOptionHeader::SortDown;
+    opt.orientation = Qt::Horizontal;
+}
+
+static void
+initOption(QStyleOptionProgressBar &opt)
+{
+    opt.minimum = 0;
+    opt.maximum = 100;
+    opt.progress = 40;
+    opt.text = QStringLiteral("40%");
+    opt.textVisible = true;
+    opt.orientation = Qt::Horizontal;
+    opt.state |= QStyle::State_Horizontal;
+}
+
+static void
+initOption(QStyleOptionMenuItem &opt)
+{
+    opt.text = QStringLiteral("Menu item\tCtrl+M");
+    opt.menuItemType = QStyleOptionMenuItem::Normal;
+    opt.checkType = QStyleOptionMenuItem::NonExclusive;
+    opt.checked = true;
+    opt.maxIconWidth = 16;
+    opt.tabWidth = 40;
+}
+
+static void
+initOption(QStyleOptionToolBox &opt)
+{
+    opt.text = QStringLiteral("Page");
+}
+
+static void
+initOption(QStyleOptionToolBar &opt)
+{
+    opt.toolBarArea = Qt::TopToolBarArea;
+    opt.positionOfLine = QStyleOptionToolBar::OnlyOne;
+    opt.positionWithinLine = QStyleOptionToolBar::OnlyOne;
+    opt.state |= QStyle::State_Horizontal;
+}
+
+static void
+initOption(QStyleOptionDockWidget &opt)
+{
+    opt.title = QStringLiteral("Dock");
+    opt.closable = true;
+    opt.floatable = true;
+}
+
+static void
+initOption(QStyleOptionViewItem &opt)
+{
+    opt.text = QStringLiteral("Item");
+    opt.features = QStyleOptionViewItem::HasDisplay;
+    opt.viewItemPosition = QStyleOptionViewItem::Middle;
+    opt.showDecorationSelected = true;
+}
+
+static void
+initOption(QStyleOptionSizeGrip &opt)
+{
+    opt.corner = Qt::BottomRightCorner;
+}
+
+static void
+initOption(QStyleOptionToolButton &opt)
+{
+    opt.text = QStringLiteral("Tool");
+    opt.subControls = QStyle::SC_ToolButton | QStyle::SC_ToolButtonMenu;
+    opt.features = QStyleOptionToolButton::MenuButtonPopup;
+    opt.toolButtonStyle = Qt::ToolButtonTextOnly;
+    opt.arrowType = Qt::NoArrow;
+}
+
+static void
+initOption(QStyleOptionSlider &opt)
+{
+    opt.subControls = QStyle::SC_All;
+    opt.minimum = 0;
+    opt.maximum = 100;
+    opt.sliderPosition = opt.sliderValue = 30;
+    opt.pageStep = 10;
+    opt.singleStep = 1;
+    opt.orientation = Qt::Horizontal;
+    opt.tickPosition = QSlider::TicksBelow;
+    opt.tickInterval = 10;
+    opt.state |= QStyle::State_Horizontal;
+}
+
+static void
+initOption(QStyleOptionSpinBox &opt)
+{
+    opt.subControls = QStyle::SC_All;
+    opt.frame = true;
+    opt.stepEnabled = (QAbstractSpinBox::StepUpEnabled |
+                       QAbstractSpinBox::StepDownEnabled);
+    opt.buttonSymbols = QAbstractSpinBox::UpDownArrows;
+}
+
+static void
+initOption(QStyleOptionComboBox &opt)
+{
+    opt.subControls = QStyle::SC_All;
+    opt.currentText = QStringLiteral("Combo");
+    opt.editable = false;
+    opt.frame = true;
+}
+
+static void
+initOption(QStyleOptionTitleBar &opt)
+{
+    opt.subControls = QStyle::SC_All;
+    opt.text = QStringLiteral("Window");
+    opt.titleBarFlags = (Qt::Window | Qt::WindowTitleHint |
+                         Qt::WindowSystemMenuHint |
+                         Qt::WindowMinMaxButtonsHint |
+                         Qt::WindowCloseButtonHint);
+    opt.titleBarState = Qt::WindowActive;
+}
+
+static void
+initOption(QStyleOptionGroupBox &opt)
+{
+    opt.subControls = (QStyle::SC_GroupBoxFrame | QStyle::SC_GroupBoxLabel |
+                       QStyle::SC_GroupBoxCheckBox);
+    opt.text = QStringLiteral("Group");
+    opt.textAlignment = Qt::AlignLeft;
+    opt.lineWidth = 1;
+}
+
+template<typename Opt>
+static std::unique_ptr<QStyleOption>
+createOption()
+{
+    auto opt = new Opt;
+    initOption(*opt);
+    return std::unique_ptr<QStyleOption>(opt);
+}
+
+struct BenchCase {
+    Kind kind;
+    int element;
+    const char *name;
+    std::unique_ptr<QStyleOption> (*create)();
+};
+
+#define PE(name, type)                                          \
+    {Kind::Primitive, QStyle::name, #name, &createOption<type>}
+#define CE(name, type)                                          \
+    {Kind::Control, QStyle::name, #name, &createOption<type>}
+#define CC(name, type)                                          \
+    {Kind::Complex, QStyle::name, #name, &createOption<type>}
+
+// Keep in sync with the switches in qtcurve_api.cpp.
+static const BenchCase benchCases[] = {
+    PE(PE_IndicatorTabClose, QStyleOption),
+    PE(PE_Widget, QStyleOption),
+    PE(PE_PanelScrollAreaCorner, QStyleOption),
+    PE(PE_IndicatorBranch, QStyleOption),
+    PE(PE_IndicatorViewItemCheck, QStyleOptionViewItem),
+    PE(PE_IndicatorHeaderArrow, QStyleOptionHeader),
+    PE(PE_IndicatorArrowUp, QStyleOption),
+    PE(PE_IndicatorArrowDown, QStyleOption),
+    PE(PE_IndicatorArrowLeft, QStyleOption),
+    PE(PE_IndicatorArrowRight, QStyleOption),
+    PE(PE_IndicatorSpinMinus, QStyleOptionSpinBox),
+    PE(PE_IndicatorSpinPlus, QStyleOptionSpinBox),
+    PE(PE_IndicatorSpinUp, QStyleOptionSpinBox),
+    PE(PE_IndicatorSpinDown, QStyleOptionSpinBox),
+    PE(PE_IndicatorToolBarSeparator, QStyleOption),
+    PE(PE_FrameGroupBox, QStyleOptionFrame),
+    PE(PE_Frame, QStyleOptionFrame),
+    PE(PE_PanelMenuBar, QStyleOption),
+    PE(PE_FrameTabBarBase, QStyleOptionTabBarBase),
+    PE(PE_FrameStatusBar, QStyleOption),
+    PE(PE_FrameMenu, QStyleOptionFrame),
+    PE(PE_FrameDockWidget, QStyleOptionFrame),
+    PE(PE_FrameButtonTool, QStyleOptionToolButton),
+    PE(PE_PanelButtonTool, QStyleOptionToolButton),
+    PE(PE_IndicatorButtonDropDown, QStyleOptionToolButton),
+    PE(PE_IndicatorDockWidgetResizeHandle, QStyleOption),
+    PE(PE_PanelLineEdit, QStyleOptionFrame),
+    PE(PE_FrameLineEdit, QStyleOptionFrame),
+    PE(PE_IndicatorMenuCheckMark, QStyleOptionMenuItem),
+    PE(PE_IndicatorCheckBox, QStyleOptionButton),
+    PE(PE_IndicatorRadioButton, QStyleOptionButton),
+    PE(PE_IndicatorToolBarHandle, QStyleOption),
+    PE(PE_FrameFocusRect, QStyleOptionFocusRect),
+    PE(PE_FrameButtonBevel, QStyleOptionButton),
+    PE(PE_PanelButtonBevel, QStyleOptionButton),
+    PE(PE_PanelButtonCommand, QStyleOptionButton),
+    PE(PE_FrameDefaultButton, QStyleOptionButton),
+    PE(PE_FrameWindow, QStyleOptionFrame),
+    PE(PE_FrameTabWidget, QStyleOptionTabWidgetFrame),
+    PE(PE_PanelItemViewItem, QStyleOptionViewItem),
+    PE(PE_PanelTipLabel, QStyleOptionFrame),
+    PE(PE_PanelMenu, QStyleOptionFrame),
+
+    CE(CE_ToolBoxTabShape, QStyleOptionToolBox),
+    CE(CE_MenuScroller, QStyleOption),
+    CE(CE_RubberBand, QStyleOptionRubberBand),
+    CE(CE_Splitter, QStyleOption),
+    CE(CE_SizeGrip, QStyleOptionSizeGrip),
+    CE(CE_ToolBar, QStyleOptionToolBar),
+    CE(CE_DockWidgetTitle, QStyleOptionDockWidget),
+    CE(CE_HeaderEmptyArea, QStyleOption),
+    CE(CE_HeaderSection, QStyleOptionHeader),
+    CE(CE_HeaderLabel, QStyleOptionHeader),
+    CE(CE_ProgressBarGroove, QStyleOptionProgressBar),
+    CE(CE_ProgressBarContents, QStyleOptionProgressBar),
+    CE(CE_ProgressBarLabel, QStyleOptionProgressBar),
+    CE(CE_MenuBarItem, QStyleOptionMenuItem),
+    CE(CE_MenuItem, QStyleOptionMenuItem),
+    CE(CE_MenuHMargin, QStyleOption),
+    CE(CE_MenuVMargin, QStyleOption),
+    CE(CE_MenuEmptyArea, QStyleOption),
+    CE(CE_PushButton, QStyleOptionButton),
+    CE(CE_PushButtonBevel, QStyleOptionButton),
+    CE(CE_PushButtonLabel, QStyleOptionButton),
+    CE(CE_ComboBoxLabel, QStyleOptionComboBox),
+    CE(CE_MenuBarEmptyArea, QStyleOption),
+    CE(CE_TabBarTabLabel, QStyleOptionTab),
+    CE(CE_TabBarTabShape, QStyleOptionTab),
+    CE(CE_ScrollBarAddLine, QStyleOptionSlider),
+    CE(CE_ScrollBarSubLine, QStyleOptionSlider),
+    CE(CE_ScrollBarSubPage, QStyleOptionSlider),
+    CE(CE_ScrollBarAddPage, QStyleOptionSlider),
+    CE(CE_ScrollBarSlider, QStyleOptionSlider),
+    CE(CE_ToolButtonLabel, QStyleOptionToolButton),
+    CE(CE_RadioButtonLabel, QStyleOptionButton),
+    CE(CE_CheckBoxLabel, QStyleOptionButton),
+    CE(CE_ToolBoxTabLabel, QStyleOptionToolBox),
+    CE(CE_RadioButton, QStyleOptionButton),
+    CE(CE_CheckBox, QStyleOptionButton),
+
+    CC(CC_Dial, QStyleOptionSlider),
+    CC(CC_ToolButton, QStyleOptionToolButton),
+    CC(CC_GroupBox, QStyleOptionGroupBox),
+    CC(CC_SpinBox, QStyleOptionSpinBox),
+    CC(CC_Slider, QStyleOptionSlider),
+    CC(CC_TitleBar, QStyleOptionTitleBar),
+    CC(CC_ScrollBar, QStyleOptionSlider),
+    CC(CC_ComboBox, QStyleOptionComboBox),
+};
+
+#undef PE
+#undef CE
+#undef CC
+
+static const struct {
+    const char *name;
+    QSize size;
+} benchSizes[] = {
+    {"16x16", QSize(16, 16)},
+    {"100x28", QSize(100, 28)},
+    {"400x28", QSize(400, 28)},
+    {"400x300", QSize(400, 300)},
+};
+
+static const struct {
+    const char *name;
+    QStyle::State state;
+} benchStates[] = {
+    {"normal", QStyle::State_Enabled | QStyle::State_Active},
+    {"hover", (QStyle::State_Enabled | QStyle::State_Active |
+               QStyle::State_MouseOver)},
+    {"sunken", (QStyle::State_Enabled | QStyle::State_Active |
+                QStyle::State_Sunken | QStyle::State_MouseOver)},
+    {"on", QStyle::State_Enabled | QStyle::State_Active | QStyle::State_On},
+    {"focus", (QStyle::State_Enabled | QStyle::State_Active |
+               QStyle::State_HasFocus)},
+    {"disabled", QStyle::State_Active},
+};
+
+struct CacheSample {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+static CacheSample
+cacheSample(QStyle *style)
+{
+    QVariantMap stats;
+    CacheSample sample;
+    if (!QMetaObject::invokeMethod(style, "cacheStatistics",
+                                   Qt::DirectConnection,
+                                   Q_RETURN_ARG(QVariantMap, stats))) {
+        return sample;
+    }
+    for (auto it = stats.constBegin();it != stats.constEnd();++it) {
+        if (it.key().endsWith(QLatin1String(".hits"))) {
+            sample.hits += it.value().toULongLong();
+        } else if (it.key().endsWith(QLatin1String(".misses"))) {
+            sample.misses += it.value().toULongLong();
+        }
+    }
+    return sample;
+}
+
+static void
+drawCase(QStyle *style, const BenchCase &c, const QStyleOption *opt,
+         QPainter *p)
+{
+    switch (c.kind) {
+    case Kind::Primitive:
+        style->drawPrimitive((QStyle::PrimitiveElement)c.element,
+                             opt, p, nullptr);
+        break;
+    case Kind::Control:
+        style->drawControl((QStyle::ControlElement)c.element, opt, p, nullptr);
+        break;
+    case Kind::Complex:
+        style->drawComplexControl((QStyle::ComplexControl)c.element,
+                                  static_cast<const QStyleOptionComplex*>(opt),
+                                  p, nullptr);
+        break;
+    }
+}
+
+struct BenchTotals {
+    uint64_t calls = 0;
+    uint64_t ns = 0;
+    uint64_t allocs = 0;
+};
+
+static void
+runPreset(QStyle *style, const QString &preset, int iterations,
+          const char *elementFilter, BenchTotals &totals)
+{
+    const QByteArray presetName = preset.toLocal8Bit();
+    for (const auto &c: benchCases) {
+        if (elementFilter && !strstr(c.name, elementFilter)) {
+            continue;
+        }
+        for (const auto &size: benchSizes) {
+            QImage image(size.size, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
+            for (const auto &state: benchStates) {
+                std::unique_ptr<QStyleOption> opt = c.create();
+                opt->rect = QRect(QPoint(0, 0), size.size);
+                opt->state |= state.state;
+                opt->direction = Qt::LeftToRight;
+                opt->palette = QApplication::palette();
+                opt->fontMetrics = QFontMetrics(QApplication::font());
+
+                QPainter p(&image);
+                CacheSample before = cacheSample(style);
+                // Warm up, cache misses of the first call are still reported.
+                drawCase(style, c, opt.get(), &p);
+                uint64_t allocs = allocCount.load(std::memory_order_relaxed);
+                tic();
+                for (int i = 0;i < iterations;i++) {
+                    drawCase(style, c, opt.get(), &p);
+                }
+                uint64_t ns = toc();
+                allocs = allocCount.load(std::memory_order_relaxed) - allocs;
+                CacheSample after = cacheSample(style);
+                p.end();
+
+                uint64_t hits = after.hits - before.hits;
+                uint64_t lookups = hits + after.misses - before.misses;
+                char hitRate[16] = "-";
+                if (lookups) {
+                    snprintf(hitRate, sizeof(hitRate), "%.1f",
+                             100.0 * hits / lookups);
+                }
+                printf("%-12s %-36s %-8s %-9s %10.0f %8.1f %6s\n",
+                       presetName.constData(), c.name, size.name, state.name,
+                       double(ns) / iterations, double(allocs) / iterations,
+                       hitRate);
+                totals.calls += iterations;
+                totals.ns += ns;
+                totals.allocs += allocs;
+            }
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    int iterations = 100;
+    const char *presetFilter = nullptr;
+    const char *elementFilter = nullptr;
+    const char *themesDir = QTC_BENCH_THEMES_DIR;
+    for (int i = 1;i < argc - 1;i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            iterations = qMax(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-p") == 0) {
+            presetFilter = argv[++i];
+        } else if (strcmp(argv[i], "-e") == 0) {
+            elementFilter = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0) {
+            themesDir = argv[++i];
+        }
+    }
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QPluginLoader loader(QStringLiteral(QTC_BENCH_STYLE_PLUGIN));
+    auto plugin = qobject_cast<QStylePlugin*>(loader.instance());
+    if (!plugin) {
+        fprintf(stderr, "Cannot load %s: %s\n", QTC_BENCH_STYLE_PLUGIN,
+                qPrintable(loader.errorString()));
+        return 1;
+    }
+
+    // The default preset reads an empty config, i.e. the built-in defaults.
+    QList<QPair<QString, QString> > presets;
+    presets << qMakePair(QStringLiteral("default"),
+                         QStringLiteral("/dev/null"));
+    for (const QFileInfo &theme:
+             QDir(QFile::decodeName(themesDir))
+             .entryInfoList(QStringList() << QStringLiteral("*.qtcurve"),
+                            QDir::Files, QDir::Name)) {
+        presets << qMakePair(theme.completeBaseName(),
+                             theme.absoluteFilePath());
+    }
+
+    printf("%-12s %-36s %-8s %-9s %10s %8s %6s\n", "preset", "element",
+           "size", "state", "ns/call", "allocs", "hit%");
+    BenchTotals totals;
+    for (const auto &preset: presets) {
+        if (presetFilter && !preset.first.contains(
+                QString::fromLocal8Bit(presetFilter))) {
+            continue;
+        }
+        qputenv("QTCURVE_CONFIG_FILE", QFile::encodeName(preset.second));
+        QStyle *style = plugin->create(QStringLiteral("qtcurve"));
+        if (!style) {
+            fprintf(stderr, "Cannot create the QtCurve style\n");
+            return 1;
+        }
+        // Polishes the application palette like a real client would,
+        // the previous style is deleted by QApplication.
+        QApplication::setStyle(style);
+        runPreset(style, preset.first, iterations, elementFilter, totals);
+    }
+    if (totals.calls) {
+        printf("\n%" PRIu64 " calls, %.0f ns/call, %.1f allocs/call\n",
+               totals.calls, double(totals.ns) / totals.calls,
+               double(totals.allocs) / totals.calls);
+    }
+    return 0;
+}
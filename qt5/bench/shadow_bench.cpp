@@ -0,0 +1,262 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+// Benchmark of the KWin decoration shadow rendering.
+//
+// The shadow of every shadow type, size and corner shape is rendered both
+// with the QRadialGradient path QtCurveShadowCache used before and with the
+// tabulated ShadowRenderer. The time per shadow and the largest difference of
+// a color channel between the two are reported.
+//
+// Usage: qtcurve-shadow-bench [-n iterations]
+
+#include "qtcurveshadowrenderer.h"
+
+#include <qtcurve-utils/timer.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QRadialGradient>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace QtCurve;
+using namespace QtCurve::KWin;
+
+static QColor
+mixColor(const QColor &c1, const QColor &c2, qreal bias)
+{
+    return QColor::fromRgbF(c1.redF() + (c2.redF() - c1.redF()) * bias,
+                            c1.greenF() + (c2.greenF() - c1.greenF()) * bias,
+                            c1.blueF() + (c2.blueF() - c1.blueF()) * bias,
+                            c1.alphaF() + (c2.alphaF() - c1.alphaF()) * bias);
+}
+
+// The gradient corners QtCurveShadowCache::renderGradient used to draw.
+static void
+renderGradient(QPainter &p, const QRectF &rect, const QRadialGradient &rg,
+               bool hasBorder)
+{
+    p.setBrush(rg);
+    if (hasBorder) {
+        p.drawRect(rect);
+        return;
+    }
+    qreal size(rect.width() / 2.0);
+    qreal hoffset(rg.center().x() - size);
+    qreal voffset(rg.center().y() - size);
+    qreal radius(rg.radius());
+    QGradientStops stops(rg.stops());
+
+    p.drawRect(QRectF(hoffset, voffset, 2 * size - hoffset, size));
+    {
+        QLinearGradient lg(hoffset, 0.0, 2 * size + hoffset, 0.0);
+        for (int i = 0;i < stops.size();i++) {
+            qreal xx(stops[i].first * radius);
+            lg.setColorAt((size - xx) / (2. * size), stops[i].second);
+            lg.setColorAt((size + xx) / (2. * size), stops[i].second);
+        }
+        p.setBrush(lg);
+        p.drawRect(QRectF(hoffset, size + voffset, 2 * size - hoffset, 4));
+    }
+    {
+        QLinearGradient lg(0, voffset, 0, 2 * size + voffset);
+        for (int i = 0;i < stops.size();i++) {
+            qreal xx(stops[i].first * radius);
+            lg.setColorAt((size + xx) / (2. * size), stops[i].second);
+        }
+        p.setBrush(lg);
+        p.drawRect(QRectF(size - 4 + hoffset, size + voffset, 8, size));
+    }
+    for (int side = -1;side <= 1;side += 2) {
+        QRadialGradient corner(size + hoffset + 4 * side,
+                               size + 4 + voffset, radius);
+        for (int i = 0;i < stops.size();i++) {
+            QColor c(stops[i].second);
+            qreal xx(stops[i].first - 4.0 / radius);
+            if (xx < 0 && i < stops.size() - 1) {
+                qreal x1(stops[i + 1].first - 4.0 / radius);
+                c = mixColor(c, stops[i + 1].second, -xx / (x1 - xx));
+                xx = 0;
+            }
+            corner.setColorAt(xx, c);
+        }
+        p.setBrush(corner);
+        p.drawRect(side < 0 ? QRectF(hoffset, size + 4 + voffset, size - 4,
+                                     size) :
+                   QRectF(size + 4 + hoffset, size + 4 + voffset, size - 4,
+                          size));
+    }
+}
+
+struct GradientLayer {
+    qreal offset;
+    qreal gradientSize;
+    int nPoints;
+    bool sharp;
+};
+
+template<typename F>
+static void
+drawGradientLayer(QPainter &p, const QRectF &rect, const QColor &color,
+                  int hOffset, int vOffset, const GradientLayer &layer,
+                  const F &f, bool roundAllCorners)
+{
+    static const qreal fixedSize = 25.5;
+    const qreal size = rect.width() / 2;
+    const qreal hoffset = hOffset / 100. * layer.gradientSize / fixedSize;
+    const qreal voffset = vOffset / 100. * layer.gradientSize / fixedSize;
+    QRadialGradient rg(size + layer.offset * hoffset,
+                       size + layer.offset * voffset, layer.gradientSize);
+    rg.setColorAt(1, Qt::transparent);
+    QColor c = color;
+    for (int i = 0;i < layer.nPoints;i++) {
+        qreal x = qreal(i) / layer.nPoints;
+        c.setAlphaF(f(x));
+        rg.setColorAt(x, c);
+    }
+    if (layer.sharp) {
+        renderGradient(p, rect, rg, roundAllCorners);
+    } else {
+        p.setBrush(rg);
+        p.drawRect(rect);
+    }
+}
+
+static void
+gradientShadow(QImage &image, ShadowConfig::ShadowType type, int shadowSize,
+               int hOffset, int vOffset, const QColor &color,
+               bool roundAllCorners)
+{
+    static const qreal fixedSize = 25.5;
+    typedef ShadowRenderer::Gaussian Gaussian;
+    typedef ShadowRenderer::Parabolic Parabolic;
+
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(Qt::NoPen);
+    const QRectF rect(image.rect());
+    if (type == ShadowConfig::SH_ACTIVE) {
+        qreal gs = qMin<qreal>(shadowSize, (shadowSize + fixedSize) / 2);
+        drawGradientLayer(p, rect, color, hOffset, vOffset,
+                          {12, gs, int(10 * gs / fixedSize), true},
+                          Gaussian(0.85, 0.25), roundAllCorners);
+        gs = shadowSize;
+        drawGradientLayer(p, rect, color, hOffset, vOffset,
+                          {12, gs, int(10 * gs / fixedSize), false},
+                          Gaussian(0.46, 0.42), roundAllCorners);
+    } else {
+        qreal gs = qMin<qreal>(shadowSize, fixedSize);
+        drawGradientLayer(p, rect, color, hOffset, vOffset,
+                          {1, gs, int(10 * gs / fixedSize), true},
+                          Parabolic(0.85, 0.22), roundAllCorners);
+        gs = qMin<qreal>(shadowSize, (shadowSize + 2 * fixedSize) / 3);
+        drawGradientLayer(p, rect, color, hOffset, vOffset,
+                          {8, gs, int(10 * gs / fixedSize), false},
+                          Gaussian(0.54, 0.21), roundAllCorners);
+        gs = shadowSize;
+        drawGradientLayer(p, rect, color, hOffset, vOffset,
+                          {20, gs, int(20 * gs / fixedSize), false},
+                          Gaussian(0.155, 0.445), roundAllCorners);
+    }
+    p.end();
+}
+
+static int
+maxDifference(const QImage &a, const QImage &b)
+{
+    int diff = 0;
+    for (int y = 0;y < a.height();y++) {
+        const QRgb *la = reinterpret_cast<const QRgb*>(a.constScanLine(y));
+        const QRgb *lb = reinterpret_cast<const QRgb*>(b.constScanLine(y));
+        for (int x = 0;x < a.width();x++) {
+            diff = qMax(diff, qAbs(qRed(la[x]) - qRed(lb[x])));
+            diff = qMax(diff, qAbs(qGreen(la[x]) - qGreen(lb[x])));
+            diff = qMax(diff, qAbs(qBlue(la[x]) - qBlue(lb[x])));
+            diff = qMax(diff, qAbs(qAlpha(la[x]) - qAlpha(lb[x])));
+        }
+    }
+    return diff;
+}
+
+static const int benchSizes[] = {
+    ShadowConfig::MIN_SIZE, 35, 60, ShadowConfig::MAX_SIZE
+};
+
+int
+main(int argc, char **argv)
+{
+    int iterations = 100;
+    for (int i = 1;i < argc - 1;i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            iterations = qMax(1, atoi(argv[++i]));
+        }
+    }
+    const QColor color(0x39, 0x38, 0x35);
+    const int hOffset = 0;
+    const int vOffset = 5;
+
+    printf("%-8s %5s %-7s %12s %12s %12s %5s\n", "type", "size", "corners",
+           "gradient ns", "setup ns", "render ns", "diff");
+    for (int type = ShadowConfig::SH_ACTIVE;type <= ShadowConfig::SH_INACTIVE;
+         type++) {
+        for (int size: benchSizes) {
+            for (int round = 0;round < 2;round++) {
+                auto shadowType = ShadowConfig::ShadowType(type);
+                QImage reference(size * 2, size * 2,
+                                 QImage::Format_ARGB32_Premultiplied);
+                QImage image(reference.size(), reference.format());
+
+                tic();
+                for (int i = 0;i < iterations;i++) {
+                    gradientShadow(reference, shadowType, size, hOffset,
+                                   vOffset, color, round);
+                }
+                uint64_t gradientNs = toc();
+
+                ShadowRenderer renderer;
+                tic();
+                for (int i = 0;i < iterations;i++) {
+                    renderer.setup(shadowType, size, hOffset, vOffset,
+                                   color, color);
+                }
+                uint64_t setupNs = toc();
+                tic();
+                for (int i = 0;i < iterations;i++) {
+                    renderer.render(image, size, round);
+                }
+                uint64_t renderNs = toc();
+
+                printf("%-8s %5d %-7s %12.0f %12.0f %12.0f %5d\n",
+                       type == ShadowConfig::SH_ACTIVE ? "active" :
+                       "inactive", size, round ? "round" : "square",
+                       double(gradientNs) / iterations,
+                       double(setupNs) / iterations,
+                       double(renderNs) / iterations,
+                       maxDifference(reference, image));
+            }
+        }
+    }
+    return 0;
+}
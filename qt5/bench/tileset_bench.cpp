@@ -0,0 +1,351 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+// Check and benchmark of the TileSet atlas rendering.
+//
+// Bevel and shadow sets are rendered at odd sizes, with device pixel ratios
+// 1 and 2, both with the per chunk drawing TileSet used before the atlas and
+// with the current TileSet. The time per render and the largest difference
+// of a color channel between the two are reported. The exit status is 1 if
+// any difference is larger than the tolerance.
+//
+// Usage: qtcurve-tileset-bench [-n iterations] [-t tolerance]
+
+#include "tileset.h"
+
+#include <qtcurve-utils/timer.h>
+
+#include <QGuiApplication>
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QRadialGradient>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace QtCurve;
+
+// The TileSet before the atlas, every chunk is a pixmap of its own, middle
+// chunks are pre-expanded to 32 pixels and tiled with drawTiledPixmap().
+class ChunkTileSet {
+public:
+    ChunkTileSet(const QPixmap &pix, int w1, int h1, int w3, int h3,
+                 int x1, int y1, int w2, int h2)
+        : m_w1(w1),
+          m_h1(h1),
+          m_w3(w3),
+          m_h3(h3)
+    {
+        int x2 = pix.width() - m_w3;
+        int y2 = pix.height() - m_h3;
+        int w = w2;
+        while (w < 32 && w2 > 0 && w2 < pix.width())
+            w += w2;
+        int h = h2;
+        while (h < 32 && h2 > 0 && h2 < pix.height())
+            h += h2;
+
+        initPixmap(0, pix, m_w1, m_h1, QRect(0, 0, m_w1, m_h1));
+        initPixmap(1, pix, w, m_h1, QRect(x1, 0, w2, m_h1));
+        initPixmap(2, pix, m_w3, m_h1, QRect(x2, 0, m_w3, m_h1));
+        initPixmap(3, pix, m_w1, h, QRect(0, y1, m_w1, h2));
+        initPixmap(4, pix, w, h, QRect(x1, y1, w2, h2));
+        initPixmap(5, pix, m_w3, h, QRect(x2, y1, m_w3, h2));
+        initPixmap(6, pix, m_w1, m_h3, QRect(0, y2, m_w1, m_h3));
+        initPixmap(7, pix, w, m_h3, QRect(x1, y2, w2, m_h3));
+        initPixmap(8, pix, m_w3, m_h3, QRect(x2, y2, m_w3, m_h3));
+    }
+
+    void
+    render(const QRect &r, QPainter *p, TileSet::Tiles t) const
+    {
+        int x0, y0, w, h;
+        r.getRect(&x0, &y0, &w, &h);
+
+        qreal wRatio(m_w1 + m_w3 ? qreal(m_w1) / qreal(m_w1 + m_w3) : 0.5);
+        int wLeft = (t & TileSet::Right) ? qMin(m_w1, int(w * wRatio)) : m_w1;
+        int wRight = ((t & TileSet::Left) ?
+                      qMin(m_w3, int(w * (1.0 - wRatio))) : m_w3);
+        qreal hRatio(m_h1 + m_h3 ? qreal(m_h1) / qreal(m_h1 + m_h3) : 0.5);
+        int hTop = (t & TileSet::Bottom) ? qMin(m_h1, int(h * hRatio)) : m_h1;
+        int hBottom = ((t & TileSet::Top) ?
+                       qMin(m_h3, int(h * (1.0 - hRatio))) : m_h3);
+
+        w -= wLeft + wRight;
+        h -= hTop + hBottom;
+        int x1 = x0 + wLeft;
+        int x2 = x1 + w;
+        int y1 = y0 + hTop;
+        int y2 = y1 + h;
+
+        if (bits(t, TileSet::Top | TileSet::Left) && wLeft > 0 && hTop > 0)
+            p->drawPixmap(x0, y0, m_pixmaps[0], 0, 0, wLeft, hTop);
+        if (bits(t, TileSet::Top | TileSet::Right) && wRight > 0 && hTop > 0)
+            p->drawPixmap(x2, y0, m_pixmaps[2], m_w3 - wRight, 0,
+                          wRight, hTop);
+        if (bits(t, TileSet::Bottom | TileSet::Left) && wLeft > 0 &&
+            hBottom > 0)
+            p->drawPixmap(x0, y2, m_pixmaps[6], 0, m_h3 - hBottom,
+                          wLeft, hBottom);
+        if (bits(t, TileSet::Bottom | TileSet::Right) && wRight > 0 &&
+            hBottom > 0)
+            p->drawPixmap(x2, y2, m_pixmaps[8], m_w3 - wRight,
+                          m_h3 - hBottom, wRight, hBottom);
+
+        if (w > 0) {
+            if ((t & TileSet::Top) && hTop > 0)
+                p->drawTiledPixmap(x1, y0, w, hTop, m_pixmaps[1]);
+            if ((t & TileSet::Bottom) && hBottom > 0)
+                p->drawTiledPixmap(x1, y2, w, hBottom, m_pixmaps[7],
+                                   0, m_h3 - hBottom);
+        }
+        if (h > 0) {
+            if ((t & TileSet::Left) && wLeft > 0)
+                p->drawTiledPixmap(x0, y1, wLeft, h, m_pixmaps[3]);
+            if ((t & TileSet::Right) && wRight > 0)
+                p->drawTiledPixmap(x2, y1, wRight, h, m_pixmaps[5],
+                                   m_w3 - wRight, 0);
+        }
+        if ((t & TileSet::Center) && h > 0 && w > 0) {
+            p->drawTiledPixmap(x1, y1, w, h, m_pixmaps[4]);
+        }
+    }
+
+private:
+    static bool
+    bits(TileSet::Tiles flags, TileSet::Tiles testFlags)
+    {
+        return (flags & testFlags) == testFlags;
+    }
+    void
+    initPixmap(int s, const QPixmap &pix, int w, int h, const QRect &region)
+    {
+        if (region.isEmpty()) {
+            return;
+        }
+        if (w != region.width() || h != region.height()) {
+            QPixmap tile = pix.copy(region);
+            m_pixmaps[s] = QPixmap(w, h);
+            m_pixmaps[s].fill(Qt::transparent);
+            QPainter p(&m_pixmaps[s]);
+            p.drawTiledPixmap(0, 0, w, h, tile);
+        } else {
+            m_pixmaps[s] = pix.copy(region);
+        }
+    }
+
+    QPixmap m_pixmaps[9];
+    int m_w1;
+    int m_h1;
+    int m_w3;
+    int m_h3;
+};
+
+// A bevel like the style caches them, a rounded gradient with a border.
+// Stripes make the middle chunk change along its length so that it is
+// repeated instead of stretched.
+static QPixmap
+bevelPixmap(bool horiz, bool striped, int endSize, int middleSize)
+{
+    const int length = 2 * endSize + middleSize;
+    const int thickness = 21;
+    QImage img(horiz ? length : thickness, horiz ? thickness : length,
+               QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    QPainter p(&img);
+    p.setRenderHint(QPainter::Antialiasing);
+    QLinearGradient grad(0, 0, horiz ? 0 : thickness, horiz ? thickness : 0);
+    grad.setColorAt(0, QColor(0xf4, 0xf3, 0xf2));
+    grad.setColorAt(0.5, QColor(0xd6, 0xd2, 0xd0));
+    grad.setColorAt(1, QColor(0xb8, 0xb2, 0xae));
+    p.setBrush(grad);
+    p.setPen(QColor(0x6f, 0x6a, 0x65, 0xc0));
+    p.drawRoundedRect(QRectF(img.rect()).adjusted(0.5, 0.5, -0.5, -0.5),
+                      4.5, 4.5);
+    if (striped) {
+        p.setPen(QColor(255, 255, 255, 0x50));
+        for (int i = endSize;i < length - endSize;i += 3) {
+            if (horiz) {
+                p.drawLine(QPointF(i + 0.5, 2), QPointF(i + 0.5,
+                                                        thickness - 2));
+            } else {
+                p.drawLine(QPointF(2, i + 0.5), QPointF(thickness - 2,
+                                                        i + 0.5));
+            }
+        }
+    }
+    p.end();
+    return QPixmap::fromImage(img);
+}
+
+// A decoration shadow, a radial falloff around a rounded window corner.
+static QPixmap
+shadowPixmap(int size)
+{
+    QImage img(size * 2, size * 2, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    QPainter p(&img);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(Qt::NoPen);
+    QRadialGradient grad(size, size, size);
+    grad.setColorAt(0, QColor(0, 0, 0, 0xa0));
+    grad.setColorAt(0.4, QColor(0, 0, 0, 0x50));
+    grad.setColorAt(1, Qt::transparent);
+    p.setBrush(grad);
+    p.drawRect(img.rect());
+    p.setBrush(QColor(0xd6, 0xd2, 0xd0));
+    p.drawEllipse(QPointF(size, size), 4.5, 4.5);
+    p.end();
+    return QPixmap::fromImage(img);
+}
+
+static int
+maxDifference(const QImage &a, const QImage &b)
+{
+    int diff = 0;
+    for (int y = 0;y < a.height();y++) {
+        const QRgb *la = reinterpret_cast<const QRgb*>(a.constScanLine(y));
+        const QRgb *lb = reinterpret_cast<const QRgb*>(b.constScanLine(y));
+        for (int x = 0;x < a.width();x++) {
+            diff = qMax(diff, qAbs(qRed(la[x]) - qRed(lb[x])));
+            diff = qMax(diff, qAbs(qGreen(la[x]) - qGreen(lb[x])));
+            diff = qMax(diff, qAbs(qBlue(la[x]) - qBlue(lb[x])));
+            diff = qMax(diff, qAbs(qAlpha(la[x]) - qAlpha(lb[x])));
+        }
+    }
+    return diff;
+}
+
+struct BenchCase {
+    const char *name;
+    QPixmap pix;
+    // Chunk sizes as passed to the nine argument constructors.
+    int w1, h1, w3, h3, x1, y1, w2, h2;
+    TileSet::Tiles tiles;
+};
+
+// Odd target sizes, smaller and larger than the source pixmaps.
+static const int benchLengths[] = {1, 7, 13, 22, 37, 101, 333};
+
+template<typename Set>
+static uint64_t
+renderInto(QImage &image, const Set &set, const QRect &rect,
+           TileSet::Tiles tiles, int iterations)
+{
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    tic();
+    for (int i = 0;i < iterations;i++) {
+        set.render(rect, &p, tiles);
+    }
+    uint64_t ns = toc();
+    p.end();
+    return ns;
+}
+
+int
+main(int argc, char **argv)
+{
+    int iterations = 100;
+    int tolerance = 0;
+    for (int i = 1;i < argc - 1;i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            iterations = qMax(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-t") == 0) {
+            tolerance = qMax(0, atoi(argv[++i]));
+        }
+    }
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    const int endSize = 6;
+    const int middleSize = 5;
+    const int shadowSize = 25;
+    const BenchCase cases[] = {
+        {"bevel-h", bevelPixmap(true, false, endSize, middleSize),
+         endSize, 0, endSize, 0, endSize, 0, middleSize, 21,
+         TileSet::Horizontal},
+        {"bevel-v", bevelPixmap(false, false, endSize, middleSize),
+         0, endSize, 0, endSize, 0, endSize, 21, middleSize,
+         TileSet::Vertical},
+        {"stripe-h", bevelPixmap(true, true, endSize, middleSize),
+         endSize, 0, endSize, 0, endSize, 0, middleSize, 21,
+         TileSet::Horizontal},
+        {"shadow", shadowPixmap(shadowSize),
+         shadowSize, shadowSize, shadowSize - 1, shadowSize - 1,
+         shadowSize, shadowSize, 1, 1, TileSet::Ring},
+        {"shadow-b", shadowPixmap(shadowSize),
+         shadowSize, shadowSize, shadowSize - 1, shadowSize - 1,
+         shadowSize, shadowSize, 1, 1, TileSet::Bottom},
+        {"shadow-f", shadowPixmap(shadowSize),
+         shadowSize, shadowSize, shadowSize - 1, shadowSize - 1,
+         shadowSize, shadowSize, 1, 1, TileSet::Full},
+    };
+
+    int worst = 0;
+    printf("%-9s %3s %9s %12s %12s %5s\n", "set", "dpr", "size",
+           "chunks ns", "atlas ns", "diff");
+    for (const BenchCase &c: cases) {
+        const ChunkTileSet chunks(c.pix, c.w1, c.h1, c.w3, c.h3,
+                                  c.x1, c.y1, c.w2, c.h2);
+        const TileSet atlas(c.pix, c.w1, c.h1, c.w3, c.h3,
+                            c.x1, c.y1, c.w2, c.h2);
+        for (int dpr = 1;dpr <= 2;dpr++) {
+            for (int length: benchLengths) {
+                // Bevels only stretch along one axis, shadows along both.
+                QSize size(length, length * 2 / 3 + 1);
+                if (c.tiles == TileSet::Horizontal) {
+                    size.setHeight(c.pix.height());
+                } else if (c.tiles == TileSet::Vertical) {
+                    size.setWidth(c.pix.width());
+                }
+                const QRect rect(QPoint(3, 5), size);
+                QImage reference((size.width() + 8) * dpr,
+                                 (size.height() + 10) * dpr,
+                                 QImage::Format_ARGB32_Premultiplied);
+                reference.setDevicePixelRatio(dpr);
+                QImage image(reference.size(), reference.format());
+                image.setDevicePixelRatio(dpr);
+
+                uint64_t chunksNs = renderInto(reference, chunks, rect,
+                                               c.tiles, iterations);
+                uint64_t atlasNs = renderInto(image, atlas, rect, c.tiles,
+                                              iterations);
+                int diff = maxDifference(reference, image);
+                worst = qMax(worst, diff);
+                printf("%-9s %3d %4dx%-4d %12.0f %12.0f %5d\n", c.name, dpr,
+                       size.width(), size.height(),
+                       double(chunksNs) / iterations,
+                       double(atlasNs) / iterations, diff);
+            }
+        }
+    }
+    if (worst > tolerance) {
+        fprintf(stderr, "Atlas rendering differs by up to %d (tolerance %d)\n",
+                worst, tolerance);
+        return 1;
+    }
+    return 0;
+}
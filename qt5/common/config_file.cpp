@@ -22,12 +22,18 @@
 
 #include <qtcurve-utils/dirs.h>
 #include <qtcurve-utils/color.h>
+#include <qtcurve-utils/ini.h>
 #include "common.h"
 #include "config_file.h"
 
 #include <qglobal.h>
 #include <QMap>
 #include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QCryptographicHash>
 #include <QTextStream>
 #include <QSvgRenderer>
 #include <QPainter>
@@ -601,20 +607,20 @@ private:
 
 QtCConfig::QtCConfig(const QString &filename)
 {
-    QFile f(filename);
+    QtCurve::Ini::File file(QFile::encodeName(filename).constData());
 
-    if (f.open(QIODevice::ReadOnly)) {
-        QTextStream stream(&f);
-        QString     line;
+    if (file.isValid()) {
+        QtCurve::Ini::Tokenizer tokenizer = file.tokenizer();
+        QtCurve::Ini::Token token;
 
-        while(!stream.atEnd())
-        {
-            line = stream.readLine();
-            int pos=line.indexOf('=');
-            if(-1!=pos)
-                values[line.left(pos)]=line.mid(pos+1);
+        while ((token = tokenizer.next()) != QtCurve::Ini::Token::End) {
+            if (token == QtCurve::Ini::Token::Entry) {
+                const QtCurve::StrView &key = tokenizer.key();
+                const QtCurve::StrView &value = tokenizer.value();
+                values[QString::fromUtf8(key.str, key.len)] =
+                    QString::fromUtf8(value.str, value.len);
+            }
         }
-        f.close();
     }
 }
 
@@ -1070,6 +1076,308 @@ void qtcCheckConfig(Options *opts)
         opts->toolbarSeparators=LINE_DOTS;
 }
 
+#ifndef CONFIG_DIALOG
+/*
+ * Binary snapshot of the Options read from the default config file. It is
+ * written next to the config file so that the next applications can skip
+ * parsing it, the version migrations and qtcCheckConfig(). It is only used
+ * while the stamp (QtCurve and Qt versions, config and system config file
+ * sizes and modification times) still matches and the payload hash is right.
+ * Bump constSnapshotVersion when changing the fields or their encoding.
+ */
+#define SNAPSHOT_SUFFIX ".qt5-snapshot"
+static const quint32 constSnapshotMagic = 0x51746353;
+static const quint32 constSnapshotVersion = 1;
+
+// Every field of Options but the ones only set at runtime (tickFont,
+// menuTick, fontTickWidth and currentNonnativeMenubarApps).
+#define QTC_SNAPSHOT_FIELDS(F)                                                \
+    F(version) F(contrast) F(passwordChar) F(highlightFactor)                 \
+    F(lighterPopupMenuBgnd) F(menuDelay) F(menuCloseDelay) F(sliderWidth)     \
+    F(tabBgnd) F(colorSelTab) F(expanderHighlight) F(crHighlight)             \
+    F(splitterHighlight) F(crSize) F(gbFactor) F(gbLabel) F(thin) F(round)    \
+    F(embolden) F(highlightTab) F(roundAllTabs) F(animatedProgress)           \
+    F(customMenuTextColor) F(menubarMouseOver) F(useHighlightForMenu)         \
+    F(shadeMenubarOnlyWhenActive) F(lvButton) F(drawStatusBarFrames)          \
+    F(fillSlider) F(roundMbTopOnly) F(gtkScrollViews) F(stdSidebarButtons)    \
+    F(toolbarTabs) F(gtkComboMenus) F(mapKdeIcons) F(gtkButtonOrder)          \
+    F(fadeLines) F(reorderGtkButtons) F(borderMenuitems)                      \
+    F(colorMenubarMouseOver) F(darkerBorders) F(vArrows) F(xCheck)            \
+    F(crButton) F(smallRadio) F(fillProgress) F(comboSplitter)                \
+    F(highlightScrollViews) F(etchEntry) F(colorSliderMouseOver)              \
+    F(thinSbarGroove) F(flatSbarButtons) F(borderSbarGroove)                  \
+    F(borderProgress) F(popupBorder) F(unifySpinBtns) F(unifyCombo)           \
+    F(unifySpin) F(borderTab) F(borderInactiveTab) F(doubleGtkComboArrow)     \
+    F(menuIcons) F(stdBtnSizes) F(forceAlternateLvCols) F(invertBotTab)       \
+    F(boldProgress) F(coloredTbarMo) F(borderSelection) F(stripedSbar)        \
+    F(shadePopupMenu) F(hideShortcutUnderline) F(groupBox) F(glowProgress)    \
+    F(lvLines) F(bgndGrad) F(menuBgndGrad) F(menubarHiding)                   \
+    F(statusbarHiding) F(square) F(windowDrag) F(windowBorder)                \
+    F(bgndOpacity) F(menuBgndOpacity) F(dlgOpacity) F(shadowSize)             \
+    F(dwtSettings) F(titlebarButtons) F(titlebarButtonColors)                 \
+    F(titlebarIcon) F(stripedProgress) F(sliderStyle) F(coloredMouseOver)     \
+    F(toolbarBorders) F(tbarBtns) F(defBtnIndicator) F(sliderThumbs)          \
+    F(handles) F(toolbarSeparators) F(splitters) F(tabMouseOver)              \
+    F(appearance) F(bgndAppearance) F(menuBgndAppearance)                     \
+    F(menubarAppearance) F(menuitemAppearance) F(toolbarAppearance)           \
+    F(lvAppearance) F(tabAppearance) F(activeTabAppearance)                   \
+    F(sliderAppearance) F(titlebarAppearance) F(inactiveTitlebarAppearance)   \
+    F(titlebarButtonAppearance) F(dwtAppearance) F(selectionAppearance)       \
+    F(menuStripeAppearance) F(progressAppearance)                             \
+    F(progressGrooveAppearance) F(grooveAppearance) F(sunkenAppearance)       \
+    F(sbarBgndAppearance) F(sliderFill) F(tooltipAppearance)                  \
+    F(tbarBtnAppearance) F(shadeSliders) F(shadeMenubars) F(menuStripe)       \
+    F(shadeCheckRadio) F(comboBtn) F(sortedLv) F(crColor) F(progressColor)    \
+    F(progressGrooveColor) F(buttonEffect) F(tbarBtnEffect) F(scrollbarType)  \
+    F(focus) F(customMenubarsColor) F(customSlidersColor)                     \
+    F(customMenuNormTextColor) F(customMenuSelTextColor)                      \
+    F(customMenuStripeColor) F(customCheckRadioColor) F(customComboBtnColor)  \
+    F(customSortedLvColor) F(customCrBgndColor) F(customProgressColor)        \
+    F(shading) F(titlebarAlignment) F(titlebarEffect) F(centerTabText)        \
+    F(customShades) F(customAlphas)                                           \
+    F(customGradient) F(bgndPixmap) F(menuBgndPixmap) F(bgndImage)            \
+    F(menuBgndImage) F(noBgndGradientApps) F(noBgndOpacityApps)               \
+    F(noMenuBgndOpacityApps) F(noBgndImageApps) F(noMenuStripeApps)           \
+    F(menubarApps) F(statusbarApps) F(useQtFileDialogApps)                    \
+    F(windowDragWhiteList) F(windowDragBlackList) F(nonnativeMenubarApps)     \
+    F(onlyTicksInMenu) F(buttonStyleMenuSections)
+
+static const char *getSystemConfigFile();
+
+template<typename T>
+static inline typename std::enable_if<!std::is_enum<T>::value>::type
+putField(QDataStream &s, const T &val)
+{
+    s << val;
+}
+
+template<typename T>
+static inline typename std::enable_if<!std::is_enum<T>::value>::type
+getField(QDataStream &s, T &val)
+{
+    s >> val;
+}
+
+template<typename T>
+static inline typename std::enable_if<std::is_enum<T>::value>::type
+putField(QDataStream &s, const T &val)
+{
+    s << qint32(val);
+}
+
+template<typename T>
+static inline typename std::enable_if<std::is_enum<T>::value>::type
+getField(QDataStream &s, T &val)
+{
+    qint32 i = 0;
+    s >> i;
+    val = T(i);
+}
+
+template<size_t N>
+static inline void
+putField(QDataStream &s, const double (&vals)[N])
+{
+    for (size_t i = 0;i < N;i++) {
+        s << vals[i];
+    }
+}
+
+template<size_t N>
+static inline void
+getField(QDataStream &s, double (&vals)[N])
+{
+    for (size_t i = 0;i < N;i++) {
+        s >> vals[i];
+    }
+}
+
+static void
+putField(QDataStream &s, const TBCols &cols)
+{
+    s << quint32(cols.size());
+    for (const auto &col: cols) {
+        s << qint32(col.first) << col.second;
+    }
+}
+
+static void
+getField(QDataStream &s, TBCols &cols)
+{
+    quint32 n = 0;
+    s >> n;
+    cols.clear();
+    for (quint32 i = 0;i < n && s.status() == QDataStream::Ok;i++) {
+        qint32 key = 0;
+        QColor col;
+        s >> key >> col;
+        cols[key] = col;
+    }
+}
+
+static void
+putField(QDataStream &s, const GradientCont &grads)
+{
+    s << quint32(grads.size());
+    for (const auto &grad: grads) {
+        s << qint32(grad.first) << qint32(grad.second.border)
+          << quint32(grad.second.stops.size());
+        for (const GradientStop &stop: grad.second.stops) {
+            s << stop.pos << stop.val << stop.alpha;
+        }
+    }
+}
+
+static void
+getField(QDataStream &s, GradientCont &grads)
+{
+    quint32 n = 0;
+    s >> n;
+    grads.clear();
+    for (quint32 i = 0;i < n && s.status() == QDataStream::Ok;i++) {
+        qint32 app = 0;
+        qint32 border = 0;
+        quint32 nstops = 0;
+        s >> app >> border >> nstops;
+        Gradient &grad = grads[(EAppearance)app];
+        grad.border = (EGradientBorder)border;
+        for (quint32 j = 0;j < nstops && s.status() == QDataStream::Ok;j++) {
+            double pos = 0;
+            double val = 0;
+            double alpha = 0;
+            s >> pos >> val >> alpha;
+            grad.stops.insert(GradientStop(pos, val, alpha));
+        }
+    }
+}
+
+// Only the file name, the image is loaded again by readSnapshot().
+static void
+putField(QDataStream &s, const QtCPixmap &pix)
+{
+    s << pix.file;
+}
+
+static void
+getField(QDataStream &s, QtCPixmap &pix)
+{
+    s >> pix.file;
+    pix.img = QPixmap();
+}
+
+static void
+putField(QDataStream &s, const QtCImage &img)
+{
+    putField(s, img.type);
+    s << img.loaded << img.onBorder;
+    putField(s, img.pixmap);
+    s << qint32(img.width) << qint32(img.height);
+    putField(s, img.pos);
+}
+
+static void
+getField(QDataStream &s, QtCImage &img)
+{
+    getField(s, img.type);
+    s >> img.loaded >> img.onBorder;
+    getField(s, img.pixmap);
+    getField(s, img.width);
+    getField(s, img.height);
+    getField(s, img.pos);
+}
+
+static QByteArray
+snapshotStamp(const QString &file)
+{
+    QByteArray stamp;
+    QDataStream s(&stamp, QIODevice::WriteOnly);
+    s << QString::fromLatin1(qtcVersion()) << QString::fromLatin1(qVersion())
+      << quint32(sizeof(Options)) << file;
+    const char *sysFile = getSystemConfigFile();
+    for (const QString &f: {file, QString::fromLocal8Bit(sysFile)}) {
+        QFileInfo info(f);
+        s << info.exists() << qint64(info.size())
+          << info.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
+
+static bool
+readSnapshot(const QString &file, Options *opts)
+{
+    QFile f(file + SNAPSHOT_SUFFIX);
+    if (!f.open(QIODevice::ReadOnly) || f.size() <= 0) {
+        return false;
+    }
+    uchar *data = f.map(0, f.size());
+    if (!data) {
+        return false;
+    }
+    QByteArray raw(QByteArray::fromRawData((const char*)data, f.size()));
+    QDataStream s(raw);
+    s.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    s >> magic >> version;
+    if (magic != constSnapshotMagic || version != constSnapshotVersion) {
+        return false;
+    }
+    QByteArray stamp;
+    QByteArray payload;
+    QByteArray hash;
+    s >> stamp >> payload >> hash;
+    if (s.status() != QDataStream::Ok || stamp != snapshotStamp(file) ||
+        hash != QCryptographicHash::hash(payload, QCryptographicHash::Md5)) {
+        return false;
+    }
+
+    // Read into a copy, so that a bad snapshot leaves opts alone.
+    Options snap(*opts);
+    QDataStream p(payload);
+    p.setVersion(QDataStream::Qt_5_0);
+#define GET_FIELD(ENTRY) getField(p, snap.ENTRY);
+    QTC_SNAPSHOT_FIELDS(GET_FIELD)
+#undef GET_FIELD
+    if (p.status() != QDataStream::Ok || !p.atEnd()) {
+        return false;
+    }
+    if (snap.bgndAppearance == APPEARANCE_FILE &&
+        !loadImage(snap.bgndPixmap.file, &snap.bgndPixmap)) {
+        return false;
+    }
+    if (snap.menuBgndAppearance == APPEARANCE_FILE &&
+        !loadImage(snap.menuBgndPixmap.file, &snap.menuBgndPixmap)) {
+        return false;
+    }
+    *opts = snap;
+    return true;
+}
+
+static void
+writeSnapshot(const QString &file, const Options &opts)
+{
+    QByteArray payload;
+    QDataStream p(&payload, QIODevice::WriteOnly);
+    p.setVersion(QDataStream::Qt_5_0);
+#define PUT_FIELD(ENTRY) putField(p, opts.ENTRY);
+    QTC_SNAPSHOT_FIELDS(PUT_FIELD)
+#undef PUT_FIELD
+
+    // Other applications may be writing it too, QSaveFile renames the
+    // complete file in place.
+    QSaveFile f(file + SNAPSHOT_SUFFIX);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream s(&f);
+    s.setVersion(QDataStream::Qt_5_0);
+    s << constSnapshotMagic << constSnapshotVersion << snapshotStamp(file)
+      << payload
+      << QCryptographicHash::hash(payload, QCryptographicHash::Md5);
+    f.commit();
+}
+#endif
+
 bool qtcReadConfig(const QString &file, Options *opts, Options *defOpts, bool checkImages)
 {
     if (file.isEmpty()) {
@@ -1084,6 +1392,19 @@ bool qtcReadConfig(const QString &file, Options *opts, Options *defOpts, bool ch
 
                 if(!QFile::exists(filename))
                     filename = QFile::decodeName(cfgDir) + "../" OLD_CONFIG_FILE;
+#ifndef CONFIG_DIALOG
+                // The snapshot is only valid for the default options.
+                if (!defOpts && checkImages) {
+                    if (readSnapshot(filename, opts)) {
+                        return true;
+                    }
+                    bool res = qtcReadConfig(filename, opts, defOpts);
+                    if (res && QFile::exists(filename)) {
+                        writeSnapshot(filename, *opts);
+                    }
+                    return res;
+                }
+#endif
                 return qtcReadConfig(filename, opts, defOpts);
             }
         }
@@ -40,7 +40,6 @@
 
 // libs
 #include <qtcurve-utils/dirs.h>
-#include <qtcurve-utils/process.h>
 #include <qtcurve-utils/qtutils.h>
 #include <qtcurve-utils/x11base.h>
 
@@ -466,28 +465,15 @@ kdeHome(bool kde3)
 {
     static QString kdeHome[2];
 
-    // Execute kde-config to ascertain users KDEHOME
     if (kdeHome[kde3 ? 0 : 1].isEmpty()) {
-        size_t len = 0;
-        const char *kde_config = kde3 ? "kde-config" : "kde4-config";
-        const char *const argv[] = {kde_config, "--localprefix", nullptr};
-        char *res = qtcPopenStdout(kde_config, argv, 300, &len);
-        if (res) {
-            res[len] = '\0';
-            kdeHome[kde3 ? 0 : 1] = QFile::decodeName(res).replace("\n", "");
-            free(res);
-        }
-    }
-
-    // Try env vars...
-    if (kdeHome[kde3 ? 0 : 1].isEmpty()) {
-        kdeHome[kde3 ? 0 : 1] = readEnvPath(getuid() ? "KDEHOME" : "KDEROOTHOME");
-        if (kdeHome[kde3 ? 0 : 1].isEmpty()) {
-            QDir homeDir(QDir::homePath());
-            QString kdeConfDir("/.kde");
-            if (!kde3 && homeDir.exists(".kde4"))
-                kdeConfDir = QString("/.kde4");
-            kdeHome[kde3 ? 0 : 1] = QDir::homePath() + kdeConfDir;
+        if (!kde3) {
+            // Resolved without running kde4-config, see getKDE4LocalPrefix()
+            kdeHome[1] = QFile::decodeName(QtCurve::getKDE4LocalPrefix());
+        } else {
+            kdeHome[0] = readEnvPath(getuid() ? "KDEHOME" : "KDEROOTHOME");
+            if (kdeHome[0].isEmpty()) {
+                kdeHome[0] = QDir::homePath() + "/.kde";
+            }
         }
     }
     return kdeHome[kde3 ? 0 : 1];
@@ -150,8 +150,8 @@ void QtCurveButton::paintEvent(QPaintEvent *ev)
 
 void QtCurveButton::drawButton(QPainter *painter)
 {
-    int flags = Handler()->wStyle()->pixelMetric(
-        (QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L);
+    const QtCurveHandler::StyleMetrics &metrics(Handler()->styleMetrics());
+    int flags = metrics.titleBarButtons;
     bool active(m_client->isActive());
 
     if (!active && !m_hover && flags & TITLEBAR_BUTTOM_HIDE_ON_INACTIVE_WINDOW)
@@ -164,15 +164,33 @@ void QtCurveButton::drawButton(QPainter *painter)
                    (m_hover || sunken ||
                     !(flags & TITLEBAR_BUTTON_HOVER_FRAME)));
     bool drewFrame(false);
-    bool iconForMenu(TITLEBAR_ICON_MENU_BUTTON ==
-                     Handler()->wStyle()->pixelMetric(
-                         (QStyle::PixelMetric)QtC_TitleBarIcon, 0L, 0L));
+    bool iconForMenu(TITLEBAR_ICON_MENU_BUTTON == metrics.titleBarIcon);
     QColor buttonColor(KDecoration::options()->color(KDecoration::ColorTitleBar,
                                                      active));
-    QPixmap buffer(width(), height());
+    bool isTabClose(ItemCloseButton == type());
+
+    // Apart from the window icon of the menu button, a button only depends on
+    // its kind, size and state, the style and the decoration colors. Share
+    // the composed pixmap between all the title bars, so hovering or
+    // (de)activating a window is a blit.
+    bool cacheable(MenuButton != type() || !iconForMenu);
+    PixmapKey key(PixmapKey::KEY_BUTTON,
+                  type() | (m_iconType << 8) | (active ? 1 << 16 : 0) |
+                  (m_hover ? 1 << 17 : 0) | (sunken ? 1 << 18 : 0) |
+                  (isEnabled() ? 1 << 19 : 0) |
+                  (m_client->isToolWindow() ? 1 << 20 : 0),
+                  width() | (height() << 16), flags, buttonColor,
+                  KDecoration::options()->color(KDecoration::ColorFont, active),
+                  palette().color(QPalette::Button),
+                  Handler()->hoverCol(active));
+    QPixmap buffer;
+    if (cacheable && Handler()->buttonCache().find(key, &buffer)) {
+        painter->drawPixmap(0, 0, buffer);
+        return;
+    }
+    buffer = QPixmap(width(), height());
     buffer.fill(Qt::transparent);
     QPainter bP(&buffer);
-    bool isTabClose(ItemCloseButton == type());
 
     // isItemMenu?
     if (isTabClose && drawFrame && !(sunken || m_hover))
@@ -331,6 +349,9 @@ void QtCurveButton::drawButton(QPainter *painter)
     }
 
     bP.end();
+    if (cacheable) {
+        Handler()->buttonCache().insert(key, buffer);
+    }
     painter->drawPixmap(0, 0, buffer);
 }
 
@@ -371,7 +392,8 @@ QBitmap IconEngine::icon(ButtonIcon icon, int size, QStyle *style)
         break;
     }
     case MaxIcon:
-        if (Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L) & TITLEBAR_BUTTOM_ARROW_MIN_MAX) {
+        if (Handler()->styleMetrics().titleBarButtons &
+            TITLEBAR_BUTTOM_ARROW_MIN_MAX) {
             QStyleOption opt;
             opt.rect = r;
             opt.state = QStyle::State_Enabled | QtC_StateKWin;
@@ -393,7 +415,8 @@ QBitmap IconEngine::icon(ButtonIcon icon, int size, QStyle *style)
         }
         break;
     case MaxRestoreIcon:
-        if (Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L) & TITLEBAR_BUTTOM_ARROW_MIN_MAX) {
+        if (Handler()->styleMetrics().titleBarButtons &
+            TITLEBAR_BUTTOM_ARROW_MIN_MAX) {
             p.drawLine(r.x() + 1, r.y(), r.x() + r.width() - 2, r.y());
             p.drawLine(r.x() + 1, r.y() + r.height() - 1,
                        r.x() + r.width() - 2, r.y() + r.height() - 1);
@@ -439,7 +462,8 @@ QBitmap IconEngine::icon(ButtonIcon icon, int size, QStyle *style)
         }
         break;
     case MinIcon:
-        if (Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L)&TITLEBAR_BUTTOM_ARROW_MIN_MAX) {
+        if (Handler()->styleMetrics().titleBarButtons &
+            TITLEBAR_BUTTOM_ARROW_MIN_MAX) {
             QStyleOption opt;
 
             opt.rect = r;
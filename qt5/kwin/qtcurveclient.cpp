@@ -30,6 +30,7 @@
 #include <qtcurve-utils/x11wrap.h>
 #include <qtcurve-utils/x11qtc.h>
 #include <qtcurve-utils/log.h>
+#include <qtcurve-utils/qtutils.h>
 
 #define DRAW_INTO_PIXMAPS
 #include <KDE/KLocale>
@@ -54,7 +55,6 @@
 #include "qtcurvebutton.h"
 #include "qtcurvetogglebutton.h"
 #include "qtcurvesizegrip.h"
-#include "tileset.h"
 #include <common/common.h>
 
 #include <style/qtcurve.h>
@@ -64,38 +64,6 @@ namespace KWin {
 
 static const int constTitlePad = 4;
 
-int getMenubarSizeProperty(WId wId)
-{
-    return qtcX11GetShortProp(wId, qtc_x11_qtc_menubar_size);
-}
-
-int getStatusbarSizeProperty(WId wId)
-{
-    return qtcX11GetShortProp(wId, qtc_x11_qtc_statusbar);
-}
-
-int getOpacityProperty(WId wId)
-{
-    int o = qtcX11GetShortProp(wId, qtc_x11_qtc_opacity);
-    return o <= 0 || o >= 100 ? 100 : o;
-}
-
-void getBgndSettings(WId wId, EAppearance &app, QColor &col)
-{
-    auto reply = qtcX11GetProperty(0, wId, qtc_x11_qtc_bgnd,
-                                   XCB_ATOM_CARDINAL, 0, 1);
-    if (!reply) {
-        return;
-    }
-    if (qtcX11GetPropertyValueLength(reply) > 0) {
-        uint32_t val = *(int32_t*)qtcX11GetPropertyValue(reply);
-        app = (EAppearance)(val & 0xFF);
-        col.setRgb((val & 0xFF000000) >> 24, (val & 0x00FF0000) >> 16,
-                   (val & 0x0000FF00) >> 8);
-    }
-    free(reply);
-}
-
 static QPainterPath createPath(const QRectF &r, double radiusTop, double radiusBot)
 {
     QPainterPath path;
@@ -205,6 +173,7 @@ QtCurveClient::QtCurveClient(KDecorationBridge *bridge, QtCurveHandler *factory)
       m_resizeGrip(0L),
       m_titleFont(QFont()),
       m_menuBarSize(-1),
+      m_windowProps{-1, -1, 100, false, APPEARANCE_FLAT, 0},
       m_toggleMenuBarButton(0L),
       m_toggleStatusBarButton(0L)
       // m_hover(false)
@@ -310,6 +279,7 @@ void QtCurveClient::init()
 
     if(Handler()->showResizeGrip())
         createSizeGrip();
+    readWindowProps();
     if (isPreview())
         m_caption =  isActive() ? i18n("Active Window") : i18n("Inactive Window");
     else
@@ -346,82 +316,56 @@ void QtCurveClient::activeChange()
 void QtCurveClient::captionChange()
 {
     m_caption=caption();
-    widget()->update();
+    updateCaption();
 }
 
 void QtCurveClient::paintEvent(QPaintEvent *e)
 {
-    bool compositing = compositingActive();
-    QPainter painter(widget());
-    QRect r(widget()->rect());
-    QStyleOptionTitleBar opt;
-    int windowBorder(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_WindowBorder, 0L, 0L));
-    bool active(isActive());
-    bool colorTitleOnly(windowBorder&WINDOW_BORDER_COLOR_TITLEBAR_ONLY);
-    bool roundBottom(Handler()->roundBottom());
-    bool preview(isPreview());
-    bool blend(!preview && Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_BlendMenuAndTitleBar, nullptr, nullptr));
-    bool menuColor(windowBorder&WINDOW_BORDER_USE_MENUBAR_COLOR_FOR_TITLEBAR);
-    bool separator(active && windowBorder&WINDOW_BORDER_SEPARATOR);
-    bool maximized(isMaximized());
-    QtCurveConfig::Shade outerBorder(Handler()->outerBorder()),
-                         innerBorder(Handler()->innerBorder());
+    const QtCurveHandler::StyleMetrics &metrics(Handler()->styleMetrics());
+    FrameState state;
+
+    state.compositing = compositingActive();
+    state.active = isActive();
+    state.preview = isPreview();
+    state.maximized = isMaximized();
+    state.blend = !state.preview && metrics.blendMenuAndTitleBar;
+    state.menuColor = metrics.windowBorder&WINDOW_BORDER_USE_MENUBAR_COLOR_FOR_TITLEBAR;
+
+    bool active(state.active);
+    bool maximized(state.maximized);
+    bool separator(active && metrics.windowBorder&WINDOW_BORDER_SEPARATOR);
+    bool customShadows(Handler()->customShadows());
+    QtCurveConfig::Shade outerBorder(Handler()->outerBorder());
     const int            border(Handler()->borderEdgeSize()),
                          titleHeight(layoutMetric(LM_TitleHeight)),
                          titleEdgeTop(layoutMetric(LM_TitleEdgeTop)),
                          titleEdgeBottom(layoutMetric(LM_TitleEdgeBottom)),
                          titleEdgeLeft(layoutMetric(LM_TitleEdgeLeft)),
                          titleEdgeRight(layoutMetric(LM_TitleEdgeRight)),
-                         titleBarHeight(titleHeight+titleEdgeTop+titleEdgeBottom+(isMaximized() ? border : 0)),
-                         round=Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_Round, nullptr, nullptr),
-                         buttonFlags=Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, nullptr, nullptr);
-    int                  rectX, rectY, rectX2, rectY2, shadowSize(0),
-                         kwinOpacity(compositing ? Handler()->opacity(active) : 100),
-                         opacity(kwinOpacity);
+                         titleBarHeight(titleHeight+titleEdgeTop+titleEdgeBottom+(maximized ? border : 0)),
+                         shadowSize(customShadows ? int(Handler()->shadowCache().shadowSize()) : 0);
     EAppearance          bgndAppearance=APPEARANCE_FLAT;
-    QColor               windowCol(widget()->palette().color(QPalette::Window));
 
-    getBgndSettings(windowId(), bgndAppearance, windowCol);
+    state.titleBarHeight = titleBarHeight;
+    state.shadowSize = shadowSize;
+    state.kwinOpacity = state.compositing ? Handler()->opacity(active) : 100;
+    state.opacity = state.kwinOpacity;
+    state.windowCol = widget()->palette().color(QPalette::Window);
 
-    QColor               col(KDecoration::options()->color(KDecoration::ColorTitleBar, active)),
-                         fillCol(colorTitleOnly ? windowCol : col);
-                         // APPEARANCE_RAISED is used to signal flat background, but have background image!
-                         // In which case we still have a custom background to draw.
-    bool customBgnd = bgndAppearance != APPEARANCE_FLAT;
-    bool customShadows = Handler()->customShadows();
-
-    painter.setClipRegion(e->region());
-
-    if(!preview && compositing && 100==opacity)
-        opacity=getOpacityProperty(windowId());
-
-    if (customShadows) {
-        shadowSize = Handler()->shadowCache().shadowSize();
-
-        if (compositing) {
-            TileSet *tileSet=Handler()->shadowCache().tileSet(this, roundBottom);
-            if (opacity < 100) {
-                painter.save();
-                painter.setClipRegion(QRegion(r).subtract(getMask(round, r.adjusted(shadowSize, shadowSize, -shadowSize, -shadowSize))), Qt::IntersectClip);
-            }
-
-            if(!isMaximized())
-                tileSet->render(r.adjusted(5, 5, -5, -5), &painter, TileSet::Ring);
-            else if(isShade())
-                tileSet->render(r.adjusted(0, 5, 0, -5), &painter, TileSet::Bottom);
-            if(opacity<100)
-                painter.restore();
-        }
-        r.adjust(shadowSize, shadowSize, -shadowSize, -shadowSize);
+    if (m_windowProps.haveBgnd) {
+        bgndAppearance = (EAppearance)m_windowProps.bgndAppearance;
+        state.windowCol = QColor(m_windowProps.bgndCol);
     }
 
-    int   side(layoutMetric(LM_BorderLeft)),
-          bot(layoutMetric(LM_BorderBottom));
-    QRect widgetRect(widget()->rect().adjusted(shadowSize+side, shadowSize+titleBarHeight, -(shadowSize+side), -(shadowSize+bot)));
+    state.bgndAppearance = bgndAppearance;
+    state.col = KDecoration::options()->color(KDecoration::ColorTitleBar, active);
+    state.fillCol = (metrics.windowBorder&WINDOW_BORDER_COLOR_TITLEBAR_ONLY ?
+                     state.windowCol : state.col);
 
-    r.getCoords(&rectX, &rectY, &rectX2, &rectY2);
+    if(!state.preview && state.compositing && 100==state.opacity)
+        state.opacity=m_windowProps.opacity;
 
-    if(!preview && (blend||menuColor) && -1==m_menuBarSize)
+    if(!state.preview && (state.blend||state.menuColor) && -1==m_menuBarSize)
     {
         QString wc(windowClass());
         if(wc==QLatin1String("W Navigator Firefox browser") ||
@@ -444,17 +388,205 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
                 wc.startsWith(QLatin1String("W VCLSalFrame OpenOffice.org")) ||
                 wc==QLatin1String("W soffice.bin Soffice.bin"))
             m_menuBarSize=QFontMetrics(QApplication::font()).height()+7;
-        else
+        else if(m_windowProps.menubarSize>-1)
+            m_menuBarSize=m_windowProps.menubarSize;
+    }
+
+    if(state.menuColor && m_menuBarSize>0 &&
+       (active || !metrics.shadeMenubarOnlyWhenActive))
+        state.col=QColor(metrics.menubarColor);
+
+    //
+    // Everything but the caption only depends on the window state, so it is
+    // painted once into a frame layer shared by all the windows in the same
+    // state. A focus change or a caption update is then a blit.
+    //
+    PixmapKey  key(PixmapKey::KEY_DECORATION,
+                   quint32(widget()->width() | widget()->height() << 16),
+                   quint32(active | state.compositing << 1 | state.preview << 2 |
+                           maximized << 3 | isShade() << 4 | state.blend << 5 |
+                           state.menuColor << 6),
+                   quint32(state.opacity | state.kwinOpacity << 8 |
+                           state.bgndAppearance << 16),
+                   state.windowCol, state.col, state.fillCol,
+                   widget()->palette().color(widget()->backgroundRole()),
+                   m_menuBarSize,
+                   quint32(buttonsLeftWidth() | buttonsRightWidth() << 16),
+                   titleBarHeight);
+    FrameLayer layer;
+
+    if (!Handler()->frameCache().find(key, &layer))
+    {
+        QPixmap  frame(widget()->size());
+        frame.fill(Qt::transparent);
+        QPainter framePainter(&frame);
+        paintFrame(framePainter, state);
+        framePainter.end();
+
+        // The client window covers the rest
+        int   padding(customShadows ? shadowSize : 0);
+        QRect client(widget()->rect().adjusted(padding+layoutMetric(LM_BorderLeft),
+                                               padding+titleHeight+titleEdgeTop+titleEdgeBottom,
+                                               -(padding+layoutMetric(LM_BorderRight)),
+                                               -(padding+layoutMetric(LM_BorderBottom))));
+        layer = FrameLayer(frame, client);
+        Handler()->frameCache().insert(key, layer);
+    }
+
+    QPainter painter(widget());
+    QRect    r(widget()->rect());
+    int      rectX, rectY, rectX2, rectY2;
+
+    painter.setClipRegion(e->region());
+    layer.render(&painter);
+
+    if (customShadows)
+        r.adjust(shadowSize, shadowSize, -shadowSize, -shadowSize);
+    r.getCoords(&rectX, &rectY, &rectX2, &rectY2);
+    if(maximized)
+        r.adjust(-3, -border, 3, 0);
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    bool showIcon=TITLEBAR_ICON_NEXT_TO_TITLE==metrics.titleBarIcon;
+    int  iconSize=showIcon ? metrics.smallIconSize : 0;
+
+    m_captionRect=captionRect(); // also update m_captionRect!
+    // Caption changes only repaint the caption, see updateCaption()
+    if (e->region().intersects(m_captionRect.adjusted(-1, -1, 1, 1)))
+        paintTitle(&painter, m_captionRect, QRect(rectX+titleEdgeLeft, m_captionRect.y(),
+                                                  rectX2-(titleEdgeRight+rectX+titleEdgeLeft),
+                                                  m_captionRect.height()),
+                   m_caption, showIcon ? icon().pixmap(iconSize) : QPixmap(), shadowSize);
+
+    bool hideToggleButtons(true);
+    int  toggleButtons(metrics.toggleButtons);
+
+    if(toggleButtons)
+    {
+        if(!m_toggleMenuBarButton && toggleButtons&0x01 && (Handler()->wasLastMenu(windowId()) || m_windowProps.menubarSize>-1))
+            m_toggleMenuBarButton=createToggleButton(true);
+        if(!m_toggleStatusBarButton && toggleButtons&0x02 && (Handler()->wasLastStatus(windowId()) || m_windowProps.statusbar>-1))
+            m_toggleStatusBarButton=createToggleButton(false);
+
+        // if (m_hover)
         {
-            int val=getMenubarSizeProperty(windowId());
-            if(val>-1)
-                m_menuBarSize=val;
+            if (active && (m_toggleMenuBarButton||m_toggleStatusBarButton)) {
+                if( (buttonsLeftWidth()+buttonsRightWidth()+constTitlePad+
+                    (m_toggleMenuBarButton ? m_toggleMenuBarButton->width() : 0) +
+                    (m_toggleStatusBarButton ? m_toggleStatusBarButton->width() : 0)) < r.width())
+                {
+                    int  align(metrics.titleAlignment);
+                    bool onLeft(align&Qt::AlignRight);
+
+                    if(align&Qt::AlignHCenter)
+                    {
+                        QString left=options()->customButtonPositions() ? options()->titleButtonsLeft() : defaultButtonsLeft(),
+                                right=options()->customButtonPositions() ? options()->titleButtonsRight() : defaultButtonsRight();
+                        onLeft=left.length()<right.length();
+                    }
+
+                    int     offset=2,
+                            posAdjust=maximized ? 2 : 0;
+                    QRect   cr(onLeft
+                                ? r.left()+buttonsLeftWidth()+posAdjust+constTitlePad+2
+                                : r.right()-(buttonsRightWidth()+posAdjust+constTitlePad+2+
+                                            (m_toggleMenuBarButton ? m_toggleMenuBarButton->width() : 0)+
+                                            (m_toggleStatusBarButton ? m_toggleStatusBarButton->width() : 0)),
+                            r.top()+offset,
+                            (m_toggleMenuBarButton ? m_toggleMenuBarButton->width() : 0)+
+                            (m_toggleStatusBarButton ? m_toggleStatusBarButton->width() : 0),
+                            titleBarHeight-2*offset);
+
+                    if(m_toggleMenuBarButton)
+                    {
+                        m_toggleMenuBarButton->move(cr.x(), r.y()+3+(outerBorder ? 2 : 0));
+                        m_toggleMenuBarButton->show();
+                    }
+                    if(m_toggleStatusBarButton)
+                    {
+                        m_toggleStatusBarButton->move(cr.x()+(m_toggleMenuBarButton ? m_toggleMenuBarButton->width()+2 : 0),
+                                                       r.y()+3+(outerBorder ? 2 : 0));
+                        m_toggleStatusBarButton->show();
+                    }
+                    hideToggleButtons=false;
+                }
+            }
+        }
+    }
+    if(hideToggleButtons)
+    {
+        if(m_toggleMenuBarButton)
+            m_toggleMenuBarButton->hide();
+        if(m_toggleStatusBarButton)
+            m_toggleStatusBarButton->hide();
+    }
+
+    if(separator)
+    {
+        QColor        color(KDecoration::options()->color(KDecoration::ColorFont, isActive()));
+        Qt::Alignment align((Qt::Alignment)metrics.titleAlignment);
+
+        r.adjust(16, titleBarHeight-1, -16, 0);
+        color.setAlphaF(0.5);
+        drawFadedLine(&painter, r, color, true, align&(Qt::AlignHCenter|Qt::AlignRight), align&(Qt::AlignHCenter|Qt::AlignLeft));
+    }
+
+    painter.end();
+}
+
+void QtCurveClient::paintFrame(QPainter &painter, const FrameState &state)
+{
+    const QtCurveHandler::StyleMetrics &metrics(Handler()->styleMetrics());
+    QRect r(widget()->rect());
+    QStyleOptionTitleBar opt;
+    int windowBorder(metrics.windowBorder);
+    bool compositing(state.compositing);
+    bool active(state.active);
+    bool roundBottom(Handler()->roundBottom());
+    bool preview(state.preview);
+    bool blend(state.blend);
+    bool menuColor(state.menuColor);
+    bool maximized(state.maximized);
+    QtCurveConfig::Shade outerBorder(Handler()->outerBorder()),
+                         innerBorder(Handler()->innerBorder());
+    const int            border(Handler()->borderEdgeSize()),
+                         titleBarHeight(state.titleBarHeight),
+                         round=metrics.round,
+                         buttonFlags=metrics.titleBarButtons,
+                         shadowSize(state.shadowSize),
+                         kwinOpacity(state.kwinOpacity),
+                         opacity(state.opacity);
+    EAppearance          bgndAppearance=(EAppearance)state.bgndAppearance;
+    QColor               windowCol(state.windowCol),
+                         col(state.col),
+                         fillCol(state.fillCol);
+                         // APPEARANCE_RAISED is used to signal flat background, but have background image!
+                         // In which case we still have a custom background to draw.
+    bool customBgnd = bgndAppearance != APPEARANCE_FLAT;
+    bool customShadows = Handler()->customShadows();
+
+    if (customShadows) {
+        if (compositing) {
+            TileSet tileSet(Handler()->shadowCache().tileSet(this, roundBottom));
+            if (opacity < 100) {
+                painter.save();
+                painter.setClipRegion(QRegion(r).subtract(getMask(round, r.adjusted(shadowSize, shadowSize, -shadowSize, -shadowSize))), Qt::IntersectClip);
+            }
+
+            if(!isMaximized())
+                tileSet.render(r.adjusted(5, 5, -5, -5), &painter, TileSet::Ring);
+            else if(isShade())
+                tileSet.render(r.adjusted(0, 5, 0, -5), &painter, TileSet::Bottom);
+            if(opacity<100)
+                painter.restore();
         }
+        r.adjust(shadowSize, shadowSize, -shadowSize, -shadowSize);
     }
 
-    if(menuColor && m_menuBarSize>0 &&
-       (active || !Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ShadeMenubarOnlyWhenActive, nullptr, nullptr)))
-        col=QColor(QRgb(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_MenubarColor, nullptr, nullptr)));
+    int   side(layoutMetric(LM_BorderLeft)),
+          bot(layoutMetric(LM_BorderBottom));
+    QRect widgetRect(widget()->rect().adjusted(shadowSize+side, shadowSize+titleBarHeight, -(shadowSize+side), -(shadowSize+bot)));
 
     if(opacity<100)
     {
@@ -489,8 +621,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
     QPainterPath fillPath(maximized || round<=ROUND_SLIGHT
                                 ? QPainterPath()
                                 : createPath(QRectF(fillRect),
-                                             APPEARANCE_NONE==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarApp,
-                                                                                               &opt, nullptr) ? 6.0 : 8.0,
+                                             APPEARANCE_NONE==metrics.titleBarApp[active] ? 6.0 : 8.0,
                                              roundBottom ? 6.0 : 1.0));
 
 
@@ -651,7 +782,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
              vOffset=hOffset+(outerBorder ? 1 :0),
              posAdjust=maximized || outerBorder ? 2 : 0,
              edgePad=Handler()->edgePad();
-        bool menuIcon=TITLEBAR_ICON_MENU_BUTTON==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon, 0L, 0L),
+        bool menuIcon=TITLEBAR_ICON_MENU_BUTTON==metrics.titleBarIcon,
              menuOnlyLeft=menuIcon && onlyMenuIcon(true),
              menuOnlyRight=menuIcon && !menuOnlyLeft && onlyMenuIcon(false);
 
@@ -663,90 +794,6 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
             drawSunkenBevel(&painter, QRect(r.right()-(buttonsRightWidth()+posAdjust+edgePad), r.top()+vOffset+edgePad,
                                             buttonsRightWidth(), titleBarHeight-2*(vOffset+edgePad)), col, buttonFlags&TITLEBAR_BUTTON_ROUND, round);
     }
-
-    bool showIcon=TITLEBAR_ICON_NEXT_TO_TITLE==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon,  0L, 0L);
-    int  iconSize=showIcon ? Handler()->wStyle()->pixelMetric(QStyle::PM_SmallIconSize) : 0;
-
-    m_captionRect=captionRect(); // also update m_captionRect!
-    paintTitle(&painter, m_captionRect, QRect(rectX+titleEdgeLeft, m_captionRect.y(),
-                                              rectX2-(titleEdgeRight+rectX+titleEdgeLeft),
-                                              m_captionRect.height()),
-               m_caption, showIcon ? icon().pixmap(iconSize) : QPixmap(), shadowSize);
-
-    bool hideToggleButtons(true);
-    int  toggleButtons(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, nullptr, nullptr));
-
-    if(toggleButtons)
-    {
-        if(!m_toggleMenuBarButton && toggleButtons&0x01 && (Handler()->wasLastMenu(windowId()) || getMenubarSizeProperty(windowId())>-1))
-            m_toggleMenuBarButton=createToggleButton(true);
-        if(!m_toggleStatusBarButton && toggleButtons&0x02 && (Handler()->wasLastStatus(windowId()) || getStatusbarSizeProperty(windowId())>-1))
-            m_toggleStatusBarButton=createToggleButton(false);
-
-        // if (m_hover)
-        {
-            if (active && (m_toggleMenuBarButton||m_toggleStatusBarButton)) {
-                if( (buttonsLeftWidth()+buttonsRightWidth()+constTitlePad+
-                    (m_toggleMenuBarButton ? m_toggleMenuBarButton->width() : 0) +
-                    (m_toggleStatusBarButton ? m_toggleStatusBarButton->width() : 0)) < r.width())
-                {
-                    int  align(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L));
-                    bool onLeft(align&Qt::AlignRight);
-
-                    if(align&Qt::AlignHCenter)
-                    {
-                        QString left=options()->customButtonPositions() ? options()->titleButtonsLeft() : defaultButtonsLeft(),
-                                right=options()->customButtonPositions() ? options()->titleButtonsRight() : defaultButtonsRight();
-                        onLeft=left.length()<right.length();
-                    }
-
-                    int     offset=2,
-                            posAdjust=maximized ? 2 : 0;
-                    QRect   cr(onLeft
-                                ? r.left()+buttonsLeftWidth()+posAdjust+constTitlePad+2
-                                : r.right()-(buttonsRightWidth()+posAdjust+constTitlePad+2+
-                                            (m_toggleMenuBarButton ? m_toggleMenuBarButton->width() : 0)+
-                                            (m_toggleStatusBarButton ? m_toggleStatusBarButton->width() : 0)),
-                            r.top()+offset,
-                            (m_toggleMenuBarButton ? m_toggleMenuBarButton->width() : 0)+
-                            (m_toggleStatusBarButton ? m_toggleStatusBarButton->width() : 0),
-                            titleBarHeight-2*offset);
-
-                    if(m_toggleMenuBarButton)
-                    {
-                        m_toggleMenuBarButton->move(cr.x(), r.y()+3+(outerBorder ? 2 : 0));
-                        m_toggleMenuBarButton->show();
-                    }
-                    if(m_toggleStatusBarButton)
-                    {
-                        m_toggleStatusBarButton->move(cr.x()+(m_toggleMenuBarButton ? m_toggleMenuBarButton->width()+2 : 0),
-                                                       r.y()+3+(outerBorder ? 2 : 0));
-                        m_toggleStatusBarButton->show();
-                    }
-                    hideToggleButtons=false;
-                }
-            }
-        }
-    }
-    if(hideToggleButtons)
-    {
-        if(m_toggleMenuBarButton)
-            m_toggleMenuBarButton->hide();
-        if(m_toggleStatusBarButton)
-            m_toggleStatusBarButton->hide();
-    }
-
-    if(separator)
-    {
-        QColor        color(KDecoration::options()->color(KDecoration::ColorFont, isActive()));
-        Qt::Alignment align((Qt::Alignment)Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L));
-
-        r.adjust(16, titleBarHeight-1, -16, 0);
-        color.setAlphaF(0.5);
-        drawFadedLine(&painter, r, color, true, align&(Qt::AlignHCenter|Qt::AlignRight), align&(Qt::AlignHCenter|Qt::AlignLeft));
-    }
-
-    painter.end();
 }
 
 void
@@ -765,7 +812,7 @@ QtCurveClient::paintTitle(QPainter *painter, const QRect &capRect,
         QFontMetrics  fm(painter->fontMetrics());
         QString       str(fm.elidedText(cap, Qt::ElideRight,
                             capRect.width()-(showIcon ? pix.width()+constTitlePad : 0), QPalette::WindowText));
-        Qt::Alignment hAlign((Qt::Alignment)Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L)),
+        Qt::Alignment hAlign((Qt::Alignment)Handler()->styleMetrics().titleAlignment),
                       alignment(Qt::AlignVCenter|hAlign);
         bool          alignFull(!isTab && Qt::AlignHCenter==hAlign),
                       reverse=Qt::RightToLeft==QApplication::layoutDirection(),
@@ -773,7 +820,7 @@ QtCurveClient::paintTitle(QPainter *painter, const QRect &capRect,
         QRect         textRect(alignFull ? alignFullRect : capRect);
         int           textWidth=alignFull || (showIcon && alignment&Qt::AlignHCenter)
                                     ? fm.boundingRect(str).width()+(showIcon ? pix.width()+constTitlePad : 0) : 0;
-        EEffect       effect((EEffect)(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarEffect)));
+        EEffect       effect((EEffect)Handler()->styleMetrics().titleBarEffect);
 
         if(alignFull)
         {
@@ -901,95 +948,26 @@ void QtCurveClient::updateWindowShape()
                           -layoutMetric(LM_OuterPaddingBottom)) :
                 widget()->rect());
 
-        setMask(getMask(Handler()->wStyle()->pixelMetric(
-                            (QStyle::PixelMetric)QtC_Round, nullptr, nullptr), r));
+        setMask(getMask(Handler()->styleMetrics().round, r));
     }
 }
 
 QRegion QtCurveClient::getMask(int round, const QRect &r) const
 {
-    int x, y, w, h;
-
-    r.getRect(&x, &y, &w, &h);
+    static const RoundedMask slightMask({1});
+    static const RoundedMask fullMask({5, 3, 2, 1, 1});
+    static const RoundedMask fullSquareBottomMask({5, 3, 2, 1, 1}, false);
 
     switch(round)
     {
         case ROUND_NONE:
-            return  QRegion(x, y, w, h);
+            return QRegion(r);
         case ROUND_SLIGHT:
-        {
-            QRegion mask(x+1, y, w-2, h);
-            mask += QRegion(x, y+1, 1, h-2);
-            mask += QRegion(x+w-1, y+1, 1, h-2);
-
-            return mask;
-        }
+            return qtcMaskRegion(slightMask, r);
         default: // ROUND_FULL
-        {
-            bool    roundBottom=!isShade() && Handler()->roundBottom();
-
-// #if KDE_IS_VERSION(4, 3, 0)
-//             if(!isPreview() && COMPOSITING_ENABLED)
-//             {
-//                 QRegion mask(x+4, y, w-8, h);
-//
-//                 if(roundBottom)
-//                 {
-//                     mask += QRegion(x, y+4, 1, h-8);
-//                     mask += QRegion(x+1, y+2, 1, h-4);
-//                     mask += QRegion(x+2, y+1, 1, h-2);
-//                     mask += QRegion(x+3, y+1, 1, h-2);
-//                     mask += QRegion(x+w-1, y+4, 1, h-8);
-//                     mask += QRegion(x+w-2, y+2, 1, h-4);
-//                     mask += QRegion(x+w-3, y+1, 1, h-2);
-//                     mask += QRegion(x+w-4, y+1, 1, h-2);
-//                 }
-//                 else
-//                 {
-//                     mask += QRegion(x, y+4, 1, h-4);
-//                     mask += QRegion(x+1, y+2, 1, h-1);
-//                     mask += QRegion(x+2, y+1, 1, h);
-//                     mask += QRegion(x+3, y+1, 1, h);
-//                     mask += QRegion(x+w-1, y+4, 1, h-4);
-//                     mask += QRegion(x+w-2, y+2, 1, h-1);
-//                     mask += QRegion(x+w-3, y+1, 1, h-0);
-//                     mask += QRegion(x+w-4, y+1, 1, h-0);
-//                 }
-//                 return mask;
-//             }
-//             else
-// #endif
-            {
-                QRegion mask(x+5, y, w-10, h);
-
-                if(roundBottom)
-                {
-                    mask += QRegion(x, y+5, 1, h-10);
-                    mask += QRegion(x+1, y+3, 1, h-6);
-                    mask += QRegion(x+2, y+2, 1, h-4);
-                    mask += QRegion(x+3, y+1, 2, h-2);
-                    mask += QRegion(x+w-1, y+5, 1, h-10);
-                    mask += QRegion(x+w-2, y+3, 1, h-6);
-                    mask += QRegion(x+w-3, y+2, 1, h-4);
-                    mask += QRegion(x+w-5, y+1, 2, h-2);
-                }
-                else
-                {
-                    mask += QRegion(x, y+5, 1, h-5);
-                    mask += QRegion(x+1, y+3, 1, h-3);
-                    mask += QRegion(x+2, y+2, 1, h-2);
-                    mask += QRegion(x+3, y+1, 2, h-1);
-                    mask += QRegion(x+w-1, y+5, 1, h-5);
-                    mask += QRegion(x+w-2, y+3, 1, h-3);
-                    mask += QRegion(x+w-3, y+2, 1, h-2);
-                    mask += QRegion(x+w-5, y+1, 2, h-1);
-                }
-                return mask;
-            }
-        }
+            return qtcMaskRegion(!isShade() && Handler()->roundBottom() ?
+                                 fullMask : fullSquareBottomMask, r);
     }
-
-    return QRegion();
 }
 
 bool QtCurveClient::onlyMenuIcon(bool left) const
@@ -1078,19 +1056,18 @@ void QtCurveClient::reset(unsigned long changed)
                 m_resizeGrip->show();
     }
 
-    if (changed&SettingColors)
-    {
-        // repaint the whole thing
-        widget()->update();
-        updateButtons();
-    }
-    else if (changed&SettingFont)
-    {
-        // font has changed -- update title height and font
+    if (changed & (SettingFont | SettingCompositing)) {
+        // font, title height, borders or shadow padding have changed
         m_titleFont=isToolWindow() ? Handler()->titleFontTool() : Handler()->titleFont();
 
         updateLayout();
+        updateWindowShape();
+    }
+
+    if (changed & (SettingColors | SettingFont | SettingCompositing)) {
+        // repaint the whole thing
         widget()->update();
+        updateButtons();
     }
 
     if(Handler()->showResizeGrip())
@@ -1137,8 +1114,7 @@ void QtCurveClient::informAppOfBorderSizeChanges()
 
 void QtCurveClient::informAppOfActiveChange()
 {
-    if (Handler()->wStyle()->pixelMetric(
-            (QStyle::PixelMetric)QtC_ShadeMenubarOnlyWhenActive, nullptr, nullptr)) {
+    if (Handler()->styleMetrics().shadeMenubarOnlyWhenActive) {
         union {
             char _buff[32];
             xcb_client_message_event_t ev;
@@ -1205,7 +1181,7 @@ const QString & QtCurveClient::windowClass()
 void QtCurveClient::menuBarSize(int size)
 {
     m_menuBarSize=size;
-    if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, nullptr, nullptr) &0x01)
+    if(Handler()->styleMetrics().toggleButtons &0x01)
     {
         if(!m_toggleMenuBarButton)
             m_toggleMenuBarButton=createToggleButton(true);
@@ -1218,7 +1194,7 @@ void QtCurveClient::menuBarSize(int size)
 void QtCurveClient::statusBarState(bool state)
 {
     Q_UNUSED(state)
-    if (Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, nullptr, nullptr) &0x02) {
+    if (Handler()->styleMetrics().toggleButtons &0x02) {
         if(!m_toggleStatusBarButton)
             m_toggleStatusBarButton=createToggleButton(false);
         //if(m_toggleStatusBarButton)
@@ -1227,6 +1203,46 @@ void QtCurveClient::statusBarState(bool state)
     KCommonDecoration::activeChange();
 }
 
+// Reads the properties the style sets on the window in one round trip. Called
+// when the client is created and by the handler when one of them changes, so
+// that painting never waits for the X server.
+void QtCurveClient::readWindowProps()
+{
+    enum {
+        PROP_MENUBAR,
+        PROP_STATUSBAR,
+        PROP_OPACITY,
+        PROP_BGND,
+        NUM_PROPS
+    };
+    const xcb_atom_t atoms[NUM_PROPS] = {
+        qtc_x11_qtc_menubar_size,
+        qtc_x11_qtc_statusbar,
+        qtc_x11_qtc_opacity,
+        qtc_x11_qtc_bgnd
+    };
+    uint32_t vals[NUM_PROPS];
+    uint32_t found = (isPreview() ? 0 :
+                      qtcX11GetCardinalProps(windowId(), NUM_PROPS,
+                                             atoms, vals));
+    auto shortProp = [&] (int prop) {
+        return found & (1 << prop) && vals[prop] < 512 ? int(vals[prop]) : -1;
+    };
+    int opacity = shortProp(PROP_OPACITY);
+
+    m_windowProps.menubarSize = shortProp(PROP_MENUBAR);
+    m_windowProps.statusbar = shortProp(PROP_STATUSBAR);
+    m_windowProps.opacity = opacity <= 0 || opacity >= 100 ? 100 : opacity;
+    m_windowProps.haveBgnd = found & (1 << PROP_BGND);
+    if (m_windowProps.haveBgnd) {
+        uint32_t val = vals[PROP_BGND];
+        m_windowProps.bgndAppearance = val & 0xFF;
+        m_windowProps.bgndCol = qRgb((val & 0xFF000000) >> 24,
+                                     (val & 0x00FF0000) >> 16,
+                                     (val & 0x0000FF00) >> 8);
+    }
+}
+
 void QtCurveClient::toggleMenuBar()
 {
     sendToggleToApp(true);
@@ -79,6 +79,7 @@ public:
     }
     void menuBarSize(int size);
     void statusBarState(bool state);
+    void readWindowProps();
     QtCurveToggleButton *createToggleButton(bool menubar);
     void informAppOfBorderSizeChanges();
     void sendToggleToApp(bool menubar);
@@ -94,6 +95,36 @@ private:
     void informAppOfActiveChange();
     const QString &windowClass();
 
+    //! inputs of paintFrame(), part of the frame cache key
+    struct FrameState {
+        bool active;
+        bool compositing;
+        bool preview;
+        bool maximized;
+        bool blend;
+        bool menuColor;
+        int titleBarHeight;
+        int shadowSize;
+        int kwinOpacity;
+        int opacity;
+        int bgndAppearance;
+        QColor windowCol;
+        QColor col;
+        QColor fillCol;
+    };
+
+    void paintFrame(QPainter &painter, const FrameState &state);
+
+    //! properties the style sets on the window, see readWindowProps()
+    struct WindowProps {
+        int menubarSize;
+        int statusbar;
+        int opacity;
+        bool haveBgnd;
+        int bgndAppearance;
+        QRgb bgndCol;
+    };
+
     struct ButtonBgnd {
         QPixmap pix;
         int app;
@@ -109,6 +140,7 @@ private:
     QString m_windowClass;
     QFont m_titleFont;
     int m_menuBarSize;
+    WindowProps m_windowProps;
     QtCurveToggleButton *m_toggleMenuBarButton;
     QtCurveToggleButton *m_toggleStatusBarButton;
     // bool m_hover;
@@ -148,5 +148,26 @@ void QtCurveConfig::save(KConfig *cfg, const char *grp)
     WRITE_ENTRY("EdgePad", m_edgePad);
 }
 
+int QtCurveConfig::diff(const QtCurveConfig &o) const
+{
+    int changes = 0;
+    if (m_borderSize != o.m_borderSize || m_roundBottom != o.m_roundBottom ||
+        m_outerBorder != o.m_outerBorder || m_innerBorder != o.m_innerBorder ||
+        m_borderlessMax != o.m_borderlessMax ||
+        m_customShadows != o.m_customShadows ||
+        m_titleBarPad != o.m_titleBarPad || m_edgePad != o.m_edgePad) {
+        changes |= CHANGE_LAYOUT;
+    }
+    if (m_activeOpacity != o.m_activeOpacity ||
+        m_inactiveOpacity != o.m_inactiveOpacity ||
+        m_opaqueBorder != o.m_opaqueBorder) {
+        changes |= CHANGE_PAINT;
+    }
+    if (m_grouping != o.m_grouping) {
+        changes |= CHANGE_GROUPING;
+    }
+    return changes;
+}
+
 }
 }
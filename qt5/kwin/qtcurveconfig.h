@@ -50,6 +50,14 @@ public:
         SHADE_SHADOW
     };
 
+    // What a settings change requires from the existing decorations.
+    enum Change
+    {
+        CHANGE_LAYOUT = 0x1,    // border, title bar or shadow sizes
+        CHANGE_PAINT = 0x2,     // opacity, border or shadow appearance
+        CHANGE_GROUPING = 0x4   // decorations have to be recreated
+    };
+
     QtCurveConfig()               { defaults(); }
 
     void defaults();
@@ -96,6 +104,7 @@ public:
     }
 
     bool operator!=(const QtCurveConfig &o) const { return !(*this==o); }
+    int  diff(const QtCurveConfig &o) const;
 
     private:
 
@@ -24,6 +24,7 @@
 #define _QTCURVE_DBUS_H_
 
 #include <QDBusAbstractAdaptor>
+#include <QVariantMap>
 #include "qtcurvehandler.h"
 
 namespace QtCurve {
@@ -52,6 +53,35 @@ class QtCurveDBus : public QDBusAbstractAdaptor
 
     Q_NOREPLY void menuBarSize(unsigned int xid, int size)      { Handler()->menuBarSize(xid, size); }
     Q_NOREPLY void statusBarState(unsigned int xid, bool state) { Handler()->statusBarState(xid, state); }
+
+    QVariantMap
+    shadowCacheStatistics()
+    {
+        QVariantMap stats;
+        Handler()->shadowCache().addStatistics(stats, QStringLiteral("shadowCache"));
+        return stats;
+    }
+    Q_NOREPLY void
+    setShadowCacheSize(int kbytes)
+    {
+        // The cost is an int in bytes, allow up to 1 GiB.
+        Handler()->shadowCache().setMaxCost(qBound(0, kbytes, 1 << 20) * 1024);
+    }
+
+    QVariantMap
+    frameCacheStatistics()
+    {
+        QVariantMap stats;
+        Handler()->frameCache().addStatistics(stats, QStringLiteral("frameCache"));
+        return stats;
+    }
+    QVariantMap
+    buttonCacheStatistics()
+    {
+        QVariantMap stats;
+        Handler()->buttonCache().addStatistics(stats, QStringLiteral("buttonCache"));
+        return stats;
+    }
 };
 
 }
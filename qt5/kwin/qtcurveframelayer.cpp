@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "qtcurveframelayer.h"
+
+#include <QPainter>
+
+namespace QtCurve {
+namespace KWin {
+
+FrameLayer::FrameLayer(const QPixmap &frame, const QRect &client)
+{
+    const QRect rect(frame.rect());
+    const QRect inner(client.intersected(rect));
+    if (inner.isEmpty()) {
+        // Shaded, the frame is all there is.
+        m_strips[0] = frame;
+        return;
+    }
+    const QRect strips[constNumStrips] = {
+        QRect(0, 0, rect.width(), inner.top()),
+        QRect(0, inner.bottom() + 1, rect.width(),
+              rect.height() - inner.bottom() - 1),
+        QRect(0, inner.top(), inner.left(), inner.height()),
+        QRect(inner.right() + 1, inner.top(),
+              rect.width() - inner.right() - 1, inner.height())
+    };
+    for (int i = 0;i < constNumStrips;i++) {
+        if (!strips[i].isEmpty()) {
+            m_strips[i] = frame.copy(strips[i]);
+            m_pos[i] = strips[i].topLeft();
+        }
+    }
+}
+
+void
+FrameLayer::render(QPainter *painter) const
+{
+    for (int i = 0;i < constNumStrips;i++) {
+        if (!m_strips[i].isNull()) {
+            painter->drawPixmap(m_pos[i], m_strips[i]);
+        }
+    }
+}
+
+int
+FrameLayer::cost() const
+{
+    int cost = 0;
+    for (int i = 0;i < constNumStrips;i++) {
+        cost += QtCurve::cacheCost(m_strips[i]);
+    }
+    return cost;
+}
+
+}
+}
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTCURVEFRAMELAYER_H__
+#define __QTCURVEFRAMELAYER_H__
+
+#include <style/pixmapcache.h>
+
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+
+class QPainter;
+
+namespace QtCurve {
+namespace KWin {
+
+/**
+ * Static part of a rendered decoration: shadow, borders, title bar
+ * background and button bevels, everything but the caption. Only the strips
+ * around the client area are kept since the client window covers the rest.
+ */
+class FrameLayer {
+public:
+    FrameLayer() {}
+    FrameLayer(const QPixmap &frame, const QRect &client);
+
+    void render(QPainter *painter) const;
+    //! size of the strips in bytes
+    int cost() const;
+
+private:
+    static const int constNumStrips = 4;
+
+    QPixmap m_strips[constNumStrips];
+    QPoint m_pos[constNumStrips];
+};
+
+static inline int
+cacheCost(const FrameLayer &layer)
+{
+    return layer.cost();
+}
+
+typedef RenderCache<FrameLayer> FrameCache;
+
+}
+}
+
+#endif
@@ -34,6 +34,7 @@
 #include <QPixmap>
 #include <QStyleFactory>
 #include <QStyle>
+#include <QStyleOption>
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
@@ -87,10 +88,16 @@ Handler()
 }
 
 QtCurveHandler::QtCurveHandler() :
+    m_titleHeight(0),
+    m_titleHeightTool(0),
     m_lastMenuXid(0),
     m_lastStatusXid(0),
     m_style(nullptr),
-    m_dBus(nullptr)
+    m_dBus(nullptr),
+    // 16MB, the frames of about 15 large windows in both states
+    m_frameCache(16 << 20),
+    // 1MB, a few hundred title bar buttons
+    m_buttonCache(1 << 20)
 {
     qtcX11InitXlib(QX11Info::display());
     handler = this;
@@ -99,10 +106,12 @@ QtCurveHandler::QtCurveHandler() :
 
     m_dBus = new QtCurveDBus(this);
     QDBusConnection::sessionBus().registerObject("/QtCurve", this);
+    qApp->installNativeEventFilter(this);
 }
 
 QtCurveHandler::~QtCurveHandler()
 {
+    qApp->removeNativeEventFilter(this);
     handler = 0;
     delete m_style;
 }
@@ -125,6 +134,37 @@ void QtCurveHandler::setStyle()
         // Looks wrong with style support
         m_timeStamp = getTimeStamp(xdgConfigFolder() + "/qtcurve/stylerc");
     }
+    updateStyleMetrics();
+}
+
+void QtCurveHandler::updateStyleMetrics()
+{
+    QStyle *style = wStyle();
+    auto metric = [style] (int metric) {
+        return style->pixelMetric((QStyle::PixelMetric)metric,
+                                  nullptr, nullptr);
+    };
+
+    m_styleMetrics.windowBorder = metric(QtC_WindowBorder);
+    m_styleMetrics.round = metric(QtC_Round);
+    m_styleMetrics.titleBarButtons = metric(QtC_TitleBarButtons);
+    m_styleMetrics.titleBarIcon = metric(QtC_TitleBarIcon);
+    m_styleMetrics.titleAlignment = metric(QtC_TitleAlignment);
+    m_styleMetrics.titleBarEffect = metric(QtC_TitleBarEffect);
+    m_styleMetrics.toggleButtons = metric(QtC_ToggleButtons);
+    m_styleMetrics.blendMenuAndTitleBar = metric(QtC_BlendMenuAndTitleBar);
+    m_styleMetrics.shadeMenubarOnlyWhenActive =
+        metric(QtC_ShadeMenubarOnlyWhenActive);
+    m_styleMetrics.menubarColor = QRgb(metric(QtC_MenubarColor));
+    m_styleMetrics.smallIconSize = style->pixelMetric(QStyle::PM_SmallIconSize);
+
+    QStyleOption opt;
+    for (int active = 0;active < 2;active++) {
+        opt.state = active ? QStyle::State_Active : QStyle::State_None;
+        m_styleMetrics.titleBarApp[active] =
+            style->pixelMetric((QStyle::PixelMetric)QtC_TitleBarApp,
+                               &opt, nullptr);
+    }
 }
 
 bool QtCurveHandler::reset(unsigned long changed)
@@ -136,6 +176,9 @@ bool QtCurveHandler::reset(unsigned long changed)
         m_style = 0L;
         setStyle();
         styleChanged = true;
+    } else {
+        // The menubar color follows the palette.
+        updateStyleMetrics();
     }
 
     // we assume the active font to be the same as the inactive font since the
@@ -147,29 +190,54 @@ bool QtCurveHandler::reset(unsigned long changed)
     m_hoverCols[1]=KColorScheme(QPalette::Active).decoration(KColorScheme::HoverColor).color();
 
     // read in the configuration
-    bool configChanged = readConfig(changed & SettingCompositing);
+    int oldTitleHeight = m_titleHeight;
+    int oldTitleHeightTool = m_titleHeightTool;
+    int configChanges = readConfig(changed & SettingCompositing);
 
     setBorderSize();
 
-    for (int t = 0;t < 2;++t) {
-        for (int i = 0;i < NumButtonIcons;i++) {
-            m_bitmaps[t][i] = QPixmap();
+    if (styleChanged) {
+        for (int t = 0;t < 2;++t) {
+            for (int i = 0;i < NumButtonIcons;i++) {
+                m_bitmaps[t][i] = QPixmap();
+            }
         }
     }
+    // The compositing state is part of the frame and button keys, everything
+    // else they depend on comes from the style, the config, the palette or
+    // the button layout (the frame has no sunken background behind a lone
+    // menu button).
+    if (styleChanged || configChanges ||
+        changed & (SettingColors | SettingFont | SettingButtons)) {
+        m_frameCache.clear();
+        m_buttonCache.clear();
+    }
 
-    // Do we need to "hit the wooden hammer" ?
-    bool needHardReset = true;
-    // TODO: besides the Color and Font settings I can maybe handle more changes
-    //       without a hard reset. I will do this later...
-    if (!styleChanged && (changed & ~(SettingColors | SettingFont | SettingButtons)) == 0)
-       needHardReset = false;
-
-    if (needHardReset || configChanged) {
+    // Do we need to "hit the wooden hammer" ? A new style or tab grouping
+    // needs new decorations, other changes only need the affected clients to
+    // be laid out or repainted again.
+    if (styleChanged || configChanges & QtCurveConfig::CHANGE_GROUPING ||
+        changed & ~(SettingColors | SettingFont | SettingButtons |
+                    SettingTooltips | SettingBorder | SettingCompositing)) {
         return true;
-    } else {
-        resetDecorations(changed);
-        return false;
     }
+
+    foreach (QtCurveClient *client, m_clients) {
+        unsigned long clientChanged = changed;
+        bool titleChanged = (client->isToolWindow() ?
+                             m_titleHeightTool != oldTitleHeightTool :
+                             m_titleHeight != oldTitleHeight);
+        if (titleChanged || configChanges & QtCurveConfig::CHANGE_LAYOUT) {
+            clientChanged |= SettingFont | SettingBorder;
+        }
+        if (configChanges & QtCurveConfig::CHANGE_PAINT) {
+            clientChanged |= SettingColors;
+        }
+        if (clientChanged) {
+            client->reset(clientChanged);
+        }
+    }
+    return false;
 }
 
 void QtCurveHandler::setBorderSize()
@@ -255,14 +323,12 @@ bool QtCurveHandler::supports(Ability ability) const
     }
 }
 
-bool QtCurveHandler::readConfig(bool compositingToggled)
+int QtCurveHandler::readConfig(bool compositingToggled)
 {
     QtCurveConfig      oldConfig=m_config;
     KConfig            configFile("kwinqtcurverc");
     const KConfigGroup config(&configFile, "General");
     QFontMetrics       fm(m_titleFont);  // active font = inactive font
-    int                oldSize=m_titleHeight,
-                       oldToolSize=m_titleHeightTool;
     bool               changedBorder=false;
 
     // The title should stretch with bigger font sizes!
@@ -336,6 +402,7 @@ bool QtCurveHandler::readConfig(bool compositingToggled)
         }
     }
     bool shadowChanged(false);
+    bool shadowSizeChanged(false);
 
     if (customShadows()) {
         ShadowConfig actShadow(QPalette::Active);
@@ -347,8 +414,11 @@ bool QtCurveHandler::readConfig(bool compositingToggled)
         shadowChanged = (m_shadowCache.shadowConfigChanged(actShadow) ||
                          m_shadowCache.shadowConfigChanged(inactShadow));
 
+        qreal oldShadowSize(m_shadowCache.shadowSize());
         m_shadowCache.setShadowConfig(actShadow);
         m_shadowCache.setShadowConfig(inactShadow);
+        // The outer padding of the clients is the shadow size.
+        shadowSizeChanged = m_shadowCache.shadowSize() != oldShadowSize;
 
         if(shadowChanged || oldConfig.roundBottom()!=roundBottom())
             m_shadowCache.reset();
@@ -360,9 +430,16 @@ bool QtCurveHandler::readConfig(bool compositingToggled)
         borderSizeChanged(); // Gtk2 apps...
     }
 
-    return (changedBorder || oldSize != m_titleHeight ||
-            oldToolSize != m_titleHeightTool || shadowChanged ||
-            m_config != oldConfig);
+    int changes = m_config.diff(oldConfig);
+    if (changedBorder) {
+        changes |= QtCurveConfig::CHANGE_LAYOUT;
+    }
+    if (shadowSizeChanged) {
+        changes |= QtCurveConfig::CHANGE_LAYOUT;
+    } else if (shadowChanged) {
+        changes |= QtCurveConfig::CHANGE_PAINT;
+    }
+    return changes;
 }
 
 const QBitmap & QtCurveHandler::buttonBitmap(ButtonIcon type, const QSize &size, bool toolWindow)
@@ -419,6 +496,36 @@ void QtCurveHandler::statusBarState(unsigned int xid, bool state)
     m_lastStatusXid = xid;
 }
 
+// KWin selects property changes on the client windows, look for the ones the
+// style sets so that the clients can refresh their cached copies.
+bool
+QtCurveHandler::nativeEventFilter(const QByteArray &eventType, void *message,
+                                  long*)
+{
+    if (eventType != "xcb_generic_event_t") {
+        return false;
+    }
+    auto *event = static_cast<xcb_generic_event_t*>(message);
+    if ((event->response_type & ~0x80) != XCB_PROPERTY_NOTIFY) {
+        return false;
+    }
+    auto *notify = reinterpret_cast<xcb_property_notify_event_t*>(event);
+    if (notify->atom != qtc_x11_qtc_menubar_size &&
+        notify->atom != qtc_x11_qtc_statusbar &&
+        notify->atom != qtc_x11_qtc_opacity &&
+        notify->atom != qtc_x11_qtc_bgnd) {
+        return false;
+    }
+    foreach (QtCurveClient *client, m_clients) {
+        if (client->windowId() == notify->window) {
+            client->readWindowProps();
+            client->widget()->update();
+            break;
+        }
+    }
+    return false;
+}
+
 void QtCurveHandler::emitToggleMenuBar(int xid)
 {
     m_dBus->emitMbToggle(xid);
@@ -436,12 +543,9 @@ QtCurveHandler::borderEdgeSize() const
     if (!outerBorder()) {
         return edgePad + 1;
     } else if (m_config.borderSize() <= QtCurveConfig::BORDER_NO_SIDES ||
-               wStyle()->pixelMetric((QStyle::PixelMetric)QtC_Round,
-                                     nullptr, nullptr) >= ROUND_FULL) {
+               m_styleMetrics.round >= ROUND_FULL) {
         return edgePad + 3;
-    } else if (wStyle()->pixelMetric((QStyle::PixelMetric)QtC_WindowBorder,
-                                     nullptr, nullptr) &
-               WINDOW_BORDER_ADD_LIGHT_BORDER) {
+    } else if (m_styleMetrics.windowBorder & WINDOW_BORDER_ADD_LIGHT_BORDER) {
         return edgePad + 2;
     } else {
         return edgePad + 1;
@@ -32,12 +32,14 @@
 
 #include <QFont>
 #include <QApplication>
+#include <QAbstractNativeEventFilter>
 #include <QBitmap>
 #include <kdeversion.h>
 #include <kdecoration.h>
 #include <kdecorationfactory.h>
 #include "config.h"
 #include "qtcurveconfig.h"
+#include "qtcurveframelayer.h"
 #include "qtcurveshadowcache.h"
 
 class QStyle;
@@ -75,9 +77,27 @@ class QtCurveDBus;
 #define _KDecorationFactoryBase KDecorationFactory
 #endif
 
-class QtCurveHandler : public QObject, public _KDecorationFactoryBase {
+class QtCurveHandler : public QObject, public _KDecorationFactoryBase,
+                       public QAbstractNativeEventFilter {
     Q_OBJECT
 public:
+    //! style settings used to paint a decoration, read once per style
+    struct StyleMetrics {
+        int windowBorder;
+        int round;
+        int titleBarButtons;
+        int titleBarIcon;
+        int titleAlignment;
+        int titleBarEffect;
+        int toggleButtons;
+        bool blendMenuAndTitleBar;
+        bool shadeMenubarOnlyWhenActive;
+        QRgb menubarColor;
+        //! title bar appearance, inactive and active
+        int titleBarApp[2];
+        int smallIconSize;
+    };
+
     QtCurveHandler();
     ~QtCurveHandler();
     void setStyle();
@@ -86,6 +106,8 @@ public:
 
     KDecoration *createDecoration(KDecorationBridge*) override;
     bool supports(Ability ability) const override;
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           long *result) override;
 
     const QBitmap &buttonBitmap(ButtonIcon type, const QSize &size,
                                 bool toolWindow);
@@ -141,6 +163,11 @@ public:
     {
         return m_style ? m_style : QApplication::style();
     }
+    const StyleMetrics&
+    styleMetrics() const
+    {
+        return m_styleMetrics;
+    }
     int borderEdgeSize() const;
     int
     titleBarPad() const
@@ -177,6 +204,17 @@ public:
     {
         return m_shadowCache;
     }
+    FrameCache&
+    frameCache()
+    {
+        return m_frameCache;
+    }
+    //! composed title bar buttons, see QtCurveButton::drawButton()
+    PixmapCache&
+    buttonCache()
+    {
+        return m_buttonCache;
+    }
     bool
     grouping() const
     {
@@ -208,7 +246,8 @@ public:
         return m_hoverCols[active ? 1 : 0];
     }
 private:
-    bool readConfig(bool compositingToggled=false);
+    int readConfig(bool compositingToggled=false);
+    void updateStyleMetrics();
 
     int m_borderSize;
     int m_titleHeight;
@@ -219,12 +258,15 @@ private:
     QFont m_titleFont;
     QFont m_titleFontTool;
     QStyle *m_style;
+    StyleMetrics m_styleMetrics;
     QBitmap m_bitmaps[2][NumButtonIcons];
     QtCurveConfig m_config;
     QList<QtCurveClient*> m_clients;
     QtCurveDBus *m_dBus;
     QColor m_hoverCols[2];
     QtCurveShadowCache m_shadowCache;
+    FrameCache m_frameCache;
+    PixmapCache m_buttonCache;
 };
 QtCurveHandler *Handler();
 }
@@ -50,6 +50,7 @@
 
 #include <KColorUtils>
 #include <KColorScheme>
+#include <QImage>
 #include <QPainter>
 
 #include <style/qtcurve.h>
@@ -95,8 +96,10 @@ static QColor calcLightColor(const QColor &color)
 QtCurveShadowCache::QtCurveShadowCache()
                   : m_activeShadowConfig(ShadowConfig(QPalette::Active))
                   , m_inactiveShadowConfig(ShadowConfig(QPalette::Inactive))
+                  , m_shadowCache(4 << 20) // about 25 of the largest tilesets
 {
-    m_shadowCache.setMaxCost(1<<6);
+    m_activeRenderer.setup(m_activeShadowConfig);
+    m_inactiveRenderer.setup(m_inactiveShadowConfig);
 }
 
 bool QtCurveShadowCache::shadowConfigChanged(const ShadowConfig &other) const
@@ -111,193 +114,59 @@ void QtCurveShadowCache::setShadowConfig(const ShadowConfig &other)
     auto &local = (other.colorGroup() == QPalette::Active ?
                    m_activeShadowConfig : m_inactiveShadowConfig);
     local = other;
+    (other.colorGroup() == QPalette::Active ?
+     m_activeRenderer : m_inactiveRenderer).setup(other);
     reset();
 }
 
-TileSet*
-QtCurveShadowCache::tileSet(const QtCurveClient *client, bool roundAllCorners)
+// Background color of the window, drawn in the corners of the shadow.
+static QRgb
+windowColor(const QtCurveClient *client)
 {
-    Key key(client);
-    int hash(key.hash());
-
-    if (m_shadowCache.contains(hash))
-        return m_shadowCache.object(hash);
-
-    qreal   size(shadowSize());
-    TileSet *tileSet = new TileSet(shadowPixmap(client, key.active, roundAllCorners), size, size, 1, 1);
+    return client->widget()->palette()
+        .color(client->widget()->backgroundRole()).rgba();
+}
 
-    m_shadowCache.insert(hash, tileSet);
+TileSet
+QtCurveShadowCache::tileSet(const QtCurveClient *client, bool roundAllCorners)
+{
+    bool active(client->isActive());
+    QRgb color(windowColor(client));
+    // Every input of the shadow pixmap, only equal keys share a TileSet.
+    PixmapKey key(PixmapKey::KEY_SHADOW, color,
+                  quint32(active | client->isShade() << 1 |
+                          roundAllCorners << 2));
+    TileSet tileSet;
+
+    if (!m_shadowCache.find(key, &tileSet)) {
+        qreal size(shadowSize());
+        tileSet = TileSet(simpleShadowPixmap(QColor::fromRgba(color), active,
+                                             roundAllCorners),
+                          size, size, 1, 1);
+        m_shadowCache.insert(key, tileSet);
+    }
     return tileSet;
 }
 
 QPixmap QtCurveShadowCache::shadowPixmap(const QtCurveClient *client, bool active, bool roundAllCorners) const
 {
-    Key      key(client);
-    QPalette palette(client->widget()->palette());
-    QColor   color(palette.color(client->widget()->backgroundRole()));
-
-    return simpleShadowPixmap(color, active, roundAllCorners);
+    return simpleShadowPixmap(QColor::fromRgba(windowColor(client)), active,
+                              roundAllCorners);
 }
 
 QPixmap QtCurveShadowCache::simpleShadowPixmap(const QColor &color, bool active, bool roundAllCorners) const
 {
-    static const qreal fixedSize = 25.5;
+    qreal  size(shadowSize());
+    QImage shadow(size*2, size*2, QImage::Format_ARGB32_Premultiplied);
 
-    const ShadowConfig &shadowConfig(active ? m_activeShadowConfig : m_inactiveShadowConfig);
-
-    // offsets are scaled with the shadow size
-    // so that the ratio Top-shadow/Bottom-shadow is kept constant when shadow size is changed
-    qreal   size(shadowSize()),
-            shadowSize(shadowConfig.shadowSize());
-    QPixmap shadow(size*2, size*2);
-
-    shadow.fill(Qt::transparent);
+    (active ? m_activeRenderer : m_inactiveRenderer).render(shadow, size,
+                                                            roundAllCorners);
 
     QPainter p(&shadow);
 
     p.setRenderHint(QPainter::Antialiasing);
     p.setPen(Qt::NoPen);
 
-    if (shadowSize) {
-        if (ShadowConfig::SH_ACTIVE == shadowConfig.shadowType()) {
-            {
-                // inner (shark) gradient
-                const qreal gradientSize = qMin(shadowSize,
-                                                (shadowSize + fixedSize) / 2);
-                const qreal hoffset = (shadowConfig.horizontalOffset() / 100. *
-                                       gradientSize / fixedSize);
-                const qreal voffset = (shadowConfig.verticalOffset() / 100. *
-                                       gradientSize / fixedSize);
-
-                QRadialGradient rg = QRadialGradient(size + 12. * hoffset,
-                                                     size + 12. * voffset,
-                                                     gradientSize);
-                rg.setColorAt(1, Qt::transparent);
-
-                // gaussian shadow is used
-                int nPoints(10 * gradientSize / fixedSize);
-                Gaussian f(0.85, 0.25);
-                QColor c = shadowConfig.innerColor();
-                for (int i = 0;i < nPoints;i++) {
-                    qreal x = qreal(i) / nPoints;
-                    c.setAlphaF(f(x));
-                    rg.setColorAt(x, c);
-                }
-
-                p.setBrush(rg);
-                renderGradient(p, shadow.rect(), rg, roundAllCorners);
-            }
-
-            {
-                // outer (spread) gradient
-                const qreal gradientSize = shadowSize;
-                const qreal hoffset = (shadowConfig.horizontalOffset() / 100. *
-                                       gradientSize / fixedSize);
-                const qreal voffset = (shadowConfig.verticalOffset() / 100. *
-                                       gradientSize / fixedSize);
-
-                QRadialGradient rg = QRadialGradient(size + 12. * hoffset,
-                                                     size + 12. * voffset,
-                                                     gradientSize);
-                rg.setColorAt(1, Qt::transparent);
-
-                // gaussian shadow is used
-                int nPoints(10 * gradientSize / fixedSize);
-                Gaussian f(0.46, 0.42);
-                QColor c = shadowConfig.outerColor();
-                for (int i = 0;i < nPoints;i++) {
-                    qreal x = qreal(i) / nPoints;
-                    c.setAlphaF(f(x));
-                    rg.setColorAt(x, c);
-                }
-                p.setBrush(rg);
-                p.drawRect(shadow.rect());
-            }
-        } else {
-            {
-                // inner (sharp gradient)
-                const qreal gradientSize = qMin(shadowSize, fixedSize);
-                const qreal hoffset = (shadowConfig.horizontalOffset() / 100. *
-                                       gradientSize / fixedSize);
-                const qreal voffset = (shadowConfig.verticalOffset() / 100. *
-                                       gradientSize / fixedSize);
-
-                QRadialGradient rg = QRadialGradient(size + hoffset,
-                                                     size + voffset,
-                                                     gradientSize);
-                rg.setColorAt(1, Qt::transparent);
-
-                // parabolic shadow is used
-                int nPoints(10 * gradientSize / fixedSize);
-                Parabolic f(0.85, 0.22);
-                QColor c = shadowConfig.outerColor();
-                for (int i = 0;i < nPoints;i++) {
-                    qreal x = qreal(i) / nPoints;
-                    c.setAlphaF(f(x));
-                    rg.setColorAt(x, c);
-                }
-
-                p.setBrush(rg);
-                renderGradient(p, shadow.rect(), rg, roundAllCorners);
-            }
-
-            {
-                // mid gradient
-                const qreal gradientSize = qMin(shadowSize,
-                                                (shadowSize +
-                                                 2 * fixedSize) / 3);
-                const qreal hoffset = (shadowConfig.horizontalOffset() / 100. *
-                                       gradientSize / fixedSize);
-                const qreal voffset = (shadowConfig.verticalOffset() / 100. *
-                                       gradientSize / fixedSize);
-
-                // gaussian shadow is used
-                QRadialGradient rg = QRadialGradient(size + 8. * hoffset,
-                                                     size + 8. * voffset,
-                                                     gradientSize);
-                rg.setColorAt(1, Qt::transparent);
-
-                int nPoints(10 * gradientSize / fixedSize);
-                Gaussian f(0.54, 0.21);
-                QColor c = shadowConfig.outerColor();
-                for (int i = 0;i < nPoints;i++) {
-                    qreal x = qreal(i) / nPoints;
-                    c.setAlphaF(f(x));
-                    rg.setColorAt(x, c);
-                }
-
-                p.setBrush(rg);
-                p.drawRect(shadow.rect());
-            }
-            {
-                // outer (spread) gradient
-                const qreal gradientSize = shadowSize;
-                const qreal hoffset = (shadowConfig.horizontalOffset() / 100. *
-                                       gradientSize / fixedSize);
-                const qreal voffset = (shadowConfig.verticalOffset() / 100. *
-                                       gradientSize / fixedSize);
-
-                // gaussian shadow is used
-                QRadialGradient rg = QRadialGradient(size + 20. * hoffset,
-                                                     size + 20. * voffset,
-                                                     gradientSize);
-                rg.setColorAt(1, Qt::transparent);
-
-                int nPoints(20 * gradientSize / fixedSize);
-                Gaussian f(0.155, 0.445);
-                QColor c = shadowConfig.outerColor();
-                for (int i = 0;i < nPoints;i++) {
-                    qreal x = qreal(i) / nPoints;
-                    c.setAlphaF(f(x));
-                    rg.setColorAt(x, c);
-                }
-
-                p.setBrush(rg);
-                p.drawRect(shadow.rect());
-            }
-        }
-    }
-
     // draw the corner of the window - actually all 4 corners as one circle
     // this is all fixedSize. Does not scale with shadow size
     QLinearGradient lg = QLinearGradient(0.0, size-4.5, 0.0, size+4.5);
@@ -308,121 +177,7 @@ QPixmap QtCurveShadowCache::simpleShadowPixmap(const QColor &color, bool active,
     p.setBrush(lg);
     p.drawEllipse(QRectF(size-4, size-4, 8, 8));
     p.end();
-    return shadow;
-}
-
-void QtCurveShadowCache::renderGradient(QPainter &p, const QRectF &rect, const QRadialGradient &rg, bool hasBorder) const
-{
-    if( hasBorder )
-    {
-        p.setBrush( rg );
-        p.drawRect( rect );
-        return;
-    }
-
-
-    qreal          size(rect.width() / 2.0),
-                   hoffset(rg.center().x() - size),
-                   voffset(rg.center().y() - size),
-                   radius(rg.radius());
-    QGradientStops stops(rg.stops());
-
-    // draw ellipse for the upper rect
-    {
-        QRectF rect(hoffset, voffset, 2*size-hoffset, size);
-        p.setBrush(rg);
-        p.drawRect(rect);
-    }
-
-    // draw square gradients for the lower rect
-    {
-        // vertical lines
-        QRectF          rect(hoffset, size+voffset, 2*size-hoffset, 4);
-        QLinearGradient lg(hoffset, 0.0, 2*size+hoffset, 0.0);
-
-        for(int i = 0; i<stops.size(); i++)
-        {
-            QColor c(stops[i].second);
-            qreal  xx(stops[i].first*radius);
-
-            lg.setColorAt((size - xx) / (2. * size), c);
-            lg.setColorAt((size + xx) / (2. * size), c);
-        }
-
-        p.setBrush(lg);
-        p.drawRect(rect);
-    }
-
-    {
-        // horizontal line
-        QRectF          rect(size-4+hoffset, size+voffset, 8, size);
-        QLinearGradient lg = QLinearGradient(0, voffset, 0, 2*size+voffset);
-
-        for(int i = 0; i<stops.size(); i++)
-        {
-            QColor c(stops[i].second);
-            qreal  xx(stops[i].first*radius);
-
-            lg.setColorAt((size + xx) / (2. * size), c);
-        }
-
-        p.setBrush(lg);
-        p.drawRect(rect);
-    }
-
-    {
-      // bottom-left corner
-        QRectF          rect(hoffset, size+4+voffset, size-4, size);
-        QRadialGradient rg = QRadialGradient(size+hoffset-4, size+4+voffset, radius);
-
-        for(int i = 0; i<stops.size(); i++)
-        {
-            QColor c(stops[i].second);
-            qreal  xx(stops[i].first -4.0/rg.radius());
-
-            if(xx<0 && i < stops.size()-1)
-            {
-                qreal x1(stops[i+1].first -4.0/rg.radius());
-                c = KColorUtils::mix(c, stops[i+1].second, -xx/(x1-xx));
-                xx = 0;
-            }
-
-            rg.setColorAt(xx, c);
-        }
-
-        p.setBrush(rg);
-        p.drawRect(rect);
-    }
-
-    {
-      // bottom-right corner
-        QRectF          rect(size+4+hoffset, size+4+voffset, size-4, size);
-        QRadialGradient rg = QRadialGradient(size+hoffset+4, size+4+voffset, radius);
-
-        for(int i = 0; i<stops.size(); i++)
-        {
-            QColor c(stops[i].second);
-            qreal  xx(stops[i].first -4.0/rg.radius());
-
-            if(xx<0 && i < stops.size()-1)
-            {
-                qreal x1(stops[i+1].first -4.0/rg.radius());
-                c = KColorUtils::mix(c, stops[i+1].second, -xx/(x1-xx));
-                xx = 0;
-            }
-
-            rg.setColorAt(xx, c);
-        }
-
-        p.setBrush(rg);
-        p.drawRect(rect);
-    }
-}
-
-QtCurveShadowCache::Key::Key(const QtCurveClient *client)
-                       : active(client->isActive())
-                       , isShade(client->isShade())
-{
+    return QPixmap::fromImage(shadow);
 }
 
 }
@@ -52,14 +52,11 @@
 //#define NEW_SHADOWS
 
 #include "qtcurveshadowconfiguration.h"
-#include "tileset.h"
+#include "qtcurveshadowrenderer.h"
+#include <style/tileset.h>
+#include <style/pixmapcache.h>
 
-#include <qtcurve-utils/number.h>
-
-#include <QCache>
-#include <QRadialGradient>
-
-#include <cmath>
+#include <QVariantMap>
 
 class QtCurveHelper;
 
@@ -82,7 +79,7 @@ public:
     void
     invalidateCaches()
     {
-        m_shadowCache.clear();
+        reset();
     }
 
     //! returns true if provided shadow configuration changes with respect to
@@ -112,56 +109,7 @@ public:
         return qMax(size, 5.0);
     }
 
-    TileSet *tileSet(const QtCurveClient *client, bool roundAllCorners);
-
-    //! Key class to be used into QCache
-    /*! class is entirely inline for optimization */
-    class Key {
-    public:
-        explicit Key() : active(false), isShade(false) {}
-        Key(const QtCurveClient *client);
-        Key(int hash) : active((hash >> 1) & 1), isShade(hash & 1) {}
-
-        int hash() const
-        {
-            return (active << 1) | isShade;
-        }
-
-        const bool active;
-        const bool isShade;
-    };
-
-    class Parabolic {
-    public:
-        //! constructor
-        Parabolic(qreal amplitude, qreal width)
-            : m_amplitude(amplitude), m_width(width) {}
-        //! value
-        qreal
-        operator() (qreal x) const
-        {
-            return qMax(0.0, m_amplitude * (1.0 - qtcSquare(x / m_width)));
-        }
-    private:
-        const qreal m_amplitude;
-        const qreal m_width;
-    };
-
-    class Gaussian {
-    public:
-        Gaussian(qreal amplitude, qreal width)
-            : m_amplitude(amplitude), m_width(width) {}
-        //! value
-        qreal
-        operator() (qreal x) const
-        {
-            return qMax(0.0, m_amplitude *
-                        (std::exp(-qtcSquare(x / m_width) - 0.05)));
-        }
-    private:
-        const qreal m_amplitude;
-        const qreal m_width;
-    };
+    TileSet tileSet(const QtCurveClient *client, bool roundAllCorners);
 
     //! complex pixmap (when needed)
     QPixmap shadowPixmap(const QtCurveClient *client, bool active,
@@ -171,19 +119,32 @@ public:
     QPixmap simpleShadowPixmap(const QColor &color, bool active,
                                bool roundAllCorners) const;
 
-    void reset() { m_shadowCache.clear(); }
+    void
+    reset()
+    {
+        m_shadowCache.clear();
+    }
 
-private:
-    //! draw gradient into rect
-    /*! a separate method is used in order to properly account for corners */
-    void renderGradient(QPainter &p, const QRectF &rect,
-                        const QRadialGradient &rg, bool hasBorder) const;
+    //! byte budget of the cached tilesets
+    void
+    setMaxCost(int bytes)
+    {
+        m_shadowCache.setMaxCost(bytes);
+    }
 
-    typedef QCache<int, TileSet> TileSetCache;
+    //! hit, miss and eviction counters and the memory used by the cache
+    void
+    addStatistics(QVariantMap &stats, const QString &name) const
+    {
+        m_shadowCache.addStatistics(stats, name);
+    }
 
+private:
     ShadowConfig m_activeShadowConfig;
     ShadowConfig m_inactiveShadowConfig;
-    TileSetCache m_shadowCache;
+    ShadowRenderer m_activeRenderer;
+    ShadowRenderer m_inactiveRenderer;
+    RenderCache<TileSet> m_shadowCache;
 };
 
 }
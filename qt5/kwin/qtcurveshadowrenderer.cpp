@@ -0,0 +1,188 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "qtcurveshadowrenderer.h"
+
+#include <QImage>
+
+namespace QtCurve {
+namespace KWin {
+
+template<typename F>
+void
+ShadowRenderer::addLayer(const QColor &color, qreal hoffset, qreal voffset,
+                         qreal radius, int nPoints, const F &f, bool sharp)
+{
+    // A gradient with only the transparent stop at 1 draws nothing.
+    if (nPoints <= 0 || radius <= 0) {
+        return;
+    }
+    QVector<float> stops(nPoints + 1);
+    for (int i = 0;i < nPoints;i++) {
+        stops[i] = qBound(0.0, f(qreal(i) / nPoints), 1.0);
+    }
+    stops[nPoints] = 0;
+
+    Layer layer;
+    layer.hoffset = hoffset;
+    layer.voffset = voffset;
+    layer.invRadius2 = 1 / (radius * radius);
+    layer.red = color.redF();
+    layer.green = color.greenF();
+    layer.blue = color.blueF();
+    layer.sharp = sharp;
+    // Stops are interpolated linearly along the radius, as QGradient does.
+    layer.ramp.resize(constRampSize + 1);
+    for (int i = 0;i <= constRampSize;i++) {
+        qreal x = std::sqrt(qreal(i) / constRampSize) * nPoints;
+        int stop = qMin(int(x), nPoints - 1);
+        layer.ramp[i] = stops[stop] + (stops[stop + 1] - stops[stop]) *
+            (x - stop);
+    }
+    m_layers.append(layer);
+}
+
+void
+ShadowRenderer::setup(ShadowConfig::ShadowType type, int shadowSize,
+                      int hOffset, int vOffset, const QColor &innerColor,
+                      const QColor &outerColor)
+{
+    static const qreal fixedSize = 25.5;
+
+    m_layers.clear();
+    if (shadowSize <= 0) {
+        return;
+    }
+    // offsets are scaled with the shadow size so that the ratio
+    // Top-shadow/Bottom-shadow is kept constant when shadow size is changed
+    auto hoffset = [&] (qreal gradientSize) {
+        return hOffset / 100. * gradientSize / fixedSize;
+    };
+    auto voffset = [&] (qreal gradientSize) {
+        return vOffset / 100. * gradientSize / fixedSize;
+    };
+    if (ShadowConfig::SH_ACTIVE == type) {
+        // inner (shark) gradient
+        qreal gradientSize = qMin<qreal>(shadowSize,
+                                         (shadowSize + fixedSize) / 2);
+        addLayer(innerColor, 12. * hoffset(gradientSize),
+                 12. * voffset(gradientSize), gradientSize,
+                 10 * gradientSize / fixedSize, Gaussian(0.85, 0.25), true);
+
+        // outer (spread) gradient
+        gradientSize = shadowSize;
+        addLayer(outerColor, 12. * hoffset(gradientSize),
+                 12. * voffset(gradientSize), gradientSize,
+                 10 * gradientSize / fixedSize, Gaussian(0.46, 0.42), false);
+    } else {
+        // inner (sharp gradient)
+        qreal gradientSize = qMin<qreal>(shadowSize, fixedSize);
+        addLayer(outerColor, hoffset(gradientSize), voffset(gradientSize),
+                 gradientSize, 10 * gradientSize / fixedSize,
+                 Parabolic(0.85, 0.22), true);
+
+        // mid gradient
+        gradientSize = qMin<qreal>(shadowSize,
+                                   (shadowSize + 2 * fixedSize) / 3);
+        addLayer(outerColor, 8. * hoffset(gradientSize),
+                 8. * voffset(gradientSize), gradientSize,
+                 10 * gradientSize / fixedSize, Gaussian(0.54, 0.21), false);
+
+        // outer (spread) gradient
+        gradientSize = shadowSize;
+        addLayer(outerColor, 20. * hoffset(gradientSize),
+                 20. * voffset(gradientSize), gradientSize,
+                 20 * gradientSize / fixedSize, Gaussian(0.155, 0.445),
+                 false);
+    }
+}
+
+// Below its center the inner layer is drawn as a rounded square: a band of
+// 4 pixels follows the horizontal distance, a column of 8 pixels follows the
+// vertical one and the two corners are radial around points 4 pixels away.
+float
+ShadowRenderer::Layer::squareAlpha(float dx, float dy) const
+{
+    float dist;
+    if (dy <= 4) {
+        dist = dx <= 4 ? qMax(dx, dy) : dx;
+    } else if (dx <= 4) {
+        dist = dy;
+    } else {
+        dist = std::sqrt(qtcSquare(dx - 4) + qtcSquare(dy - 4)) + 4;
+    }
+    return alpha(dist * dist);
+}
+
+void
+ShadowRenderer::render(QImage &image, qreal size, bool roundAllCorners) const
+{
+    Q_ASSERT(image.format() == QImage::Format_ARGB32_Premultiplied);
+    const int width = image.width();
+    const int height = image.height();
+    const int nLayers = m_layers.size();
+
+    // The distance to the center is separable, the horizontal part of every
+    // layer is computed once per column, the vertical part once per row.
+    QVector<float> columns(width * nLayers);
+    for (int l = 0;l < nLayers;l++) {
+        const qreal center = size + m_layers[l].hoffset;
+        for (int x = 0;x < width;x++) {
+            columns[l * width + x] = qAbs(x + 0.5 - center);
+        }
+    }
+    QVector<float> pixels(width * 4);
+    for (int y = 0;y < height;y++) {
+        pixels.fill(0);
+        for (int l = 0;l < nLayers;l++) {
+            const Layer &layer = m_layers[l];
+            const float *dx = columns.constData() + l * width;
+            const float dy = y + 0.5 - (size + layer.voffset);
+            const float dy2 = dy * dy;
+            const bool square = layer.sharp && !roundAllCorners && dy >= 0;
+            float *pixel = pixels.data();
+            // Source over of the layer color with the ramp alpha.
+            for (int x = 0;x < width;x++, pixel += 4) {
+                const float alpha = (square ? layer.squareAlpha(dx[x], dy) :
+                                     layer.alpha(dx[x] * dx[x] + dy2));
+                if (alpha <= 0) {
+                    continue;
+                }
+                const float keep = 1 - alpha;
+                pixel[0] = layer.red * alpha + pixel[0] * keep;
+                pixel[1] = layer.green * alpha + pixel[1] * keep;
+                pixel[2] = layer.blue * alpha + pixel[2] * keep;
+                pixel[3] = alpha + pixel[3] * keep;
+            }
+        }
+        QRgb *line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        const float *pixel = pixels.constData();
+        for (int x = 0;x < width;x++, pixel += 4) {
+            line[x] = qRgba(int(pixel[0] * 255 + 0.5f),
+                            int(pixel[1] * 255 + 0.5f),
+                            int(pixel[2] * 255 + 0.5f),
+                            int(pixel[3] * 255 + 0.5f));
+        }
+    }
+}
+
+}
+}
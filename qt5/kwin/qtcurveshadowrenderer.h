@@ -0,0 +1,136 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTCURVESHADOWRENDERER_H__
+#define __QTCURVESHADOWRENDERER_H__
+
+#include "qtcurveshadowconfiguration.h"
+
+#include <qtcurve-utils/number.h>
+
+#include <QColor>
+#include <QVector>
+
+#include <cmath>
+
+class QImage;
+
+namespace QtCurve {
+namespace KWin {
+
+/**
+ * Renders the shadow layers of one ShadowConfig directly into an ARGB32
+ * image. The alpha ramp of every layer is tabulated once when the
+ * configuration is set, rendering a shadow is then a table lookup per pixel
+ * and layer instead of building and rasterizing QRadialGradient's.
+ */
+class ShadowRenderer {
+public:
+    class Parabolic {
+    public:
+        //! constructor
+        Parabolic(qreal amplitude, qreal width)
+            : m_amplitude(amplitude), m_width(width) {}
+        //! value
+        qreal
+        operator() (qreal x) const
+        {
+            return qMax(0.0, m_amplitude * (1.0 - qtcSquare(x / m_width)));
+        }
+    private:
+        const qreal m_amplitude;
+        const qreal m_width;
+    };
+
+    class Gaussian {
+    public:
+        Gaussian(qreal amplitude, qreal width)
+            : m_amplitude(amplitude), m_width(width) {}
+        //! value
+        qreal
+        operator() (qreal x) const
+        {
+            return qMax(0.0, m_amplitude *
+                        (std::exp(-qtcSquare(x / m_width) - 0.05)));
+        }
+    private:
+        const qreal m_amplitude;
+        const qreal m_width;
+    };
+
+    //! tabulate the layers of a shadow configuration
+    void setup(ShadowConfig::ShadowType type, int shadowSize, int hOffset,
+               int vOffset, const QColor &innerColor,
+               const QColor &outerColor);
+    void
+    setup(const ShadowConfig &config)
+    {
+        setup(config.shadowType(), config.shadowSize(),
+              config.horizontalOffset(), config.verticalOffset(),
+              config.innerColor(), config.outerColor());
+    }
+
+    //! render the shadow centered in a Format_ARGB32_Premultiplied image
+    /*!
+     * size is the distance from the image border to the center of the
+     * shadow. Unless roundAllCorners is set, the bottom half of the inner
+     * layer follows the square window corners.
+     */
+    void render(QImage &image, qreal size, bool roundAllCorners) const;
+
+private:
+    // Number of steps of a ramp, indexed by the squared distance to the
+    // center relative to the radius of the layer.
+    static const int constRampSize = 1024;
+
+    struct Layer {
+        qreal hoffset;
+        qreal voffset;
+        float invRadius2;
+        float red;
+        float green;
+        float blue;
+        bool sharp;
+        QVector<float> ramp;
+
+        float
+        alpha(float dist2) const
+        {
+            float t = dist2 * invRadius2;
+            if (t >= 1) {
+                return 0;
+            }
+            return ramp[int(t * constRampSize + 0.5f)];
+        }
+        float squareAlpha(float dx, float dy) const;
+    };
+
+    template<typename F>
+    void addLayer(const QColor &color, qreal hoffset, qreal voffset,
+                  qreal radius, int nPoints, const F &f, bool sharp);
+
+    QVector<Layer> m_layers;
+};
+
+}
+}
+
+#endif
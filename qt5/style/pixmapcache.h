@@ -0,0 +1,261 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTCURVE_PIXMAPCACHE_H__
+#define __QTCURVE_PIXMAPCACHE_H__
+
+#include <QCache>
+#include <QColor>
+#include <QHash>
+#include <QPixmap>
+#include <QString>
+#include <QVariantMap>
+
+#include <string.h>
+#include <type_traits>
+
+namespace QtCurve {
+
+/**
+ * Key of a PixmapCache entry. All the inputs of a cached rendering are packed
+ * into a fixed array of words and hashed once when the key is built, so
+ * creating, hashing and comparing keys never allocates.
+ */
+class PixmapKey {
+public:
+    enum Type {
+        KEY_BEVEL,
+        KEY_SELECTION,
+        KEY_BACKGROUND,
+        KEY_SHINE,
+        KEY_STRIPES,
+        KEY_GRADIENT,
+        KEY_PROGRESS,
+        KEY_PIXMAP,
+        KEY_DECORATION,
+        KEY_BUTTON,
+        KEY_SHADOW
+    };
+
+    template<typename... Args>
+    explicit PixmapKey(Type type, const Args&... args)
+        : m_type(type),
+          m_size(0)
+    {
+        static_assert(WordCount<Args...>::value <= constMaxWords,
+                      "Too many inputs for a PixmapKey");
+        push(args...);
+        uint hash = 2166136261u ^ m_type;
+        for (int i = 0;i < m_size;i++) {
+            hash = (hash ^ m_data[i]) * 16777619u;
+            hash ^= hash >> 15;
+        }
+        m_hash = hash;
+    }
+    uint
+    hash() const
+    {
+        return m_hash;
+    }
+    // Raw inputs, the key of a SharedCache entry.
+    const quint32*
+    data() const
+    {
+        return m_data;
+    }
+    int
+    dataSize() const
+    {
+        return m_size * sizeof(quint32);
+    }
+    bool
+    operator==(const PixmapKey &other) const
+    {
+        return (m_hash == other.m_hash && m_type == other.m_type &&
+                m_size == other.m_size &&
+                memcmp(m_data, other.m_data, m_size * sizeof(quint32)) == 0);
+    }
+
+private:
+    static const int constMaxWords = 12;
+
+    // Number of words append() uses for the arguments, doubles take two.
+    template<typename... Args>
+    struct WordCount {
+        static constexpr int value = 0;
+    };
+    template<typename T, typename... Rest>
+    struct WordCount<T, Rest...> {
+        static constexpr int value =
+            (std::is_floating_point<T>::value ? 2 : 1) +
+            WordCount<Rest...>::value;
+    };
+
+    void
+    push()
+    {
+    }
+    template<typename T, typename... Rest>
+    void
+    push(const T &first, const Rest&... rest)
+    {
+        append(first);
+        push(rest...);
+    }
+    void
+    append(quint32 val)
+    {
+        Q_ASSERT(m_size < constMaxWords);
+        m_data[m_size++] = val;
+    }
+    void
+    append(int val)
+    {
+        append(quint32(val));
+    }
+    void
+    append(const QColor &col)
+    {
+        append(quint32(col.rgba()));
+    }
+    void
+    append(double val)
+    {
+        quint32 words[2];
+        memcpy(words, &val, sizeof(words));
+        append(words[0]);
+        append(words[1]);
+    }
+
+    quint32 m_data[constMaxWords];
+    uint m_hash;
+    quint8 m_type;
+    quint8 m_size;
+};
+
+static inline uint
+qHash(const PixmapKey &key)
+{
+    return key.hash();
+}
+
+static inline int
+cacheCost(const QPixmap &pix)
+{
+    return pix.width() * pix.height() * (pix.depth() / 8);
+}
+
+/**
+ * Style owned cache of rendered objects (pixmaps, tilesets), the cost of an
+ * entry is its size in bytes as returned by cacheCost().
+ * Unlike QPixmapCache it is not shared with the application and it does not
+ * need a string key.
+ */
+template<typename T>
+class RenderCache {
+public:
+    explicit RenderCache(int maxBytes)
+        : m_cache(maxBytes),
+          m_hits(0),
+          m_misses(0),
+          m_evictions(0),
+          m_rejects(0)
+    {
+    }
+    bool
+    find(const PixmapKey &key, T *obj)
+    {
+        if (T *cached = m_cache.object(key)) {
+            m_hits++;
+            *obj = *cached;
+            return true;
+        }
+        m_misses++;
+        return false;
+    }
+    void
+    insert(const PixmapKey &key, const T &obj)
+    {
+        int cost = cacheCost(obj);
+        if (cost >= m_cache.maxCost()) {
+            m_rejects++;
+            return;
+        }
+        int count = m_cache.count() + (m_cache.contains(key) ? 0 : 1);
+        m_cache.insert(key, new T(obj), cost);
+        m_evictions += count - m_cache.count();
+    }
+    void
+    clear()
+    {
+        m_cache.clear();
+    }
+    void
+    setMaxCost(int maxBytes)
+    {
+        int count = m_cache.count();
+        m_cache.setMaxCost(maxBytes);
+        m_evictions += count - m_cache.count();
+    }
+    void
+    addStatistics(QVariantMap &stats, const QString &name) const
+    {
+        stats[name + QLatin1String(".hits")] = m_hits;
+        stats[name + QLatin1String(".misses")] = m_misses;
+        stats[name + QLatin1String(".evictions")] = m_evictions;
+        stats[name + QLatin1String(".rejects")] = m_rejects;
+        stats[name + QLatin1String(".collisions")] = hashCollisions();
+        stats[name + QLatin1String(".count")] = m_cache.count();
+        stats[name + QLatin1String(".cost")] = m_cache.totalCost();
+        stats[name + QLatin1String(".maxCost")] = m_cache.maxCost();
+    }
+
+private:
+    // Number of cached keys sharing their hash with another cached key.
+    // Those still compare different, but they make lookups slower.
+    int
+    hashCollisions() const
+    {
+        QHash<uint, int> hashes;
+        for (const PixmapKey &key: m_cache.keys()) {
+            hashes[key.hash()]++;
+        }
+        int collisions = 0;
+        for (int n: hashes) {
+            if (n > 1) {
+                collisions += n;
+            }
+        }
+        return collisions;
+    }
+
+    QCache<PixmapKey, T> m_cache;
+    quint64 m_hits;
+    quint64 m_misses;
+    quint64 m_evictions;
+    quint64 m_rejects;
+};
+
+typedef RenderCache<QPixmap> PixmapCache;
+
+}
+
+#endif
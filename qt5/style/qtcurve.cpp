@@ -24,6 +24,7 @@
 #include "qtcurve_plugin.h"
 #include "qtcurve_fonthelper.h"
 #include <qtcurve-utils/qtprops.h>
+#include <qtcurve-utils/shm_cache.h>
 
 #include <qglobal.h>
 #include <QDBusConnection>
@@ -67,7 +68,6 @@
 #include <QSpinBox>
 #include <QDir>
 #include <QSettings>
-#include <QPixmapCache>
 #include <QTextStream>
 #include <QtDebug>
 
@@ -201,6 +201,27 @@ addStripes(QPainter *p, const QPainterPath &path,
     }
 }
 
+// The keys hold every input of the shared pixmaps, the options they depend
+// on and the palette select the segment all the same so that processes with
+// another look do not share anything.
+static uint64_t
+sharedCacheConfig(const Options &opts, const QPalette &pal)
+{
+    const int values[] = {opts.xCheck, opts.crButton, opts.smallRadio,
+                          opts.shadeCheckRadio, opts.crColor,
+                          int(opts.customCheckRadioColor.rgba())};
+    uint64_t res = SharedCache::hash(values, sizeof(values));
+    res = SharedCache::hash(opts.customShades, sizeof(opts.customShades), res);
+    for (int group = 0;group < QPalette::NColorGroups;group++) {
+        for (int role = 0;role < QPalette::NColorRoles;role++) {
+            QRgb rgba = pal.color(QPalette::ColorGroup(group),
+                                  QPalette::ColorRole(role)).rgba();
+            res = SharedCache::hash(&rgba, sizeof(rgba), res);
+        }
+    }
+    return res;
+}
+
 #ifndef QTC_QT5_ENABLE_KDE
 static void
 setRgb(QColor *col, const QStringList &rgb)
@@ -251,53 +272,6 @@ isOnToolbar(const QWidget *widget)
     return false;
 }
 
-/*
-  Cache key:
-  widgettype 2
-  app        5
-  size      15
-  horiz      1
-  alpha      8
-  blue       8
-  green      8
-  red        8
-  type       1  (0 for widget, 1 for pixmap)
-  ------------
-  56
-*/
-enum ECacheType {
-    CACHE_STD,
-    CACHE_PBAR,
-    CACHE_TAB_TOP,
-    CACHE_TAB_BOT
-};
-
-static QtcKey
-createKey(qulonglong size, const QColor &color, bool horiz, int app, EWidget w)
-{
-    ECacheType type=WIDGET_TAB_TOP==w
-        ? CACHE_TAB_TOP
-        : WIDGET_TAB_BOT==w
-        ? CACHE_TAB_BOT
-        : WIDGET_PROGRESSBAR==w
-        ? CACHE_PBAR
-        : CACHE_STD;
-
-    return (color.rgba()<<1)+
-        (((qulonglong)(horiz ? 1 : 0))<<33)+
-        (((qulonglong)(size&0xFFFF))<<34)+
-        (((qulonglong)(app&0x1F))<<50)+
-        (((qulonglong)(type&0x03))<<55);
-}
-
-static QtcKey createKey(const QColor &color, EPixmap p)
-{
-    return 1 +
-        ((color.rgb()&RGB_MASK)<<1)+
-        (((qulonglong)(p&0x1F))<<33)+
-        (((qulonglong)1)<<38);
-}
-
 #ifdef QTC_QT5_ENABLE_KDE
 static void parseWindowLine(const QString &line, QList<int> &data)
 {
@@ -351,6 +325,9 @@ Style::Style() :
     m_activeMdiColors(0L),
     m_mdiColors(0L),
     m_pixmapCache(150000),
+    m_renderCache(10 * 1024 * 1024),
+    m_bevelCache(2 * 1024 * 1024),
+    m_sharedCache(nullptr),
     m_active(true),
     m_sbWidget(0L),
     m_clickedLabel(0L),
@@ -370,8 +347,8 @@ Style::Style() :
 #endif
     if (env && strcmp(env, QTCURVE_PREVIEW_CONFIG) == 0) {
         // To enable preview of QtCurve settings, the style config module will set QTCURVE_PREVIEW_CONFIG
-        // and use CE_QtC_SetOptions to set options. If this is set, we do not use the QPixmapCache as it
-        // will interfere with that of the kcm's widgets!
+        // and use CE_QtC_SetOptions to set options. If this is set, we do not cache pixmaps as the
+        // options can change under the same keys!
         m_isPreview=PREVIEW_MDI;
         m_usePixmapCache=false;
     } else if(env && strcmp(env, QTCURVE_PREVIEW_CONFIG_FULL) == 0) {
@@ -380,6 +357,15 @@ Style::Style() :
         m_usePixmapCache=false;
     } else {
         init(true);
+        if (SharedCache::enabled()) {
+            m_sharedCache = new SharedCache(
+                "qt5-pixmaps",
+                sharedCacheConfig(opts, QApplication::palette()));
+            if (!m_sharedCache->isValid()) {
+                delete m_sharedCache;
+                m_sharedCache = nullptr;
+            }
+        }
     }
 }
 
@@ -774,6 +760,7 @@ Style::~Style()
     freeColors();
     delete m_fntHelper;
     delete m_dBusHelper;
+    delete m_sharedCache;
 }
 
 void Style::freeColor(QSet<QColor *> &freedColors, QColor **cols)
@@ -1371,18 +1358,19 @@ void Style::drawLines(QPainter *p, const QRect &r, bool horiz, int nLines, int o
 void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const QStyleOption *option, bool horiz, EAppearance bevApp,
                                       const QColor *cols) const
 {
-    bool    vertical(!horiz),
-        inCache(true);
+    bool    vertical(!horiz);
     QRect   r(0, 0, horiz ? PROGRESS_CHUNK_WIDTH*2 : origRect.width(),
               horiz ? origRect.height() : PROGRESS_CHUNK_WIDTH*2);
-    QtcKey  key(createKey(horiz ? r.height() : r.width(), cols[ORIGINAL_SHADE], horiz, bevApp, WIDGET_PROGRESSBAR));
-    QPixmap *pix(m_pixmapCache.object(key));
+    PixmapKey key(PixmapKey::KEY_PROGRESS, horiz ? r.height() : r.width(),
+                  cols[ORIGINAL_SHADE], cols[1], horiz, bevApp,
+                  opts.stripedProgress);
+    QPixmap pix;
 
-    if(!pix)
+    if(!m_pixmapCache.find(key, &pix))
     {
-        pix=new QPixmap(r.width(), r.height());
+        pix=QPixmap(r.width(), r.height());
 
-        QPainter pixPainter(pix);
+        QPainter pixPainter(&pix);
 
         if(qtcIsFlat(bevApp))
             pixPainter.fillRect(r, cols[ORIGINAL_SHADE]);
@@ -1438,12 +1426,7 @@ void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const
         }
 
         pixPainter.end();
-        int cost(pix->width()*pix->height()*(pix->depth()/8));
-
-        if(cost<m_pixmapCache.maxCost())
-            m_pixmapCache.insert(key, pix, cost);
-        else
-            inCache=false;
+        m_pixmapCache.insert(key, pix);
     }
     QRect fillRect(origRect);
 
@@ -1464,16 +1447,12 @@ void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const
 
     p->save();
     p->setClipRect(origRect, Qt::IntersectClip);
-    p->drawTiledPixmap(fillRect, *pix);
+    p->drawTiledPixmap(fillRect, pix);
     if (opts.stripedProgress == STRIPE_FADE && fillRect.width() > 4 &&
         fillRect.height() > 4) {
         addStripes(p, QPainterPath(), fillRect, !vertical);
     }
     p->restore();
-
-    if (!inCache) {
-        delete pix;
-    }
 }
 
 void
@@ -1508,29 +1487,28 @@ Style::drawBevelGradient(const QColor &base, QPainter *p, const QRect &origRect,
         if (w == WIDGET_PROGRESSBAR || !useCache) {
             drawBevelGradientReal(base, p, origRect, path, horiz, sel, app, w);
         } else {
-            QRect r(0, 0, horiz ? PIXMAP_DIMENSION : origRect.width(),
-                    horiz ? origRect.height() : PIXMAP_DIMENSION);
-            QtcKey key(createKey(horiz ? r.height() : r.width(),
-                                 base, horiz, app, w));
-            QPixmap *pix(m_pixmapCache.object(key));
-            bool inCache(true);
-
-            if (!pix) {
-                pix = new QPixmap(r.width(), r.height());
-                pix->fill(Qt::transparent);
-
-                QPainter pixPainter(pix);
+            // The gradient only changes along one axis, so a one pixel thick
+            // strip is enough and is tiled over the rect.
+            QRect r(0, 0, horiz ? 1 : origRect.width(),
+                    horiz ? origRect.height() : 1);
+            // drawBevelGradientReal() also depends on the layout direction
+            // and, for blended titlebars, on the window background.
+            PixmapKey key(PixmapKey::KEY_GRADIENT,
+                          horiz ? r.height() : r.width(), base, horiz, sel,
+                          app, w, QApplication::layoutDirection(),
+                          m_backgroundCols[ORIGINAL_SHADE]);
+            QPixmap pix;
 
-                drawBevelGradientReal(base, &pixPainter, r, horiz, sel, app, w);
-                pixPainter.end();
+            if (!m_pixmapCache.find(key, &pix)) {
+                QImage img(r.size(), QImage::Format_ARGB32_Premultiplied);
+                img.fill(Qt::transparent);
 
-                int cost(pix->width()*pix->height()*(pix->depth()/8));
+                QPainter imgPainter(&img);
 
-                if (cost < m_pixmapCache.maxCost()) {
-                    m_pixmapCache.insert(key, pix, cost);
-                } else {
-                    inCache = false;
-                }
+                drawBevelGradientReal(base, &imgPainter, r, horiz, sel, app, w);
+                imgPainter.end();
+                pix = QPixmap::fromImage(img);
+                m_pixmapCache.insert(key, pix);
             }
 
             if(!path.isEmpty())
@@ -1539,11 +1517,9 @@ Style::drawBevelGradient(const QColor &base, QPainter *p, const QRect &origRect,
                 p->setClipPath(path, Qt::IntersectClip);
             }
 
-            p->drawTiledPixmap(origRect, *pix);
+            p->drawTiledPixmap(origRect, pix);
             if(!path.isEmpty())
                 p->restore();
-            if(!inCache)
-                delete pix;
         }
     }
 }
@@ -1690,18 +1666,22 @@ Style::drawLightBevel(QPainter *p, const QRect &r, const QStyleOption *option,
         } else {
             bool small(circular || (horiz ? r.width() : r.height())<(2*endSize));
             QPixmap pix;
+            TileSet tiles;
             const QSize pixSize(small ? QSize(r.width(), r.height()) :
                                 QSize(horiz ? size : r.width(),
                                       horiz ? r.height() : size));
             uint state(option->state&(State_Raised|State_Sunken|State_On|State_Horizontal|State_HasFocus|State_MouseOver|
                                          (WIDGET_MDI_WINDOW_BUTTON==w ? State_Active : State_None)));
 
-            QString key = QStringLiteral("qtc-%1-%2-%3-%4-%5-%6-%7-%8-%9")
-                .arg(w, 0, 16).arg(onToolbar ? 1 : 0, 0, 16).arg(round, 0, 16)
-                .arg((int)realRound, 0, 16).arg(pixSize.width(), 0, 16)
-                .arg(pixSize.height(), 0, 16)
-                .arg(state, 0, 16).arg(fill.rgba(), 0, 16).arg((int)(radius * 100), 0, 16);
-            if (!m_usePixmapCache || !QPixmapCache::find(key, &pix)) {
+            PixmapKey key(PixmapKey::KEY_BEVEL, w, onToolbar, round, realRound,
+                          pixSize.width(), pixSize.height(), state, fill,
+                          radius);
+            // Small and circular bevels are cached as a whole, the others
+            // are cut once into a three slice TileSet that fills any length.
+            bool cached = (m_usePixmapCache &&
+                           (small ? m_renderCache.find(key, &pix) :
+                            m_bevelCache.find(key, &tiles)));
+            if (!cached) {
                 pix = QPixmap(pixSize);
                 pix.fill(Qt::transparent);
 
@@ -1716,32 +1696,27 @@ Style::drawLightBevel(QPainter *p, const QRect &r, const QStyleOption *option,
                 opts.round = oldRound;
                 pixPainter.end();
 
+                if (!small) {
+                    tiles = (horiz ?
+                             TileSet(pix, endSize, 0, endSize, 0,
+                                     endSize, 0, middleSize, pix.height()) :
+                             TileSet(pix, 0, endSize, 0, endSize,
+                                     0, endSize, pix.width(), middleSize));
+                }
                 if (m_usePixmapCache) {
-                    QPixmapCache::insert(key, pix);
+                    if (small) {
+                        m_renderCache.insert(key, pix);
+                    } else {
+                        m_bevelCache.insert(key, tiles);
+                    }
                 }
             }
 
             if (small) {
                 p->drawPixmap(r.topLeft(), pix);
-            } else if (horiz) {
-                int middle(qMin(r.width()-(2*endSize), middleSize));
-                if(middle>0)
-                    p->drawTiledPixmap(r.x()+endSize, r.y(), r.width()-(2*endSize), pix.height(), pix.copy(endSize, 0, middle, pix.height()));
-                p->drawPixmap(r.x(), r.y(), pix.copy(0, 0, endSize, pix.height()));
-                p->drawPixmap(r.x()+r.width()-endSize, r.y(), pix.copy(pix.width()-endSize, 0, endSize, pix.height()));
             } else {
-                int middle(qMin(r.height()-(2*endSize), middleSize));
-                if (middle > 0) {
-                    p->drawTiledPixmap(r.x(), r.y() + endSize, pix.width(),
-                                       r.height() - 2 * endSize,
-                                       pix.copy(0, endSize,
-                                                pix.width(), middle));
-                }
-                p->drawPixmap(r.x(), r.y(),
-                              pix.copy(0, 0, pix.width(), endSize));
-                p->drawPixmap(r.x(), r.y() + r.height() - endSize,
-                              pix.copy(0, pix.height() - endSize, pix.width(),
-                                       endSize));
+                tiles.render(r, p, horiz ? TileSet::Horizontal :
+                             TileSet::Vertical);
             }
 
             if (w == WIDGET_SB_SLIDER && opts.stripedSbar) {
@@ -2122,8 +2097,8 @@ QPixmap Style::drawStripes(const QColor &color, int opacity) const
     if(100!=opacity)
         col.setAlphaF(opacity/100.0);
 
-    QString key = QStringLiteral("qtc-stripes-%1").arg(col.rgba(), 0, 16);
-    if(!m_usePixmapCache || !QPixmapCache::find(key, &pix))
+    PixmapKey key(PixmapKey::KEY_STRIPES, col);
+    if(!m_usePixmapCache || !m_renderCache.find(key, &pix))
     {
         pix=QPixmap(QSize(64, 64));
 
@@ -2157,7 +2132,7 @@ QPixmap Style::drawStripes(const QColor &color, int opacity) const
             pixPainter.drawLine(0, i, pix.width()-1, i);
 
         if(m_usePixmapCache)
-            QPixmapCache::insert(key, pix);
+            m_renderCache.insert(key, pix);
     }
 
     return pix;
@@ -2191,9 +2166,8 @@ Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r,
             if (opacity != 100)
                 col.setAlphaF(opacity / 100.0);
 
-            QString key = QStringLiteral("qtc-bgnd-%1-%2-%3")
-                .arg(col.rgba(), 0, 16).arg(grad).arg(app);
-            if (!m_usePixmapCache || !QPixmapCache::find(key, &pix)) {
+            PixmapKey key(PixmapKey::KEY_BACKGROUND, col, grad, app);
+            if (!m_usePixmapCache || !m_renderCache.find(key, &pix)) {
                 pix = QPixmap(QSize(grad == GT_HORIZ ? constPixmapWidth :
                                     constPixmapHeight, grad == GT_HORIZ ?
                                     constPixmapHeight : constPixmapWidth));
@@ -2206,7 +2180,7 @@ Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r,
                                       WIDGET_OTHER);
                 pixPainter.end();
                 if (m_usePixmapCache) {
-                    QPixmapCache::insert(key, pix);
+                    m_renderCache.insert(key, pix);
                 }
             }
         }
@@ -2231,8 +2205,9 @@ Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r,
             grad == GT_HORIZ &&
             qtcGetGradient(app, &opts)->border == GB_SHINE) {
             int size = qMin(BGND_SHINE_SIZE, qMin(r.height() * 2, r.width()));
-            QString key = QStringLiteral("qtc-radial-%1").arg(size / BGND_SHINE_STEPS, 0, 16);
-            if (!m_usePixmapCache || !QPixmapCache::find(key, &pix)) {
+            // The alpha of the shine depends on the background color.
+            PixmapKey key(PixmapKey::KEY_SHINE, size / BGND_SHINE_STEPS, col);
+            if (!m_usePixmapCache || !m_renderCache.find(key, &pix)) {
                 size /= BGND_SHINE_STEPS;
                 size *= BGND_SHINE_STEPS;
                 pix = QPixmap(size, size / 2);
@@ -2256,7 +2231,7 @@ Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r,
                                     gradient);
                 pixPainter.end();
                 if (m_usePixmapCache) {
-                    QPixmapCache::insert(key, pix);
+                    m_renderCache.insert(key, pix);
                 }
             }
             p->drawPixmap(r.x() + ((r.width() - pix.width()) / 2), r.y(), pix);
@@ -3197,7 +3172,7 @@ void Style::drawSbSliderHandle(QPainter *p, const QRect &rOrig, const QStyleOpti
         switch(opts.sliderThumbs)
         {
         case LINE_1DOT:
-            p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), *getPixmap(markers[QTC_STD_BORDER], PIX_DOT, 1.0));
+            p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), getPixmap(markers[QTC_STD_BORDER], PIX_DOT, 1.0));
             break;
         case LINE_FLAT:
             drawLines(p, r, !horiz, 3, 5, markers, 0, 5, opts.sliderThumbs);
@@ -3591,7 +3566,7 @@ void Style::drawHandleMarkers(QPainter *p, const QRect &rx, const QStyleOption *
     case LINE_NONE:
         break;
     case LINE_1DOT:
-        p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), *getPixmap(border[QTC_STD_BORDER], PIX_DOT, 1.0));
+        p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), getPixmap(border[QTC_STD_BORDER], PIX_DOT, 1.0));
         break;
     case LINE_DOTS:
         drawDots(p, r, !(option->state&State_Horizontal), 2, tb ? 5 : 3, border, tb ? -2 : 0, 5);
@@ -4053,18 +4028,28 @@ const QColor & Style::getFill(const QStyleOption *option, const QColor *use, boo
         : use[darker ? 2 : ORIGINAL_SHADE];
 }
 
-QPixmap * Style::getPixmap(const QColor col, EPixmap p, double shade) const
+QPixmap Style::getPixmap(const QColor col, EPixmap p, double shade) const
 {
-    QtcKey  key(createKey(col, p));
-    QPixmap *pix=m_pixmapCache.object(key);
+    PixmapKey key(PixmapKey::KEY_PIXMAP, col, p, shade, opts.xCheck);
+    QPixmap pix;
 
-    if (!pix) {
-        if (p == PIX_DOT) {
-            pix=new QPixmap(5, 5);
-            pix->fill(Qt::transparent);
+    if (!m_pixmapCache.find(key, &pix)) {
+        // The key holds every input so it is also valid in other processes.
+        SharedCache::Image shared;
+        bool inShared = (m_sharedCache &&
+                         m_sharedCache->find(key.data(), key.dataSize(),
+                                             &shared));
+        if (inShared) {
+            // Wrap the shared memory, fromImage() makes the only copy.
+            pix = QPixmap::fromImage(QImage(shared.data, shared.width,
+                                            shared.height, shared.stride,
+                                            QImage::Format_ARGB32_Premultiplied));
+        } else if (p == PIX_DOT) {
+            pix=QPixmap(5, 5);
+            pix.fill(Qt::transparent);
 
             QColor          c(col);
-            QPainter        p(pix);
+            QPainter        p(&pix);
             QLinearGradient g1(0, 0, 5, 5),
                 g2(0, 0, 3, 3);
 
@@ -4086,8 +4071,6 @@ QPixmap * Style::getPixmap(const QColor col, EPixmap p, double shade) const
         }
         else
         {
-            pix=new QPixmap();
-
             QImage img;
 
             switch(p)
@@ -4109,14 +4092,31 @@ QPixmap * Style::getPixmap(const QColor col, EPixmap p, double shade) const
             qtcAdjustPix(img.bits(), 4, img.width(), img.height(),
                          img.bytesPerLine(), col.red(), col.green(),
                          col.blue(), shade, QTC_PIXEL_QT);
-            *pix=QPixmap::fromImage(img);
+            pix=QPixmap::fromImage(img);
         }
-        m_pixmapCache.insert(key, pix, pix->depth()/8);
+        if (m_sharedCache && !inShared) {
+            QImage img(pix.toImage().convertToFormat(
+                           QImage::Format_ARGB32_Premultiplied));
+            m_sharedCache->insert(key.data(), key.dataSize(),
+                                  {img.constBits(), img.width(),
+                                   img.height(), img.bytesPerLine()});
+        }
+        m_pixmapCache.insert(key, pix);
     }
 
     return pix;
 }
 
+QVariantMap
+Style::cacheStatistics() const
+{
+    QVariantMap stats;
+    m_pixmapCache.addStatistics(stats, QStringLiteral("pixmapCache"));
+    m_renderCache.addStatistics(stats, QStringLiteral("renderCache"));
+    m_bevelCache.addStatistics(stats, QStringLiteral("bevelCache"));
+    return stats;
+}
+
 const QColor & Style::getTabFill(bool current, bool highlight, const QColor *use) const
 {
     return (current ? use[ORIGINAL_SHADE] : highlight ?
@@ -28,7 +28,6 @@
 #include <QMap>
 #include <QList>
 #include <QSet>
-#include <QCache>
 #include <QColor>
 #include <QFont>
 #include <QPainter>
@@ -36,6 +35,7 @@
 #include <QStyleOption>
 #include <QtGlobal>
 #include <QCommonStyle>
+#include <QVariantMap>
 #ifdef QTC_QT5_ENABLE_KDE
 #include <KConfigCore/KSharedConfig>
 #include <KConfigCore/KConfigGroup>
@@ -45,8 +45,9 @@ using ParentStyleClass = KStyle;
 using ParentStyleClass = QCommonStyle;
 #endif
 
-typedef qulonglong QtcKey;
 #include <common/common.h>
+#include "pixmapcache.h"
+#include "tileset.h"
 
 class QStyleOptionSlider;
 class QLabel;
@@ -65,6 +66,7 @@ class BlurHelper;
 class ShortcutHandler;
 class ShadowHelper;
 class StylePlugin;
+class SharedCache;
 
 class Style: public ParentStyleClass {
     Q_OBJECT
@@ -183,6 +185,8 @@ public:
     {
         prePolish(const_cast<QWidget*>(w));
     }
+    // Hit/miss counters of the pixmap caches, used by qtcurve-bench.
+    Q_INVOKABLE QVariantMap cacheStatistics() const;
 
 private:
     void init(bool initial);
@@ -353,7 +357,7 @@ private:
     const QColor &getTabFill(bool current, bool highlight,
                              const QColor *use) const;
     QColor menuStripeCol() const;
-    QPixmap *getPixmap(const QColor col, EPixmap p, double shade=1.0) const;
+    QPixmap getPixmap(const QColor col, EPixmap p, double shade=1.0) const;
     const QColor &checkRadioCol(const QStyleOption *opt) const;
     QColor shade(const QColor &a, double k) const;
     void shade(const QColor &ca, QColor *cb, double k) const;
@@ -529,7 +533,6 @@ private:
     DBusHelper *m_dBusHelper;
     class FontHelper;
     FontHelper *m_fntHelper;
-
     mutable Options opts;
     QColor m_highlightCols[TOTAL_SHADES + 1],
         m_backgroundCols[TOTAL_SHADES + 1],
@@ -559,7 +562,11 @@ private:
     mutable QColor m_coloredButtonCols[TOTAL_SHADES + 1];
     mutable QColor m_coloredBackgroundCols[TOTAL_SHADES + 1];
     mutable QColor m_coloredHighlightCols[TOTAL_SHADES + 1];
-    mutable QCache<QtcKey, QPixmap> m_pixmapCache;
+    mutable PixmapCache m_pixmapCache;
+    mutable PixmapCache m_renderCache;
+    mutable RenderCache<TileSet> m_bevelCache;
+    // Only set when QTCURVE_SHARED_CACHE is enabled.
+    SharedCache *m_sharedCache;
     mutable bool m_active;
     mutable const QWidget *m_sbWidget;
     mutable QLabel *m_clickedLabel;
@@ -62,7 +62,6 @@
 #include <QLineEdit>
 #include <QDir>
 #include <QSettings>
-#include <QPixmapCache>
 #include <QTextStream>
 #include <QFileDialog>
 #include <QToolBox>
@@ -292,9 +291,7 @@ void Style::polish(QPalette &palette)
             oneOf(opts.menuBgndImage.type, IMG_PLAIN_RINGS,
                   IMG_BORDERED_RINGS, IMG_SQUARE_RINGS)) {
             qtcCalcRingAlphas(&m_backgroundCols[ORIGINAL_SHADE]);
-            if (m_usePixmapCache) {
-                QPixmapCache::clear();
-            }
+            m_renderCache.clear();
         }
     }
 
@@ -2378,8 +2375,8 @@ Style::drawControl(ControlElement element, const QStyleOption *option,
         case LINE_1DOT:
             painter->drawPixmap(r.x() + ((r.width() - 5) / 2),
                                 r.y() + ((r.height() - 5) / 2),
-                                *getPixmap(border[QTC_STD_BORDER],
-                                           PIX_DOT, 1.0));
+                                getPixmap(border[QTC_STD_BORDER],
+                                          PIX_DOT, 1.0));
             break;
         default:
         case LINE_DOTS:
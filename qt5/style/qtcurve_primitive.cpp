@@ -29,7 +29,6 @@
 #include <QComboBox>
 #include <QMainWindow>
 #include <QListView>
-#include <QPixmapCache>
 #include <QDockWidget>
 #include <QGroupBox>
 #include <QDial>
@@ -850,10 +849,8 @@ Style::drawPrimitivePanelItemViewItem(PrimitiveElement,
                               opts.selectionAppearance, WIDGET_SELECTION);
         } else {
             QPixmap pix;
-            QString key = QStringLiteral("qtc-sel-%1-%2")
-                .arg(r.height(), 0, 16)
-                .arg(color.rgba(), 0, 16);
-            if (!m_usePixmapCache || !QPixmapCache::find(key, &pix)) {
+            PixmapKey key(PixmapKey::KEY_SELECTION, r.height(), color);
+            if (!m_usePixmapCache || !m_renderCache.find(key, &pix)) {
                 pix = QPixmap(QSize(24, r.height()));
                 pix.fill(Qt::transparent);
                 QPainter pixPainter(&pix);
@@ -874,7 +871,7 @@ Style::drawPrimitivePanelItemViewItem(PrimitiveElement,
                 }
                 pixPainter.end();
                 if (m_usePixmapCache) {
-                    QPixmapCache::insert(key, pix);
+                    m_renderCache.insert(key, pix);
                 }
             }
             bool roundedLeft = false;
@@ -1803,10 +1800,10 @@ Style::drawPrimitiveIndicatorCheckBox(PrimitiveElement element,
                              opts.menuTick, QPalette::Text);
             painter->restore();
         } else {
-            QPixmap *pix = getPixmap(checkRadioCol(option), PIX_CHECK, 1.0);
+            QPixmap pix = getPixmap(checkRadioCol(option), PIX_CHECK, 1.0);
 
-            painter->drawPixmap(rect.center().x() - pix->width() / 2,
-                                rect.center().y() - pix->height() / 2, *pix);
+            painter->drawPixmap(rect.center().x() - pix.width() / 2,
+                                rect.center().y() - pix.height() / 2, pix);
         }
     } else if (state & State_NoChange) {
         // tri-state
@@ -220,21 +220,9 @@ updateMenuBarEvent(QMouseEvent *event, QMenuBar *menu)
 QRegion
 windowMask(const QRect &r, bool full)
 {
-    int x, y, w, h;
-    r.getRect(&x, &y, &w, &h);
-
-    if (full) {
-        QRegion region(x + 4, y + 0, w-4*2, h-0*2);
-        region += QRegion(x + 0, y + 4, w-0*2, h-4*2);
-        region += QRegion(x + 2, y + 1, w-2*2, h-1*2);
-        region += QRegion(x + 1, y + 2, w-1*2, h-2*2);
-        return region;
-    } else {
-        QRegion region(x+1, y+1, w-2, h-2);
-        region += QRegion(x, y+2, w, h-4);
-        region += QRegion(x+2, y, w-4, h);
-        return region;
-    }
+    static const RoundedMask fullMask({4, 2, 1, 1});
+    static const RoundedMask slightMask({2, 1});
+    return qtcMaskRegion(full ? fullMask : slightMask, r);
 }
 
 const QWidget*
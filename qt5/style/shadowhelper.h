@@ -50,19 +50,20 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include <QObject>
+#include <QAbstractNativeEventFilter>
 
 namespace QtCurve {
 //! handle shadow pixmaps passed to window manager via X property
-class ShadowHelper: public QObject {
+class ShadowHelper: public QObject, public QAbstractNativeEventFilter {
     Q_OBJECT
 public:
     //!@name property names
     static const char *const netWMForceShadowPropertyName;
     static const char *const netWMSkipShadowPropertyName;
     //! constructor
-    ShadowHelper(QObject *parent): QObject(parent)
-    {
-    }
+    ShadowHelper(QObject *parent);
+    //! destructor
+    ~ShadowHelper() override;
 
     //! register widget
     bool registerWidget(QWidget*, bool force=false);
@@ -73,6 +74,10 @@ public:
     //! event filter
     bool eventFilter(QObject*, QEvent*) override;
 
+    //! X event filter, shared shadow pixmaps can go away with their owner
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           long*) override;
+
 protected:
     //! accept widget
     bool acceptWidget(QWidget*) const;
@@ -0,0 +1,279 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include "tileset.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QVarLengthArray>
+
+namespace QtCurve {
+
+TileSet::TileSet()
+    : m_x{0, 0, 0, 0},
+      m_y{0, 0, 0, 0},
+      m_uniformX(0),
+      m_uniformY(0)
+{
+}
+
+TileSet::TileSet(const QPixmap &pix, int w1, int h1, int w2, int h2)
+    : TileSet(pix, w1, h1, pix.width() - (w1 + w2), pix.height() - (h1 + h2),
+              w1, h1, w2, h2)
+{
+}
+
+TileSet::TileSet(const QPixmap &pix, int w1, int h1, int w3, int h3,
+                 int x1, int y1, int w2, int h2)
+    : TileSet()
+{
+    if (pix.isNull()) {
+        return;
+    }
+
+    QImage src(pix.toImage()
+               .convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    int x2 = pix.width() - w3;
+    int y2 = pix.height() - h3;
+    const QRect regions[9] = {
+        QRect(0, 0, w1, h1), QRect(x1, 0, w2, h1), QRect(x2, 0, w3, h1),
+        QRect(0, y1, w1, h2), QRect(x1, y1, w2, h2), QRect(x2, y1, w3, h2),
+        QRect(0, y2, w1, h3), QRect(x1, y2, w2, h3), QRect(x2, y2, w3, h3)
+    };
+    for (int s = 0;s < 9;s++) {
+        checkUniform(src, s, regions[s]);
+    }
+
+    // Middle chunks that have to be repeated are made at least constMinRun
+    // pixels long so that filling a large rect only takes a few fragments.
+    // A middle chunk that spans the whole pixmap is never tiled in that
+    // direction, leave it alone.
+    int w = w2;
+    if ((m_uniformX & 0x92) != 0x92) {
+        while (w < constMinRun && w2 > 0 && w2 < pix.width()) {
+            w += w2;
+        }
+    }
+    int h = h2;
+    if ((m_uniformY & 0x38) != 0x38) {
+        while (h < constMinRun && h2 > 0 && h2 < pix.height()) {
+            h += h2;
+        }
+    }
+    m_x[1] = w1;
+    m_x[2] = w1 + w;
+    m_x[3] = w1 + w + w3;
+    m_y[1] = h1;
+    m_y[2] = h1 + h;
+    m_y[3] = h1 + h + h3;
+    if (m_x[3] <= 0 || m_y[3] <= 0) {
+        return;
+    }
+
+    QImage atlas(m_x[3], m_y[3], QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+    for (int s = 0;s < 9;s++) {
+        copyChunk(atlas, s, src, regions[s]);
+    }
+    m_atlas = QPixmap::fromImage(atlas);
+}
+
+void
+TileSet::checkUniform(const QImage &src, int s, const QRect &region)
+{
+    const QRect rect(region & src.rect());
+    bool uniformX = true;
+    bool uniformY = true;
+    const QRgb *first = nullptr;
+    for (int y = rect.top();y <= rect.bottom();y++) {
+        const QRgb *line = (const QRgb*)src.constScanLine(y);
+        if (!first) {
+            first = line;
+        }
+        for (int x = rect.left();x <= rect.right();x++) {
+            uniformX = uniformX && line[x] == line[rect.left()];
+            uniformY = uniformY && line[x] == first[x];
+        }
+        if (!uniformX && !uniformY) {
+            break;
+        }
+    }
+    if (uniformX) {
+        m_uniformX |= 1 << s;
+    }
+    if (uniformY) {
+        m_uniformY |= 1 << s;
+    }
+}
+
+void
+TileSet::copyChunk(QImage &atlas, int s, const QImage &src,
+                   const QRect &region)
+{
+    const QRect rect(region & src.rect());
+    const QRect cell(QPoint(m_x[s % 3], m_y[s / 3]),
+                     QPoint(m_x[s % 3 + 1] - 1, m_y[s / 3 + 1] - 1));
+    if (rect.isEmpty() || cell.isEmpty()) {
+        return;
+    }
+    for (int y = 0;y < cell.height();y++) {
+        const QRgb *line = ((const QRgb*)
+                            src.constScanLine(rect.y() + y % rect.height()) +
+                            rect.x());
+        QRgb *dest = (QRgb*)atlas.scanLine(cell.y() + y) + cell.x();
+        for (int x = 0;x < cell.width();x++) {
+            dest[x] = line[x % rect.width()];
+        }
+    }
+}
+
+int
+TileSet::cost() const
+{
+    return m_atlas.width() * m_atlas.height() * (m_atlas.depth() / 8);
+}
+
+static inline bool
+bits(TileSet::Tiles flags, TileSet::Tiles testFlags)
+{
+    return (flags & testFlags) == testFlags;
+}
+
+typedef QVarLengthArray<QPainter::PixmapFragment, 32> TileFragments;
+
+// Part of a chunk along one axis and where it goes, a stretched span maps a
+// single source pixel to the whole target length.
+struct TileSpan {
+    int src;
+    int srcLen;
+    int dest;
+    int destLen;
+};
+typedef QVarLengthArray<TileSpan, 8> TileSpans;
+
+static void
+addSpans(TileSpans &spans, bool stretch, int size, int offset, int dest,
+         int length)
+{
+    if (stretch) {
+        spans.append(TileSpan{offset, 1, dest, length});
+        return;
+    }
+    for (int pos = 0, src = offset % size;pos < length;src = 0) {
+        int len = qMin(size - src, length - pos);
+        spans.append(TileSpan{src, len, dest + pos, len});
+        pos += len;
+    }
+}
+
+void
+TileSet::render(const QRect &r, QPainter *p, Tiles t) const
+{
+    if (isNull()) {
+        return;
+    }
+
+    const int w1 = m_x[1];
+    const int w3 = m_x[3] - m_x[2];
+    const int h1 = m_y[1];
+    const int h3 = m_y[3] - m_y[2];
+    int x0, y0, w, h;
+    r.getRect(&x0, &y0, &w, &h);
+
+    // Shrink the outer chunks proportionally when the rect is too small.
+    qreal wRatio(w1 + w3 ? qreal(w1) / qreal(w1 + w3) : 0.5);
+    int wLeft = (t & Right) ? qMin(w1, int(w * wRatio)) : w1;
+    int wRight = (t & Left) ? qMin(w3, int(w * (1.0 - wRatio))) : w3;
+    qreal hRatio(h1 + h3 ? qreal(h1) / qreal(h1 + h3) : 0.5);
+    int hTop = (t & Bottom) ? qMin(h1, int(h * hRatio)) : h1;
+    int hBottom = (t & Top) ? qMin(h3, int(h * (1.0 - hRatio))) : h3;
+
+    w -= wLeft + wRight;
+    h -= hTop + hBottom;
+    int x1 = x0 + wLeft;
+    int x2 = x1 + w;
+    int y1 = y0 + hTop;
+    int y2 = y1 + h;
+
+    TileFragments frags;
+    // Fill dest with chunk s starting at (ox, oy) in the chunk.
+    auto add = [&] (int s, const QRect &dest, int ox, int oy) {
+        const int cx = m_x[s % 3];
+        const int cy = m_y[s / 3];
+        if (dest.isEmpty() || m_x[s % 3 + 1] == cx || m_y[s / 3 + 1] == cy) {
+            return;
+        }
+        TileSpans cols;
+        TileSpans rows;
+        addSpans(cols, m_uniformX & (1 << s), m_x[s % 3 + 1] - cx, ox,
+                 dest.x(), dest.width());
+        addSpans(rows, m_uniformY & (1 << s), m_y[s / 3 + 1] - cy, oy,
+                 dest.y(), dest.height());
+        for (const TileSpan &row: rows) {
+            for (const TileSpan &col: cols) {
+                frags.append(QPainter::PixmapFragment::create(
+                                 QPointF(col.dest + col.destLen / 2.0,
+                                         row.dest + row.destLen / 2.0),
+                                 QRectF(cx + col.src, cy + row.src,
+                                        col.srcLen, row.srcLen),
+                                 qreal(col.destLen) / col.srcLen,
+                                 qreal(row.destLen) / row.srcLen));
+            }
+        }
+    };
+
+    if (bits(t, Top | Left))
+        add(0, QRect(x0, y0, wLeft, hTop), 0, 0);
+    if (bits(t, Top | Right))
+        add(2, QRect(x2, y0, wRight, hTop), w3 - wRight, 0);
+    if (bits(t, Bottom | Left))
+        add(6, QRect(x0, y2, wLeft, hBottom), 0, h3 - hBottom);
+    if (bits(t, Bottom | Right))
+        add(8, QRect(x2, y2, wRight, hBottom), w3 - wRight, h3 - hBottom);
+
+    if (w > 0) {
+        if (t & Top)
+            add(1, QRect(x1, y0, w, hTop), 0, 0);
+        if (t & Bottom)
+            add(7, QRect(x1, y2, w, hBottom), 0, h3 - hBottom);
+    }
+    if (h > 0) {
+        if (t & Left)
+            add(3, QRect(x0, y1, wLeft, h), 0, 0);
+        if (t & Right)
+            add(5, QRect(x2, y1, wRight, h), w3 - wRight, 0);
+    }
+    if ((t & Center) && h > 0 && w > 0) {
+        add(4, QRect(x1, y1, w, h), 0, 0);
+    }
+    if (frags.isEmpty()) {
+        return;
+    }
+
+    // Stretched spans repeat a single pixel, sampling it without filtering
+    // keeps them exact and never reads the neighbouring chunks of the atlas.
+    bool smooth = p->testRenderHint(QPainter::SmoothPixmapTransform);
+    p->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    p->drawPixmapFragments(frags.constData(), frags.size(), m_atlas);
+    p->setRenderHint(QPainter::SmoothPixmapTransform, smooth);
+}
+
+}
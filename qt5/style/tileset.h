@@ -0,0 +1,116 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#ifndef __QTCURVE_TILESET_H__
+#define __QTCURVE_TILESET_H__
+
+#include <QPixmap>
+#include <QRect>
+
+class QPainter;
+class QImage;
+
+namespace QtCurve {
+
+/**
+ * Nine slice pixmap shared by the style (bevels) and the KWin decoration
+ * (shadows). The chunks are cut once into a single atlas pixmap and a rect
+ * of any size is filled with one QPainter::drawPixmapFragments() call.
+ * Sides and center that do not change along their tiling direction are
+ * stretched, the others are pre-expanded to at least constMinRun pixels so
+ * that only a few repeats are needed.
+ * A set with no top and bottom (or left and right) chunks is a three slice
+ * set that only stretches along one axis.
+ */
+class TileSet {
+public:
+    enum Tile {
+        Top = 0x1,
+        Left = 0x2,
+        Right = 0x8,
+        Bottom = 0x4,
+        Center = 0x10,
+        Ring = 0x0f,
+        Horizontal = 0x1a,
+        Vertical = 0x15,
+        Full = 0x1f
+    };
+    Q_DECLARE_FLAGS(Tiles, Tile)
+
+    TileSet();
+    /**
+     * @param w1 width of the left chunks
+     * @param h1 height of the top chunks
+     * @param w2 width of the not-left-or-right chunks
+     * @param h2 height of the not-top-or-bottom chunks
+     * The right and bottom chunks take whatever is left of the pixmap.
+     */
+    TileSet(const QPixmap &pix, int w1, int h1, int w2, int h2);
+    /**
+     * @param w1 width of the left chunks
+     * @param h1 height of the top chunks
+     * @param w3 width of the right chunks
+     * @param h3 height of bottom chunks
+     * @param x2 x-coordinate of the not-left-or-right chunks
+     * @param y2 y-coordinate of the not-top-or-bottom chunks
+     * @param w2 width of the not-left-or-right chunks
+     * @param h2 height of the not-top-or-bottom chunks
+     */
+    TileSet(const QPixmap &pix, int w1, int h1, int w3, int h3,
+            int x2, int y2, int w2, int h2);
+
+    bool
+    isNull() const
+    {
+        return m_atlas.isNull();
+    }
+    // Size in bytes of the atlas.
+    int cost() const;
+    void render(const QRect &r, QPainter *p, Tiles t=Ring) const;
+
+private:
+    static const int constMinRun = 32;
+
+    void copyChunk(QImage &atlas, int s, const QImage &src,
+                   const QRect &region);
+    void checkUniform(const QImage &src, int s, const QRect &region);
+
+    QPixmap m_atlas;
+    // Chunk columns and rows in the atlas, left/top, middle, right/bottom.
+    int m_x[4];
+    int m_y[4];
+    // Bit s is set when chunk s is the same all along a row (column) and can
+    // be stretched horizontally (vertically) instead of being repeated.
+    quint16 m_uniformX;
+    quint16 m_uniformY;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TileSet::Tiles)
+
+static inline int
+cacheCost(const TileSet &tiles)
+{
+    return tiles.cost();
+}
+
+}
+
+#endif
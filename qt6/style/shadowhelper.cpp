@@ -49,6 +49,7 @@
 #include "shadowhelper.h"
 #include "utils.h"
 
+#include <QApplication>
 #include <QDockWidget>
 #include <QMenu>
 #include <QPainter>
@@ -64,6 +65,16 @@ const char *const ShadowHelper::netWMForceShadowPropertyName =
 const char *const ShadowHelper::netWMSkipShadowPropertyName =
     "_KDE_NET_WM_SKIP_SHADOW";
 
+ShadowHelper::ShadowHelper(QObject *parent): QObject(parent)
+{
+    qApp->installNativeEventFilter(this);
+}
+
+ShadowHelper::~ShadowHelper()
+{
+    qApp->removeNativeEventFilter(this);
+}
+
 bool
 ShadowHelper::registerWidget(QWidget *widget, bool force)
 {
@@ -99,6 +110,28 @@ ShadowHelper::eventFilter(QObject *object, QEvent *event)
     return false;
 }
 
+bool
+ShadowHelper::nativeEventFilter(const QByteArray &eventType, void *message,
+                                qintptr*)
+{
+    if (eventType != "xcb_generic_event_t") {
+        return false;
+    }
+    auto *event = static_cast<xcb_generic_event_t*>(message);
+    if ((event->response_type & ~0x80) != XCB_DESTROY_NOTIFY) {
+        return false;
+    }
+    auto *notify = reinterpret_cast<xcb_destroy_notify_event_t*>(event);
+    if (qtcX11ShadowOwnerDestroyed(notify->window)) {
+        for (QWidget *widget: QApplication::topLevelWidgets()) {
+            if (QtcQWidgetProps(widget)->shadowRegistered) {
+                installX11Shadows(widget);
+            }
+        }
+    }
+    return false;
+}
+
 bool
 ShadowHelper::acceptWidget(QWidget *widget) const
 {
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include <qtcurve-utils/color.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The original implementation of qtcAdjustPix.
+static void
+adjustPixRef(unsigned char *data, int numChannels, int w, int h, int stride,
+             int ro, int go, int bo, double shade,
+             QtcPixelByteOrder byte_order)
+{
+    int width = w * numChannels;
+    int offset = 0;
+    int r = (int)(ro * shade + 0.5);
+    int g = (int)(go * shade + 0.5);
+    int b = (int)(bo * shade + 0.5);
+
+    for (int row = 0;row < h;row++) {
+        for (int column = 0;column < width;column += numChannels) {
+            unsigned char source = data[offset + column + 1];
+            int new_r = qtcBound(0, r - source, 255);
+            int new_g = qtcBound(0, g - source, 255);
+            int new_b = qtcBound(0, b - source, 255);
+            switch (byte_order) {
+            case QTC_PIXEL_ARGB:
+                data[offset + column + 1] = new_r;
+                data[offset + column + 2] = new_g;
+                data[offset + column + 3] = new_b;
+                break;
+            case QTC_PIXEL_BGRA:
+                data[offset + column] = new_b;
+                data[offset + column + 1] = new_g;
+                data[offset + column + 2] = new_r;
+                break;
+            default:
+            case QTC_PIXEL_RGBA:
+                data[offset + column] = new_r;
+                data[offset + column + 1] = new_g;
+                data[offset + column + 2] = new_b;
+                break;
+            }
+        }
+        offset += stride;
+    }
+}
+
+int
+main()
+{
+    static const QtcPixelByteOrder orders[] = {
+        QTC_PIXEL_ARGB, QTC_PIXEL_BGRA, QTC_PIXEL_RGBA
+    };
+    static const double shades[] = {0, 0.3, 1, 1.2, 2.5};
+    static const int colors[][3] = {
+        {0, 0, 0}, {255, 255, 255}, {255, 0, 128}, {12, 200, 99}
+    };
+    srandom(0);
+    for (int channels = 3;channels <= 4;channels++) {
+        for (int w = 0;w <= 37;w++) {
+            for (int h = 1;h <= 3;h++) {
+                // Padding at the end of the rows must not be touched
+                int stride = w * channels + (w % 3) * 4;
+                size_t size = stride * h + channels;
+                unsigned char *data = (unsigned char*)malloc(size);
+                unsigned char *ref = (unsigned char*)malloc(size);
+                for (auto order: orders) {
+                    for (double shade: shades) {
+                        for (auto &color: colors) {
+                            for (size_t i = 0;i < size;i++) {
+                                data[i] = random() & 0xff;
+                            }
+                            memcpy(ref, data, size);
+                            adjustPixRef(ref, channels, w, h, stride,
+                                         color[0], color[1], color[2],
+                                         shade, order);
+                            qtcAdjustPix(data, channels, w, h, stride,
+                                         color[0], color[1], color[2],
+                                         shade, order);
+                            assert(memcmp(data, ref, size) == 0);
+                        }
+                    }
+                }
+                free(data);
+                free(ref);
+            }
+        }
+    }
+    return 0;
+}
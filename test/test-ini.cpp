@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include <qtcurve-utils/ini.h>
+#include <qtcurve-utils/map.h>
+#include <assert.h>
+#include <stdlib.h>
+
+using namespace QtCurve;
+
+static const char constConfig[] =
+    "# comment\n"
+    "toplevel=1\n"
+    "\n"
+    "[General]\r\n"
+    "  font = Sans,10,-1,5,50,0,0,0,0,0  \r\n"
+    "no equal sign\n"
+    "empty=\n"
+    "[Colors:View][Inactive]\n"
+    "BackgroundNormal=1,2,3\n"
+    "Name[de]=a=b\n"
+    "[broken\n"
+    "last=no newline";
+
+static void
+checkEntry(Ini::Tokenizer &tokenizer, const char *group, const char *key,
+           const char *value)
+{
+    assert(tokenizer.next() == Ini::Token::Entry);
+    assert(tokenizer.group() == group);
+    assert(tokenizer.key() == key);
+    assert(tokenizer.value() == value);
+}
+
+static void
+checkGroup(Ini::Tokenizer &tokenizer, const char *group)
+{
+    assert(tokenizer.next() == Ini::Token::Group);
+    assert(tokenizer.group() == group);
+}
+
+static void
+checkBounds(const StrView &view, const char *data, size_t len)
+{
+    assert(view.str >= data && view.str + view.len <= data + len);
+}
+
+int
+main()
+{
+    Ini::Tokenizer tokenizer(constConfig, sizeof(constConfig) - 1);
+    checkEntry(tokenizer, "", "toplevel", "1");
+    checkGroup(tokenizer, "General");
+    checkEntry(tokenizer, "General", "font", "Sans,10,-1,5,50,0,0,0,0,0");
+    checkEntry(tokenizer, "General", "empty", "");
+    checkGroup(tokenizer, "Colors:View][Inactive");
+    checkEntry(tokenizer, "Colors:View][Inactive", "BackgroundNormal",
+               "1,2,3");
+    checkEntry(tokenizer, "Colors:View][Inactive", "Name[de]", "a=b");
+    checkEntry(tokenizer, "Colors:View][Inactive", "last", "no newline");
+    assert(tokenizer.next() == Ini::Token::End);
+    assert(tokenizer.next() == Ini::Token::End);
+
+    char buff[8];
+    assert(strcmp(tokenizer.value().copy(buff, sizeof(buff)), "no newl") == 0);
+
+    static const StrMap<int, false> map{
+        {"General", 1},
+        {"Colors:View", 2},
+        {"Colors", 3},
+    };
+    assert(map.search("colors:viewXXX", 11, -1) == 2);
+    assert(map.search("colors:viewXXX", 6, -1) == 3);
+    assert(map.search("colors:viewXXX", 7, -1) == -1);
+    assert(map.search("general", 7, -1) == 1);
+    assert(map.search("gen\0ral", 7, -1) == -1);
+    assert(map.search("", 0, -1) == -1);
+
+    // The tokenizer must never read or return anything outside of the
+    // buffer, whatever its content.
+    srandom(0);
+    static const char alphabet[] = "[]=# \t\r\nab";
+    for (int i = 0;i < 10000;i++) {
+        size_t len = random() % 64;
+        char *data = (char*)malloc(len ? len : 1);
+        for (size_t j = 0;j < len;j++) {
+            data[j] = alphabet[random() % (sizeof(alphabet) - 1)];
+        }
+        Ini::Tokenizer fuzz(data, len);
+        int count = 0;
+        for (Ini::Token token;(token = fuzz.next()) != Ini::Token::End;) {
+            checkBounds(fuzz.group(), data, len);
+            if (token == Ini::Token::Entry) {
+                checkBounds(fuzz.key(), data, len);
+                checkBounds(fuzz.value(), data, len);
+            }
+            assert(++count <= int(len));
+        }
+        free(data);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include <qtcurve-utils/mask.h>
+#include <qtcurve-utils/number.h>
+#include <assert.h>
+#include <vector>
+
+using namespace QtCurve;
+
+struct RefRect {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+// Union of (possibly overlapping) rects, the way the masks used to be built.
+static std::vector<bool>
+unionMask(int w, int h, std::initializer_list<RefRect> rects)
+{
+    std::vector<bool> mask(w * h, false);
+    for (const RefRect &r: rects) {
+        for (int y = qtcMax(r.y, 0);y < qtcMin(r.y + r.h, h);y++) {
+            for (int x = qtcMax(r.x, 0);x < qtcMin(r.x + r.w, w);x++) {
+                mask[y * w + x] = true;
+            }
+        }
+    }
+    return mask;
+}
+
+static void
+checkMask(const RoundedMask &mask, int w, int h,
+          const std::vector<bool> &expected)
+{
+    const int x0 = 7;
+    const int y0 = -3;
+    std::vector<RoundedMask::Rect> rects(mask.maxRects());
+    int n = mask.rects(x0, y0, w, h, rects.data());
+    assert(n >= 0 && n <= mask.maxRects());
+    std::vector<bool> res(w * h, false);
+    for (int i = 0;i < n;i++) {
+        const RoundedMask::Rect &r = rects[i];
+        assert(r.width > 0 && r.height > 0);
+        // y-x banded, one rect per band
+        if (i > 0) {
+            assert(r.y >= rects[i - 1].y + rects[i - 1].height);
+        }
+        for (int y = r.y - y0;y < r.y - y0 + r.height;y++) {
+            for (int x = r.x - x0;x < r.x - x0 + r.width;x++) {
+                assert(x >= 0 && x < w && y >= 0 && y < h);
+                assert(!res[y * w + x]);
+                res[y * w + x] = true;
+            }
+        }
+    }
+    assert(res == expected);
+}
+
+int
+main()
+{
+    // Qt and Gtk2 menus and tooltips
+    const RoundedMask full({4, 2, 1, 1});
+    const RoundedMask slight({2, 1});
+    // KWin decoration
+    const RoundedMask kwinSlight({1});
+    const RoundedMask kwinFull({5, 3, 2, 1, 1});
+    const RoundedMask kwinFullSquareBottom({5, 3, 2, 1, 1}, false);
+    const RoundedMask none({});
+
+    for (int w = 10;w < 40;w++) {
+        for (int h = 10;h < 40;h++) {
+            checkMask(full, w, h, unionMask(w, h, {
+                        {4, 0, w - 4 * 2, h}, {0, 4, w, h - 4 * 2},
+                        {2, 1, w - 2 * 2, h - 2}, {1, 2, w - 2, h - 2 * 2}}));
+            checkMask(slight, w, h, unionMask(w, h, {
+                        {1, 1, w - 2, h - 2}, {0, 2, w, h - 4},
+                        {2, 0, w - 4, h}}));
+            checkMask(kwinSlight, w, h, unionMask(w, h, {
+                        {1, 0, w - 2, h}, {0, 1, 1, h - 2},
+                        {w - 1, 1, 1, h - 2}}));
+            checkMask(kwinFull, w, h, unionMask(w, h, {
+                        {5, 0, w - 10, h}, {0, 5, 1, h - 10},
+                        {1, 3, 1, h - 6}, {2, 2, 1, h - 4}, {3, 1, 2, h - 2},
+                        {w - 1, 5, 1, h - 10}, {w - 2, 3, 1, h - 6},
+                        {w - 3, 2, 1, h - 4}, {w - 5, 1, 2, h - 2}}));
+            checkMask(kwinFullSquareBottom, w, h, unionMask(w, h, {
+                        {5, 0, w - 10, h}, {0, 5, 1, h - 5},
+                        {1, 3, 1, h - 3}, {2, 2, 1, h - 2}, {3, 1, 2, h - 1},
+                        {w - 1, 5, 1, h - 5}, {w - 2, 3, 1, h - 3},
+                        {w - 3, 2, 1, h - 2}, {w - 5, 1, 2, h - 1}}));
+            checkMask(none, w, h, unionMask(w, h, {{0, 0, w, h}}));
+        }
+    }
+    // Windows smaller than their corners still get a valid banded mask.
+    for (int w = 0;w < 10;w++) {
+        for (int h = 0;h < 10;h++) {
+            std::vector<bool> expected(w * h, false);
+            for (int y = 0;y < h;y++) {
+                static const int insets[] = {4, 2, 1, 1};
+                int row = qtcMin(y, h - 1 - y);
+                int inset = row < 4 ? insets[row] : 0;
+                for (int x = inset;x < w - inset;x++) {
+                    expected[y * w + x] = true;
+                }
+            }
+            checkMask(full, w, h, expected);
+        }
+    }
+    return 0;
+}
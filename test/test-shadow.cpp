@@ -0,0 +1,145 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include <qtcurve-utils/shadow_p.h>
+#include <assert.h>
+#include <stdlib.h>
+
+// The original per pixel implementation of the shadow tiles.
+static void
+fillPixelRef(uint8_t *pixel, const QtcColor *c1, const QtcColor *c2,
+             double bias, QtcPixelByteOrder order)
+{
+    uint8_t alpha = qtcBound(0, 0xff * bias, 0xff);
+    if (alpha == 0) {
+        memset(pixel, 0, 4);
+        return;
+    }
+    QtcColor color;
+    _qtcColorMix(c2, c1, bias, &color);
+    uint8_t red = qtcBound(0, 0xff * color.red, 0xff) * alpha / 0xff;
+    uint8_t green = qtcBound(0, 0xff * color.green, 0xff) * alpha / 0xff;
+    uint8_t blue = qtcBound(0, 0xff * color.blue, 0xff) * alpha / 0xff;
+    switch (order) {
+    case QTC_PIXEL_ARGB:
+        pixel[0] = alpha;
+        pixel[1] = red;
+        pixel[2] = green;
+        pixel[3] = blue;
+        break;
+    case QTC_PIXEL_BGRA:
+        pixel[0] = blue;
+        pixel[1] = green;
+        pixel[2] = red;
+        pixel[3] = alpha;
+        break;
+    default:
+        pixel[0] = red;
+        pixel[1] = green;
+        pixel[2] = blue;
+        pixel[3] = alpha;
+        break;
+    }
+}
+
+static float
+gradientValueRef(const float *gradient, size_t size, float distance)
+{
+    if (distance < 0 || distance > size - 1) {
+        return 0;
+    }
+    int index = floorf(distance);
+    if (qtcEqual(index, distance)) {
+        return gradient[index];
+    }
+    return (gradient[index] * (index + 1 - distance) +
+            gradient[index + 1] * (distance - index));
+}
+
+static void
+checkAtlas(size_t size, size_t radius, bool square, QtcPixelByteOrder order)
+{
+    const QtcColor c1 = {0.4, 0.4, 0.4};
+    const QtcColor c2 = {0.1, 0.2, 0.3};
+    QtcShadowTile tiles[8];
+    QtCurve::Image *atlas = qtcShadowCreateAtlas(size, &c1, &c2, radius,
+                                                 square, order, tiles);
+    size_t full_size = size + radius;
+    assert(atlas->height == full_size);
+
+    std::vector<float> gradient(full_size);
+    for (size_t i = 0;i < full_size;i++) {
+        gradient[i] = (i < radius ? 0 :
+                       qtcMax(0, expf(-((i - radius) / (size / 6.5))) -
+                              0.0015));
+    }
+    static const int aligns[8][2] = {
+        {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+    };
+    unsigned x_offset = 0;
+    for (int i = 0;i < 8;i++) {
+        int width = aligns[i][0] ? full_size : 1;
+        int height = aligns[i][1] ? full_size : 1;
+        int x0 = aligns[i][0] == -1 ? width - 1 : 0;
+        int y0 = aligns[i][1] == -1 ? height - 1 : 0;
+        assert(tiles[i].x == x_offset && tiles[i].width == unsigned(width) &&
+               tiles[i].height == unsigned(height));
+        x_offset += width;
+        for (int y = 0;y < height;y++) {
+            for (int x = 0;x < width;x++) {
+                int dx = abs(x - x0);
+                int dy = abs(y - y0);
+                float distance = (square ? qtcMax(dx, dy) :
+                                  sqrtf(dx * dx + dy * dy));
+                uint8_t ref[4];
+                fillPixelRef(ref, &c1, &c2,
+                             gradientValueRef(gradient.data(), full_size,
+                                              distance),
+                             order);
+                const uint8_t *pixel =
+                    &atlas->data[(y * atlas->width + tiles[i].x + x) * 4];
+                // The new implementation computes in float instead of double
+                for (int c = 0;c < 4;c++) {
+                    assert(abs(int(pixel[c]) - int(ref[c])) <= 1);
+                }
+            }
+        }
+    }
+    assert(atlas->width == x_offset);
+    delete atlas;
+}
+
+int
+main()
+{
+    static const QtcPixelByteOrder orders[] = {
+        QTC_PIXEL_ARGB, QTC_PIXEL_BGRA, QTC_PIXEL_RGBA
+    };
+    for (auto order: orders) {
+        for (size_t size: {1, 7, 30, 100}) {
+            for (size_t radius: {0, 4}) {
+                checkAtlas(size, radius, false, order);
+                checkAtlas(size, radius, true, order);
+            }
+        }
+    }
+    return 0;
+}
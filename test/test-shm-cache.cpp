@@ -0,0 +1,125 @@
+/*****************************************************************************
+ *   Copyright 2013 - 2015 Yichao Yu <yyc1992@gmail.com>                     *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU Lesser General Public License as          *
+ *   published by the Free Software Foundation; either version 2.1 of the    *
+ *   License, or (at your option) version 3, or any later version accepted   *
+ *   by the membership of KDE e.V. (or its successor approved by the         *
+ *   membership of KDE e.V.), which shall act as a proxy defined in          *
+ *   Section 6 of version 3 of the license.                                  *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ *   Lesser General Public License for more details.                         *
+ *                                                                           *
+ *   You should have received a copy of the GNU Lesser General Public        *
+ *   License along with this library. If not,                                *
+ *   see <http://www.gnu.org/licenses/>.                                     *
+ *****************************************************************************/
+
+#include <qtcurve-utils/shm_cache.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+using namespace QtCurve;
+
+static const char *constName = "test";
+
+static void
+checkImage(const SharedCache::Image &img, const uint32_t *pixels, int size)
+{
+    assert(img.width == size && img.height == size &&
+           img.stride == int(size * sizeof(uint32_t)));
+    assert(memcmp(img.data, pixels, size * size * sizeof(uint32_t)) == 0);
+}
+
+int
+main()
+{
+    uint64_t config = getpid();
+    uint32_t pixels[16 * 16];
+    for (unsigned i = 0;i < 16 * 16;i++) {
+        pixels[i] = i * 0x01020304;
+    }
+    const SharedCache::Image img = {(const uint8_t*)pixels, 16, 16, 64};
+    SharedCache::Image res;
+
+    SharedCache cache(constName, config, 64 * 1024);
+    assert(cache.isValid());
+    assert(!cache.find("check", 5, &res));
+    assert(cache.insert("check", 5, img, &res));
+    assert(res.data != img.data);
+    checkImage(res, pixels, 16);
+    // Keys are compared in full
+    assert(!cache.find("check", 4, &res));
+    assert(!cache.find("chech", 5, &res));
+    assert(cache.find("check", 5, &res));
+    checkImage(res, pixels, 16);
+
+    // A different process sees the entries of the first one and adds its own
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        SharedCache child(constName, config);
+        assert(child.isValid());
+        assert(child.find("check", 5, &res));
+        checkImage(res, pixels, 16);
+        assert(child.insert("dot", 3, img));
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(cache.find("dot", 3, &res));
+    checkImage(res, pixels, 16);
+
+    // Another config gets another segment
+    SharedCache other(constName, config + 1, 64 * 1024);
+    assert(other.isValid());
+    assert(!other.find("check", 5, &res));
+    other.unlink();
+
+#ifdef __linux__
+    // Creating a segment removes the old ones of the same name
+    char stale[64];
+    snprintf(stale, sizeof(stale), "/qtcurve-%u-%s-0123456789abcdef",
+             (unsigned)getuid(), constName);
+    int fd = shm_open(stale, O_RDWR | O_CREAT, 0600);
+    assert(fd != -1);
+    const struct timespec times[2] = {{0, UTIME_OMIT},
+                                      {time(nullptr) - 2 * 24 * 60 * 60, 0}};
+    assert(futimens(fd, times) == 0);
+    close(fd);
+    SharedCache newer(constName, config + 2, 64 * 1024);
+    assert(newer.isValid());
+    newer.unlink();
+    assert(shm_open(stale, O_RDONLY, 0600) == -1 && errno == ENOENT);
+    // but not the ones in use
+    SharedCache again(constName, config);
+    assert(again.find("check", 5, &res));
+#endif
+
+    // Filling the segment fails cleanly and keeps the existing entries
+    char key[16];
+    int n = 0;
+    for (;n < 1000;n++) {
+        snprintf(key, sizeof(key), "key%d", n);
+        if (!cache.insert(key, strlen(key), img)) {
+            break;
+        }
+    }
+    assert(n > 0 && n < 1000);
+    assert(cache.find("key0", 4, &res));
+    checkImage(res, pixels, 16);
+    assert(cache.find("check", 5, &res));
+    cache.unlink();
+    return 0;
+}